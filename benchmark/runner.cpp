@@ -0,0 +1,278 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "clever_algorithm.h"
+
+
+// Runs every recipe in examples/ as its own process over fixed seeds and
+// reports wall time, evaluations per second, time to target, peak memory
+// and the best-so-far curve the recipe traced through trace_progress.
+
+#ifndef CLEVER_EXAMPLES_DIR
+#define CLEVER_EXAMPLES_DIR "."
+#endif
+
+
+using recipe_info = struct recipe_info_t
+{
+	const char* name;
+	bool minimize;
+	// time_to_target is measured against this value
+	double target;
+};
+
+
+// sphere recipes aim at 1e-3, the TSP ones at 5% above the berlin52
+// optimum, the bit string ones at the OneMax optimum; the learners trace
+// their training error, or the exploit accuracy for the classifier system,
+// and the two immune classifiers trace nothing and are only timed
+const std::vector<recipe_info>& recipes()
+{
+	const double sphere = 1e-3;
+	const double berlin52 = 7542.0 * 1.05;
+	static const std::vector<recipe_info> list = {
+		{"random_search", true, sphere},
+		{"adaptive_random_search", true, sphere},
+		{"stochastic_hill_climbing", false, 64},
+		{"iterated_local_search", true, berlin52},
+		{"guided_local_search", true, berlin52},
+		{"variable_neighborhood_search", true, berlin52},
+		{"greedy_randomized_adaptive_search", true, berlin52},
+		{"scatter_search", true, sphere},
+		{"tabu_search", true, berlin52},
+		{"reactive_tabu_search", true, berlin52},
+		{"genetic_algorithm", false, 64},
+		{"evolution_strategies", true, sphere},
+		{"differential_evolution", true, sphere},
+		{"evolutionary_programming", true, sphere},
+		{"simulated_annealing", true, berlin52},
+		{"extremal_optimization", true, berlin52},
+		{"harmony_search", true, sphere},
+		{"cultural_algorithm", true, sphere},
+		{"memetic_algorithm", true, sphere},
+		{"population-based_incremental_learning", false, 64},
+		{"univariate_marginal_distribution_algorithm", false, 64},
+		{"compact_genetic_algorithm", false, 32},
+		{"bayesian_optimization_algorithm", false, 20},
+		{"cross-entropy_method", true, sphere},
+		{"particle_swarm_optimization", true, sphere},
+		{"ant_system", true, berlin52},
+		{"ant_colony_system", true, berlin52},
+		{"bees_algorithm", true, sphere},
+		{"bacterial_foraging_optimization", true, sphere},
+		{"clonal_selection_algorithm", true, sphere},
+		{"negative_selection_algorithm", true, 0.0},
+		{"artificial_immune_recognition_system", true, 0.0},
+		{"learning_classifier_system", false, 0.95},
+		{"back-propagation", true, 0.01},
+		{"perceptron", true, 0.0},
+	};
+	return list;
+}
+
+
+using runner_options = struct runner_options_t
+{
+	std::string bin_dir = CLEVER_EXAMPLES_DIR;
+	std::vector<std::uint64_t> seeds = {1, 2, 3};
+	std::string threads;
+	double timeout = 300.0;
+	std::string csv;
+	std::string curves;
+	std::string json;
+	std::vector<std::string> names;
+};
+
+
+void run_recipe(clever::benchmark_run& run, const recipe_info& recipe, const std::uint64_t seed,
+                const runner_options& options)
+{
+	run = clever::benchmark_run();
+	run.algorithm = recipe.name;
+	run.seed = seed;
+
+	char trace_path[] = "/tmp/clever-trace-XXXXXX";
+	const int trace_fd = mkstemp(trace_path);
+	if (trace_fd < 0)
+	{
+		return;
+	}
+	close(trace_fd);
+
+	const auto path = options.bin_dir + "/" + recipe.name;
+	const auto start = clever::elapsed_seconds();
+	const pid_t pid = fork();
+	if (pid == 0)
+	{
+		setenv("CLEVER_SEED", std::to_string(seed).c_str(), 1);
+		setenv("CLEVER_TRACE", trace_path, 1);
+		if (!options.threads.empty())
+		{
+			setenv("CLEVER_NUM_THREADS", options.threads.c_str(), 1);
+		}
+		const int null_fd = open("/dev/null", O_WRONLY);
+		dup2(null_fd, STDOUT_FILENO);
+		execl(path.c_str(), path.c_str(), static_cast<char*>(nullptr));
+		_exit(127);
+	}
+
+	int status = 0;
+	rusage usage = rusage();
+	bool timed_out = false;
+	while (pid > 0)
+	{
+		if (wait4(pid, &status, WNOHANG, &usage) == pid)
+		{
+			break;
+		}
+		if (clever::elapsed_seconds() - start > options.timeout)
+		{
+			kill(pid, SIGKILL);
+			wait4(pid, &status, 0, &usage);
+			timed_out = true;
+			break;
+		}
+		usleep(1000);
+	}
+	run.seconds = clever::elapsed_seconds() - start;
+	run.completed = pid > 0 && !timed_out && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+	run.peak_memory_kb = static_cast<size_t>(usage.ru_maxrss);
+
+	std::ifstream trace(trace_path);
+	clever::read_trace(trace, run.curve);
+	unlink(trace_path);
+	// the recipes trace their current value, the curve keeps the best so far
+	for (size_t i = 1; i < run.curve.size(); ++i)
+	{
+		auto& best = run.curve[i].best;
+		const auto previous = run.curve[i - 1].best;
+		best = recipe.minimize ? std::min(best, previous) : std::max(best, previous);
+	}
+	if (!run.curve.empty())
+	{
+		run.evaluations = run.curve.back().evaluations;
+		run.best = run.curve.back().best;
+		run.time_to_target = clever::time_to_target(run.curve, recipe.target, recipe.minimize);
+	}
+}
+
+
+bool parse_options(runner_options& options, const int argc, char* argv[])
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		const bool has_value = i + 1 < argc;
+		if (arg == "--bin-dir" && has_value)
+		{
+			options.bin_dir = argv[++i];
+		}
+		else if (arg == "--seeds" && has_value)
+		{
+			options.seeds.clear();
+			std::istringstream list(argv[++i]);
+			std::string seed;
+			while (std::getline(list, seed, ','))
+			{
+				options.seeds.push_back(std::strtoull(seed.c_str(), nullptr, 10));
+			}
+		}
+		else if (arg == "--threads" && has_value)
+		{
+			options.threads = argv[++i];
+		}
+		else if (arg == "--timeout" && has_value)
+		{
+			options.timeout = std::atof(argv[++i]);
+		}
+		else if (arg == "--csv" && has_value)
+		{
+			options.csv = argv[++i];
+		}
+		else if (arg == "--curves" && has_value)
+		{
+			options.curves = argv[++i];
+		}
+		else if (arg == "--json" && has_value)
+		{
+			options.json = argv[++i];
+		}
+		else if (!arg.empty() && arg[0] != '-')
+		{
+			options.names.push_back(arg);
+		}
+		else
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+int main(int argc, char* argv[])
+{
+	runner_options options;
+	if (!parse_options(options, argc, argv))
+	{
+		std::cout << "usage: " << argv[0] << " [--bin-dir DIR] [--seeds 1,2,3] [--threads N] [--timeout SECONDS]"
+			" [--csv FILE] [--curves FILE] [--json FILE] [recipe...]" << std::endl;
+		return 1;
+	}
+
+	std::vector<clever::benchmark_run> runs;
+	for (const auto& recipe : recipes())
+	{
+		if (!options.names.empty()
+			&& std::find(options.names.begin(), options.names.end(), recipe.name) == options.names.end())
+		{
+			continue;
+		}
+		for (const auto seed : options.seeds)
+		{
+			clever::benchmark_run run;
+			run_recipe(run, recipe, seed, options);
+			std::cout << " > " << run.algorithm << ", seed = " << run.seed
+				<< (run.completed ? "" : " (failed)")
+				<< ", time = " << run.seconds << " s"
+				<< ", evals/s = " << clever::evaluations_per_second(run)
+				<< ", best = " << run.best
+				<< ", to target = " << run.time_to_target << " s"
+				<< ", peak = " << run.peak_memory_kb << " kB" << std::endl;
+			runs.push_back(run);
+		}
+	}
+
+	if (!options.csv.empty())
+	{
+		std::ofstream out(options.csv);
+		clever::write_csv(out, runs);
+	}
+	if (!options.curves.empty())
+	{
+		std::ofstream out(options.curves);
+		clever::write_curves_csv(out, runs);
+	}
+	if (!options.json.empty())
+	{
+		std::ofstream out(options.json);
+		clever::write_json(out, runs);
+	}
+
+	const auto failed = std::count_if(runs.begin(), runs.end(),
+	                                  [](const clever::benchmark_run& run) { return !run.completed; });
+	return failed == 0 ? 0 : 1;
+}
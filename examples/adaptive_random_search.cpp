@@ -1,46 +1,11 @@
 #include <iostream>
 #include <numeric>
-#include <random>
 #include <vector>
 
+#include "clever_algorithm.h"
 
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_real_distribution<> distribution(0.0, 1.0);
-auto random_ = []() { return distribution(generator); };
 
-
-using candidate_solution = struct candidate_solution_t
-{
-	std::vector<double> vector;
-	double cost = 0.0;
-};
-
-
-double objective_function(std::vector<double>& vector)
-{
-	return std::inner_product(vector.begin(), vector.end(), vector.begin(), 0.0);
-}
-
-
-double rand_in_bounds(const double min, const double max)
-{
-	return min + (max - min) * random_();
-}
-
-
-void random_vector(std::vector<double>& rand_vec, std::vector<std::vector<double> >& minmax)
-{
-	if (minmax.empty())
-	{
-		return;
-	}
-	rand_vec.resize(minmax.size());
-	for (size_t i = 0; i < minmax.size(); ++i)
-	{
-		rand_vec[i] = rand_in_bounds(minmax[i][0], minmax[i][1]);
-	}
-}
+using candidate_solution = clever::real_solution;
 
 
 void take_step(std::vector<double>& position, std::vector<std::vector<double> >& minmax, std::vector<double>& current,
@@ -51,7 +16,7 @@ void take_step(std::vector<double>& position, std::vector<std::vector<double> >&
 	{
 		const double min = std::max(minmax[i][0], current[i] - step_size);
 		const double max = std::min(minmax[i][1], current[i] + step_size);
-		position[i] = rand_in_bounds(min, max);
+		position[i] = clever::rand_in_bounds(min, max);
 	}
 }
 
@@ -71,9 +36,9 @@ void take_steps(candidate_solution& step, candidate_solution& big_step, std::vec
                 std::vector<double>& current, const double step_size, const double big_step_size)
 {
 	take_step(step.vector, bounds, current, step_size);
-	step.cost = objective_function(step.vector);
+	step.cost = clever::sphere_function(step.vector);
 	take_step(big_step.vector, bounds, current, big_step_size);
-	big_step.cost = objective_function(big_step.vector);
+	big_step.cost = clever::sphere_function(big_step.vector);
 }
 
 
@@ -83,8 +48,8 @@ void search(candidate_solution& current, const size_t max_iter, std::vector<std:
 {
 	double step_size = (bounds[0][1] - bounds[0][0]) * init_factor;
 	size_t count = 0;
-	random_vector(current.vector, bounds);
-	current.cost = objective_function(current.vector);
+	clever::random_vector(current.vector, bounds);
+	current.cost = clever::sphere_function(current.vector);
 
 	for (size_t iter = 0; iter < max_iter; ++iter)
 	{
@@ -115,6 +80,7 @@ void search(candidate_solution& current, const size_t max_iter, std::vector<std:
 			}
 		}
 		std::cout << "> iteration " << iter + 1 << ", best = " << current.cost << std::endl;
+		clever::trace_progress(1 + 2 * (iter + 1), current.cost);
 	}
 }
 
@@ -1,14 +1,10 @@
-#include <random>
 #include <algorithm>
 #include <cfloat>
 #include <cmath>
 #include <iostream>
 
+#include "clever_algorithm.h"
 
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_real_distribution<> distribution(0.0, 1.0);
-auto random_double = []() { return distribution(generator); };
 
 using prob_info = struct prob_info_t
 {
@@ -21,173 +17,189 @@ using prob_info = struct prob_info_t
 	size_t city = 0;
 };
 
-using candidate_info = struct candidate_info_t
+using candidate_info = clever::permutation_solution;
+
+void initialise_pheromone(clever::pheromone_matrix& pheromone,
+                          const size_t num_cities, const double initial_pheromone)
+{
+	pheromone.reset(num_cities, initial_pheromone);
+}
+
+// How the ants of one iteration, built concurrently, apply their local
+// pheromone update. deferred: every ant reads the trails as they were at
+// the start of the iteration and the updates are applied afterwards in ant
+// order, so runs are reproducible. atomic: each ant blends its edges as
+// soon as its tour is complete, and ants still running may see them.
+enum class local_update_policy
 {
-	std::vector<size_t> vector;
-	double cost = DBL_MAX;
+	deferred,
+	atomic
 };
 
-double euc_2d(const std::vector<double>& x, const std::vector<double>& y)
+// Scratch space owned by one ant, reused for every tour it builds.
+using ant_scratch = struct ant_scratch_t
 {
-	double sum = 0;
-	for (size_t i = 0; i < x.size(); ++i)
-	{
-		sum += (x[i] - y[i]) * (x[i] - y[i]);
-	}
-	return sqrt(sum);
-}
+	std::vector<prob_info> choices;
+	// the weights of the choices, turned into prefix sums to draw from
+	std::vector<double> weights;
+	clever::bit_string visited;
+};
 
-double cost(const std::vector<size_t>& permutation,
-            const std::vector<std::vector<double>>& cities)
+// heuristic[i * k + m] = (1 / d(i, m-th neighbour of i))^c_heuristic
+void initialise_heuristic(std::vector<double>& heuristic, const clever::distance_provider& distance,
+                          const double c_heuristic)
 {
-	double distance = 0.0;
-	for (size_t i = 0; i < permutation.size(); ++i)
+	const auto k = distance.num_neighbors();
+	heuristic.resize(distance.size() * k);
+	for (size_t i = 0; i < distance.size(); ++i)
 	{
-		auto& c1 = permutation[i];
-		auto& c2 = i == permutation.size() - 1 ? permutation[0] : permutation[i + 1];
-		distance += euc_2d(cities[c1], cities[c2]);
+		for (size_t m = 0; m < k; ++m)
+		{
+			heuristic[i * k + m] = pow(1.0 / distance(i, distance.neighbors(i)[m]), c_heuristic);
+		}
 	}
-	return distance;
 }
 
-void random_permutation(std::vector<size_t>& permutation,
-                        const std::vector<std::vector<double>>& cities)
+double read_pheromone(const clever::pheromone_matrix& pheromone, const size_t i, const size_t j,
+                      const local_update_policy policy)
 {
-	permutation.resize(cities.size());
-	for (size_t i = 0; i < permutation.size(); ++i)
-	{
-		permutation[i] = i;
-	}
-	for (size_t i = 0; i < permutation.size(); ++i)
-	{
-		const auto r = static_cast<size_t>(random_double() * (permutation.size() - i)) + i;
-		std::swap(permutation[i], permutation[r]);
-	}
+	return policy == local_update_policy::atomic ? pheromone.load(i, j) : pheromone(i, j);
 }
 
-void initialise_pheromone(std::vector<std::vector<double>>& pheromone,
-                          const size_t num_cities, const double initial_pheromone)
+void add_choice(std::vector<prob_info>& choices,
+                const clever::distance_provider& distance,
+                const size_t last_city,
+                const size_t city,
+                const double history,
+                const double heuristic)
 {
-	pheromone.resize(num_cities);
-	for (size_t i = 0; i < num_cities; ++i)
-	{
-		pheromone[i].resize(num_cities);
-		for (size_t j = 0; j < num_cities; ++j)
-		{
-			pheromone[i][j] = initial_pheromone;
-		}
-	}
+	prob_info prob;
+	prob.city = city;
+	prob.history = history;
+	prob.distance = distance(last_city, city);
+	prob.heuristic = heuristic;
+	prob.probability = prob.history * prob.heuristic;
+	choices.push_back(prob);
 }
 
+// Only the unvisited cities on the candidate list of last_city are
+// considered; once all of them are visited, every unvisited city is.
 void calculate_choices(std::vector<prob_info>& choices,
-                       const std::vector<std::vector<double>>& cities,
+                       const clever::distance_provider& distance,
+                       const std::vector<double>& heuristic,
                        const size_t last_city,
-                       const std::vector<size_t>& exclude,
-                       const std::vector<std::vector<double>>& pheromone,
+                       const clever::bit_string& visited,
+                       const clever::pheromone_matrix& pheromone,
                        const double c_heuristic,
-                       const double c_history)
+                       const local_update_policy policy)
 {
 	choices.clear();
-
-	for (size_t i = 0; i < cities.size(); ++i)
+	const auto k = distance.num_neighbors();
+	const auto* neighbors = distance.neighbors(last_city);
+	for (size_t m = 0; m < k; ++m)
+	{
+		const auto i = neighbors[m];
+		if (!visited[i])
+		{
+			add_choice(choices, distance, last_city, i, read_pheromone(pheromone, last_city, i, policy),
+			           heuristic[last_city * k + m]);
+		}
+	}
+	if (!choices.empty())
 	{
-		auto coordinate = cities[i];
-		if (std::find(exclude.begin(), exclude.end(), i) != exclude.end())
+		return;
+	}
+	for (size_t i = 0; i < distance.size(); ++i)
+	{
+		if (!visited[i])
 		{
-			continue;
+			add_choice(choices, distance, last_city, i, read_pheromone(pheromone, last_city, i, policy),
+			           pow(1.0 / distance(last_city, i), c_heuristic));
 		}
-		prob_info prob;
-		prob.city = i;
-		prob.history = pow(pheromone[last_city][i], c_history);
-		prob.distance = euc_2d(cities[last_city], coordinate);
-		prob.heuristic = pow(1.0 / prob.distance, c_heuristic);
-		prob.probability = prob.history * prob.heuristic;
-		choices.push_back(prob);
 	}
 }
 
-size_t prob_selection(const std::vector<prob_info>& choices)
+size_t prob_selection(const std::vector<prob_info>& choices,
+                      std::vector<double>& weights,
+                      clever::random_engine& rng)
 {
-	double sum = 0.0;
-	for (auto& choice : choices)
-	{
-		sum += choice.probability;
-	}
-	if (sum == 0.0)
+	weights.resize(choices.size());
+	for (size_t i = 0; i < choices.size(); ++i)
 	{
-		const auto random_index = static_cast<size_t>(random_double() * (choices.size() - 1));
-		return choices[random_index].city;
+		weights[i] = choices[i].probability;
 	}
-	double v = random_double();
-	for (const auto& choice : choices)
+	auto selected = clever::sample_once(weights.data(), weights.size(), rng);
+	if (selected == choices.size())
 	{
-		v -= choice.probability / sum;
-		if (v <= 0.0)
-		{
-			return choice.city;
-		}
+		selected = clever::random_index(choices.size(), rng);
 	}
-	return choices[choices.size() - 1].city;
+	return choices[selected].city;
 }
 
 size_t greedy_select(const std::vector<prob_info>& choices)
 {
-	double min_cost = DBL_MAX;
-	size_t min_index = 0;
+	double max_probability = -1.0;
+	size_t max_index = 0;
 	for (size_t i = 0; i < choices.size(); ++i)
 	{
-		if (choices[i].cost < min_cost)
+		if (choices[i].probability > max_probability)
 		{
-			min_cost = choices[i].cost;
-			min_index = i;
+			max_probability = choices[i].probability;
+			max_index = i;
 		}
 	}
-	return choices[min_index].city;
+	return choices[max_index].city;
 }
 
 void stepwise_const(std::vector<size_t>& permutation,
-                    const std::vector<std::vector<double>>& cities,
-                    const std::vector<std::vector<double>>& pheromone,
+                    ant_scratch& scratch,
+                    const clever::distance_provider& distance,
+                    const std::vector<double>& heuristic,
+                    const clever::pheromone_matrix& pheromone,
                     const double c_heuristic,
-                    const double c_greed)
+                    const double c_greed,
+                    const local_update_policy policy,
+                    clever::random_engine& rng)
 {
+	scratch.visited.resize(distance.size());
+	scratch.visited.reset();
+	scratch.choices.reserve(distance.size());
 	permutation.clear();
-	const auto random_index = static_cast<size_t>(random_double() * (cities.size() - 1));
-	permutation.push_back(random_index);
-	while (permutation.size() < cities.size())
+	permutation.push_back(clever::random_index(distance.size(), rng));
+	scratch.visited.set(permutation.back(), true);
+	while (permutation.size() < distance.size())
 	{
-		std::vector<prob_info> choices;
-		calculate_choices(choices, cities, permutation.back(), permutation, pheromone, c_heuristic, c_greed);
-		const auto greedy = random_double() < c_greed;
-		auto next_city = greedy ? greedy_select(choices) : prob_selection(choices);
+		calculate_choices(scratch.choices, distance, heuristic, permutation.back(), scratch.visited, pheromone,
+		                  c_heuristic, policy);
+		const auto greedy = clever::random_uniform(rng) < c_greed;
+		auto next_city = greedy ? greedy_select(scratch.choices) : prob_selection(scratch.choices, scratch.weights, rng);
 		permutation.push_back(next_city);
+		scratch.visited.set(next_city, true);
 	}
 }
 
-void global_update_pheromone(std::vector<std::vector<double>>& pheromone,
+void global_update_pheromone(clever::pheromone_matrix& pheromone,
                              const candidate_info& candidate,
                              const double decay)
 {
-	for (size_t i = 0; i < candidate.vector.size(); ++i)
-	{
-		auto& x = candidate.vector[i];
-		auto& y = i == candidate.vector.size() - 1 ? candidate.vector[0] : candidate.vector[i + 1];
-		pheromone[x][y] = (1.0 - decay) * pheromone[x][y] + decay * 1.0 / candidate.cost;
-		pheromone[y][x] = pheromone[x][y];
-	}
+	pheromone.update(candidate.vector, 1.0 - decay, decay * 1.0 / candidate.cost);
 }
 
-void local_update_pheromone(std::vector<std::vector<double>>& pheromone,
+void local_update_pheromone(clever::pheromone_matrix& pheromone,
                             const candidate_info& candidate,
                             const double c_local_pheromone,
-                            const double init_pheromone)
+                            const double init_pheromone,
+                            const local_update_policy policy)
 {
-	for (size_t i = 0; i < candidate.vector.size(); ++i)
+	const auto keep = 1.0 - c_local_pheromone;
+	const auto add = c_local_pheromone * init_pheromone;
+	if (policy == local_update_policy::atomic)
 	{
-		auto& x = candidate.vector[i];
-		auto& y = i == candidate.vector.size() - 1 ? candidate.vector[0] : candidate.vector[i + 1];
-		pheromone[x][y] = (1.0 - c_local_pheromone) * pheromone[x][y] + c_local_pheromone * init_pheromone;
-		pheromone[y][x] = pheromone[x][y];
+		pheromone.update_atomic(candidate.vector, keep, add);
+	}
+	else
+	{
+		pheromone.update(candidate.vector, keep, add);
 	}
 }
 
@@ -198,48 +210,68 @@ void search(candidate_info& best,
             const double decay,
             const double c_heuristic,
             const double c_local_pheromone,
-            const double c_greed)
+            const double c_greed,
+            const size_t num_neighbors,
+            const local_update_policy policy)
 {
-	random_permutation(best.vector, cities);
-	best.cost = cost(best.vector, cities);
+	clever::distance_provider distance(cities);
+	distance.build_neighbor_lists(num_neighbors);
+	clever::random_permutation(best.vector, cities.size());
+	best.cost = clever::tour_cost(best.vector, distance);
 	const auto init_pheromone = 1.0 / (cities.size() * best.cost);
-	std::vector<std::vector<double>> pheromone;
+	clever::pheromone_matrix pheromone;
 	initialise_pheromone(pheromone, cities.size(), init_pheromone);
+	std::vector<double> heuristic;
+	initialise_heuristic(heuristic, distance, c_heuristic);
+	std::vector<ant_scratch> scratch(num_ants);
+	std::vector<candidate_info> candidates(num_ants);
 	for (size_t iteration = 0; iteration < max_it; ++iteration)
 	{
-		for (size_t i = 0; i < num_ants; ++i)
+		// ant i draws from stream i, so tours do not depend on the thread count
+		const auto seed = clever::default_engine()();
+		clever::default_pool().parallel_for(num_ants, [&](const size_t i)
+		{
+			auto& candidate = candidates[i];
+			clever::random_engine rng(seed, i);
+			stepwise_const(candidate.vector, scratch[i], distance, heuristic, pheromone, c_heuristic, c_greed, policy,
+			               rng);
+			candidate.cost = clever::tour_cost(candidate.vector, distance);
+			if (policy == local_update_policy::atomic)
+			{
+				local_update_pheromone(pheromone, candidate, c_local_pheromone, init_pheromone, policy);
+			}
+		});
+		if (policy == local_update_policy::atomic)
+		{
+			pheromone.sync_mirror();
+		}
+		for (const auto& candidate : candidates)
 		{
-			candidate_info candidate;
-			stepwise_const(candidate.vector, cities, pheromone, c_heuristic, c_greed);
-			candidate.cost = cost(candidate.vector, cities);
 			if (candidate.cost < best.cost)
 			{
 				best = candidate;
 			}
-			local_update_pheromone(pheromone, candidate, c_local_pheromone, init_pheromone);
+			if (policy == local_update_policy::deferred)
+			{
+				local_update_pheromone(pheromone, candidate, c_local_pheromone, init_pheromone, policy);
+			}
 		}
 		global_update_pheromone(pheromone, best, decay);
 		std::cout << "Iteration " << iteration + 1 << ", best = " << best.cost << std::endl;
+		clever::trace_progress(1 + (iteration + 1) * num_ants, best.cost);
 	}
 }
 
 
 int main(int argc, char* argv[])
 {
-	// problem configuration
-	const std::vector<std::vector<double>> berlin52 = {
-		{565, 575}, {25, 185}, {345, 750}, {945, 685}, {845, 655},
-		{880, 660}, {25, 230}, {525, 1000}, {580, 1175}, {650, 1130},
-		{1605, 620}, {1220, 580}, {1465, 200}, {1530, 5}, {845, 680},
-		{725, 370}, {145, 665}, {415, 635}, {510, 875}, {560, 365},
-		{300, 465}, {520, 585}, {480, 415}, {835, 625}, {975, 580},
-		{1215, 245}, {1320, 315}, {1250, 400}, {660, 180}, {410, 250},
-		{420, 555}, {575, 665}, {1150, 1160}, {700, 580}, {685, 595},
-		{685, 610}, {770, 610}, {795, 645}, {720, 635}, {760, 650},
-		{475, 960}, {95, 260}, {875, 920}, {700, 500}, {555, 815},
-		{830, 485}, {1170, 65}, {830, 610}, {605, 625}, {595, 360},
-		{1340, 725}, {1740, 245}
-	};
+	// problem configuration, a TSPLIB instance may be given instead of berlin52
+	auto cities = clever::berlin52();
+	if (argc > 1 && !clever::load_tsplib(argv[1], cities))
+	{
+		std::cout << "Cannot read the TSPLIB instance " << argv[1] << std::endl;
+		return 1;
+	}
 	// algorithm configuration
 	const size_t max_it = 100;
 	const size_t num_ants = 10;
@@ -247,9 +279,11 @@ int main(int argc, char* argv[])
 	const double c_heuristic = 2.5;
 	const double c_local_phero = 0.1;
 	const double c_greed = 0.9;
+	const size_t num_neighbors = 15;
+	const auto policy = local_update_policy::deferred;
 	// execute the algorithm
 	candidate_info best;
-	search(best, berlin52, max_it, num_ants, decay, c_heuristic, c_local_phero, c_greed);
+	search(best, cities, max_it, num_ants, decay, c_heuristic, c_local_phero, c_greed, num_neighbors, policy);
 	std::cout << " > Done. Best Solution: c = " << best.cost << ", v = ";
 	for (const auto& city : best.vector)
 	{
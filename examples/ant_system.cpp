@@ -4,11 +4,8 @@
 #include <iostream>
 #include <algorithm>
 
+#include "clever_algorithm.h"
 
-double random(const double min, const double max)
-{
-	return min + (max - min) * rand() / RAND_MAX;
-}
 
 using probabilistic_info = struct probabilistic_info_t
 {
@@ -21,153 +18,145 @@ using probabilistic_info = struct probabilistic_info_t
 	size_t city = 0;
 };
 
-using candidate_info = struct candidate_info_t
-{
-	std::vector<size_t> vector;
-	double cost = DBL_MAX;
-};
+using candidate_info = clever::permutation_solution;
 
 
-double euc_2d(const std::vector<double>& x, const std::vector<double>& y)
+void initialise_pheromone_matrix(clever::pheromone_matrix& pheromone_matrix, const size_t size,
+                                 const double naive_score)
 {
-	double sum = 0.0;
-	for (size_t i = 0; i < x.size(); i++)
-	{
-		sum += (x[i] - y[i]) * (x[i] - y[i]);
-	}
-	return sqrt(sum);
+	pheromone_matrix.reset(size, size / naive_score);
 }
 
-double cost(const std::vector<size_t>& permutation, const std::vector<std::vector<double>>& cities)
+// Scratch space owned by one ant, reused for every tour it builds.
+using ant_scratch = struct ant_scratch_t
 {
-	double distance = 0.0;
-	for (size_t i = 0; i < permutation.size(); i++)
-	{
-		auto& c1 = permutation[i];
-		auto& c2 = i == permutation.size() - 1 ? permutation[0] : permutation[i + 1];
-		distance += euc_2d(cities[c1], cities[c2]);
-	}
-	return distance;
-}
+	std::vector<probabilistic_info> choices;
+	// the weights of the choices, turned into prefix sums to draw from
+	std::vector<double> weights;
+	clever::bit_string visited;
+};
 
-void random_permutation(std::vector<size_t>& permutation, const size_t size)
+// heuristic[i * k + m] = (1 / d(i, m-th neighbour of i))^c_heur
+void initialise_heuristic(std::vector<double>& heuristic, const clever::distance_provider& distance,
+                          const double c_heur)
 {
-	permutation.resize(size);
-	for (size_t i = 0; i < size; i++)
+	const auto k = distance.num_neighbors();
+	heuristic.resize(distance.size() * k);
+	for (size_t i = 0; i < distance.size(); i++)
 	{
-		permutation[i] = i;
-	}
-	for (size_t i = 0; i < size; i++)
-	{
-		const size_t j = rand() % size;
-		std::swap(permutation[i], permutation[j]);
+		for (size_t m = 0; m < k; m++)
+		{
+			heuristic[i * k + m] = pow(1.0 / distance(i, distance.neighbors(i)[m]), c_heur);
+		}
 	}
 }
 
-void initialise_pheromone_matrix(std::vector<std::vector<double>>& pheromone_matrix, const size_t size,
-                                 const double naive_score)
+void add_choice(std::vector<probabilistic_info>& choices,
+                const clever::distance_provider& distance,
+                const size_t last_city,
+                const size_t city,
+                const double pheromone,
+                const double heuristic,
+                const double c_hist)
 {
-	const auto v = size / naive_score;
-	pheromone_matrix.resize(size);
-	for (size_t i = 0; i < size; i++)
-	{
-		pheromone_matrix[i].resize(size);
-		for (size_t j = 0; j < size; j++)
-		{
-			pheromone_matrix[i][j] = v;
-		}
-	}
+	probabilistic_info prob;
+	prob.city = city;
+	prob.history = c_hist == 1.0 ? pheromone : pow(pheromone, c_hist);
+	prob.distance = distance(last_city, city);
+	prob.heuristic = heuristic;
+	prob.prob = prob.history * prob.heuristic;
+	choices.push_back(prob);
 }
 
+// Only the unvisited cities on the candidate list of last_city are
+// considered; once all of them are visited, every unvisited city is.
 void calculate_choices(std::vector<probabilistic_info>& choices,
-                       const std::vector<std::vector<double>>& cities,
+                       const clever::distance_provider& distance,
+                       const std::vector<double>& heuristic,
                        const size_t last_city,
-                       const std::vector<size_t>& exclude,
-                       const std::vector<std::vector<double>>& pheromone_matrix,
+                       const clever::bit_string& visited,
+                       const clever::pheromone_matrix& pheromone_matrix,
                        const double c_heur,
                        const double c_hist)
 {
 	choices.clear();
-	for (size_t i = 0; i < cities.size(); i++)
+	const auto k = distance.num_neighbors();
+	const auto* neighbors = distance.neighbors(last_city);
+	for (size_t m = 0; m < k; m++)
+	{
+		const auto i = neighbors[m];
+		if (!visited[i])
+		{
+			add_choice(choices, distance, last_city, i, pheromone_matrix(last_city, i), heuristic[last_city * k + m],
+			           c_hist);
+		}
+	}
+	if (!choices.empty())
 	{
-		auto& coord = cities[i];
-		if (std::find(exclude.begin(), exclude.end(), i) != exclude.end())
+		return;
+	}
+	for (size_t i = 0; i < distance.size(); i++)
+	{
+		if (!visited[i])
 		{
-			continue;
+			add_choice(choices, distance, last_city, i, pheromone_matrix(last_city, i),
+			           pow(1.0 / distance(last_city, i), c_heur), c_hist);
 		}
-		probabilistic_info prob;
-		prob.city = i;
-		prob.history = pow(pheromone_matrix[last_city][i], c_hist);
-		prob.distance = euc_2d(cities[last_city], coord);
-		prob.heuristic = pow(1.0 / prob.distance, c_heur);
-		prob.prob = prob.history * prob.heuristic;
-		choices.push_back(prob);
 	}
 }
 
-size_t select_next_city(const std::vector<probabilistic_info>& choices)
+size_t select_next_city(const std::vector<probabilistic_info>& choices,
+                        std::vector<double>& weights,
+                        clever::random_engine& rng)
 {
-	double sum = 0.0;
-	for (auto& c : choices)
+	weights.resize(choices.size());
+	for (size_t i = 0; i < choices.size(); ++i)
 	{
-		sum += c.prob;
+		weights[i] = choices[i].prob;
 	}
-	if (sum == 0.0)
+	auto selected = clever::sample_once(weights.data(), weights.size(), rng);
+	if (selected == choices.size())
 	{
-		return choices[rand() % choices.size()].city;
-	}
-	auto v = random(0.0, 1.0);
-	for (const auto& choice : choices)
-	{
-		v -= choice.prob / sum;
-		if (v <= 0.0)
-		{
-			return choice.city;
-		}
+		selected = clever::random_index(choices.size(), rng);
 	}
-	auto& choice = choices[choices.size() - 1];
-	return choice.city;
+	return choices[selected].city;
 }
 
 void stepwise_const(
 	std::vector<size_t>& permutation,
-	const std::vector<std::vector<double>>& cities,
-	const std::vector<std::vector<double>>& pheromone_matrix,
+	ant_scratch& scratch,
+	const clever::distance_provider& distance,
+	const std::vector<double>& heuristic,
+	const clever::pheromone_matrix& pheromone_matrix,
 	const double c_heur,
-	const double c_hist)
+	const double c_hist,
+	clever::random_engine& rng)
 {
+	scratch.visited.resize(distance.size());
+	scratch.visited.reset();
+	scratch.choices.reserve(distance.size());
 	permutation.clear();
-	permutation.push_back(rand() % cities.size());
-	while (permutation.size() < cities.size())
+	permutation.push_back(clever::random_index(distance.size(), rng));
+	scratch.visited.set(permutation.back(), true);
+	while (permutation.size() < distance.size())
 	{
-		std::vector<probabilistic_info> choices;
-		calculate_choices(choices, cities, permutation.back(), permutation, pheromone_matrix, c_heur, c_hist);
-		permutation.push_back(select_next_city(choices));
+		calculate_choices(scratch.choices, distance, heuristic, permutation.back(), scratch.visited, pheromone_matrix,
+		                  c_heur, c_hist);
+		permutation.push_back(select_next_city(scratch.choices, scratch.weights, rng));
+		scratch.visited.set(permutation.back(), true);
 	}
 }
 
-void decay_pheromone(std::vector<std::vector<double>>& pheromone_matrix, const double decay_rate)
+void decay_pheromone(clever::pheromone_matrix& pheromone_matrix, const double decay_rate)
 {
-	for (size_t i = 0; i < pheromone_matrix.size(); i++)
-	{
-		for (size_t j = 0; j < pheromone_matrix[0].size(); j++)
-		{
-			pheromone_matrix[i][j] *= 1.0 - decay_rate;
-		}
-	}
+	pheromone_matrix.evaporate(decay_rate);
 }
 
-void update_pheromone(std::vector<std::vector<double>>& pheromone_matrix, const std::vector<candidate_info>& solutions)
+void update_pheromone(clever::pheromone_matrix& pheromone_matrix, const std::vector<candidate_info>& solutions)
 {
 	for (auto& other : solutions)
 	{
-		for (size_t i = 0; i < other.vector.size(); i++)
-		{
-			auto& x = other.vector[i];
-			auto& y = i == other.vector.size() - 1 ? other.vector[0] : other.vector[i + 1];
-			pheromone_matrix[x][y] += other.cost;
-			pheromone_matrix[y][x] += other.cost;
-		}
+		pheromone_matrix.deposit(other.vector, 1.0 / other.cost);
 	}
 }
 
@@ -177,21 +166,31 @@ void search(candidate_info& best,
             const size_t num_ants,
             const double decay_factor,
             const double c_heur,
-            const double c_hist)
+            const double c_hist,
+            const size_t num_neighbors)
 {
-	random_permutation(best.vector, cities.size());
-	best.cost = cost(best.vector, cities);
-	std::vector<std::vector<double>> pheromone;
+	clever::distance_provider distance(cities);
+	distance.build_neighbor_lists(num_neighbors);
+	clever::random_permutation(best.vector, cities.size());
+	best.cost = clever::tour_cost(best.vector, distance);
+	clever::pheromone_matrix pheromone;
 	initialise_pheromone_matrix(pheromone, cities.size(), best.cost);
+	std::vector<double> heuristic;
+	initialise_heuristic(heuristic, distance, c_heur);
+	std::vector<ant_scratch> scratch(num_ants);
+	std::vector<candidate_info> solutions(num_ants);
 	for (size_t iter = 0; iter < max_it; iter++)
 	{
-		std::vector<candidate_info> solutions;
-		for (size_t i = 0; i < num_ants; i++)
+		// ant i draws from stream i, so tours do not depend on the thread count
+		const auto seed = clever::default_engine()();
+		clever::default_pool().parallel_for(num_ants, [&](const size_t i)
+		{
+			clever::random_engine rng(seed, i);
+			stepwise_const(solutions[i].vector, scratch[i], distance, heuristic, pheromone, c_heur, c_hist, rng);
+			solutions[i].cost = clever::tour_cost(solutions[i].vector, distance);
+		});
+		for (const auto& candidate : solutions)
 		{
-			candidate_info candidate;
-			stepwise_const(candidate.vector, cities, pheromone, c_heur, c_hist);
-			candidate.cost = cost(candidate.vector, cities);
-			solutions.push_back(candidate);
 			if (candidate.cost < best.cost)
 			{
 				best = candidate;
@@ -200,35 +199,30 @@ void search(candidate_info& best,
 		decay_pheromone(pheromone, decay_factor);
 		update_pheromone(pheromone, solutions);
 		std::cout << " > Iteration: " << iter + 1 << " Best: " << best.cost << std::endl;
+		clever::trace_progress(1 + (iter + 1) * num_ants, best.cost);
 	}
 }
 
 
 int main(int argc, char** argv)
 {
-	// problem configuration
-	const std::vector<std::vector<double>> berlin52 = {
-		{565, 575}, {25, 185}, {345, 750}, {945, 685}, {845, 655},
-		{880, 660}, {25, 230}, {525, 1000}, {580, 1175}, {650, 1130},
-		{1605, 620}, {1220, 580}, {1465, 200}, {1530, 5}, {845, 680},
-		{725, 370}, {145, 665}, {415, 635}, {510, 875}, {560, 365},
-		{300, 465}, {520, 585}, {480, 415}, {835, 625}, {975, 580},
-		{1215, 245}, {1320, 315}, {1250, 400}, {660, 180}, {410, 250},
-		{420, 555}, {575, 665}, {1150, 1160}, {700, 580}, {685, 595},
-		{685, 610}, {770, 610}, {795, 645}, {720, 635}, {760, 650},
-		{475, 960}, {95, 260}, {875, 920}, {700, 500}, {555, 815},
-		{830, 485}, {1170, 65}, {830, 610}, {605, 625}, {595, 360},
-		{1340, 725}, {1740, 245}
-	};
+	// problem configuration, a TSPLIB instance may be given instead of berlin52
+	auto cities = clever::berlin52();
+	if (argc > 1 && !clever::load_tsplib(argv[1], cities))
+	{
+		std::cout << "Cannot read the TSPLIB instance " << argv[1] << std::endl;
+		return 1;
+	}
 	// algorithm configuration
 	const size_t max_it = 50;
 	const size_t num_ants = 30;
 	const double decay_factor = 0.6;
 	const double c_heur = 2.5;
 	const double c_hist = 1.0;
+	const size_t num_neighbors = 15;
 	// execute the algorithm
 	candidate_info best;
-	search(best, berlin52, max_it, num_ants, decay_factor, c_heur, c_hist);
+	search(best, cities, max_it, num_ants, decay_factor, c_heur, c_hist, num_neighbors);
 	std::cout << "Done. Best Solution:  c = " << best.cost << " V = ";
 	for (const auto& city : best.vector)
 	{
@@ -1,16 +1,13 @@
 #include <vector>
-#include <random>
 #include <cmath>
 #include <iostream>
 #include <cfloat>
 #include <map>
 #include <algorithm>
+#include <memory>
 
+#include "clever_algorithm.h"
 
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_real_distribution<> distribution(0.0, 1.0);
-auto random_double = []() { return distribution(generator); };
 
 using candidate_solution = struct candidate_solution_st
 {
@@ -24,15 +21,18 @@ using candidate_solution = struct candidate_solution_st
 using domain_info = std::map<size_t, std::vector<std::vector<double>>>;
 
 
-void random_vector(std::vector<double>& vector,
-                   const std::vector<std::vector<double>>& min_max)
+// Memory cells structure-of-arrays, so that the distances from a pattern
+// to every cell are one kernel call; label i belongs to candidate i.
+using cell_store = struct cell_store_t
 {
-	vector.resize(min_max.size());
-	for (size_t i = 0; i < vector.size(); ++i)
-	{
-		vector[i] = min_max[i][0] + random_double() * (min_max[i][1] - min_max[i][0]);
-	}
-}
+	clever::candidate_batch vectors;
+	std::vector<size_t> labels;
+};
+
+
+// the largest distance within the unit square, which scales affinities
+const double max_distance = std::sqrt(2.0);
+
 
 void generate_random_pattern(candidate_solution& pattern, domain_info& domain)
 {
@@ -41,10 +41,9 @@ void generate_random_pattern(candidate_solution& pattern, domain_info& domain)
 	{
 		tmp_indexes.push_back(item.first);
 	}
-	const auto random_index = static_cast<size_t>(random_double() * (tmp_indexes.size() - 1));
-	const size_t class_label = tmp_indexes[random_index];
+	const size_t class_label = tmp_indexes[clever::random_index(tmp_indexes.size())];
 	pattern.label = class_label;
-	random_vector(pattern.vector, domain[class_label]);
+	clever::random_vector(pattern.vector, domain[class_label]);
 }
 
 void create_cell(candidate_solution& cell,
@@ -55,53 +54,48 @@ void create_cell(candidate_solution& cell,
 	cell.label = class_label;
 }
 
-void initialize_cells(std::vector<candidate_solution>& mem_cells, const domain_info& domain)
+void add_cell(cell_store& mem_cells, const std::vector<double>& vector, const size_t class_label)
 {
-	for (const auto& item : domain)
-	{
-		candidate_solution cell;
-		std::vector<double> vector;
-		std::vector<std::vector<double>> min_max = {{0.0, 1.0}, {0.0, 1.0}};
-		random_vector(vector, min_max);
-		create_cell(cell, vector, item.first);
-		mem_cells.push_back(cell);
-	}
+	mem_cells.vectors.push_back(vector);
+	mem_cells.labels.push_back(class_label);
 }
 
-double distance(const std::vector<double>& x, const std::vector<double>& y)
+void initialize_cells(cell_store& mem_cells, const domain_info& domain)
 {
-	double sum = 0.0;
-	for (size_t i = 0; i < x.size(); ++i)
+	mem_cells.vectors.resize(0, 2);
+	mem_cells.labels.clear();
+	for (const auto& item : domain)
 	{
-		sum += (x[i] - y[i]) * (x[i] - y[i]);
+		std::vector<double> vector;
+		std::vector<std::vector<double>> min_max = {{0.0, 1.0}, {0.0, 1.0}};
+		clever::random_vector(vector, min_max);
+		add_cell(mem_cells, vector, item.first);
 	}
-	return sqrt(sum);
 }
 
 void stimulate(std::vector<candidate_solution>& cells,
                const candidate_solution& pattern)
 {
-	const std::vector<double> x0 = {0.0, 0.0};
-	const std::vector<double> y0 = {1.0, 1.0};
-	const auto max_distance = distance(x0, y0);
 	for (auto& cell : cells)
 	{
-		cell.affinity = distance(cell.vector, pattern.vector) / max_distance;
+		cell.affinity = clever::euclidean_distance(cell.vector, pattern.vector) / max_distance;
 		cell.stimulation = 1.0 - cell.affinity;
 	}
 }
 
+// The memory cell nearest to the pattern, from one distance kernel call
+// over the store; distances is scratch space.
 void get_most_stimulated_cell(candidate_solution& cell,
-                              std::vector<candidate_solution>& mem_cells,
-                              const candidate_solution& pattern)
+                              const cell_store& mem_cells,
+                              const candidate_solution& pattern,
+                              std::vector<double>& distances)
 {
-	stimulate(mem_cells, pattern);
-	std::sort(mem_cells.begin(), mem_cells.end(),
-	          [](const candidate_solution& a, const candidate_solution& b)
-	          {
-		          return a.stimulation > b.stimulation;
-	          });
-	cell = mem_cells[0];
+	clever::squared_distances(mem_cells.vectors, pattern.vector.data(), distances);
+	const auto best = static_cast<size_t>(std::min_element(distances.begin(), distances.end()) - distances.begin());
+	mem_cells.vectors.get(best, cell.vector);
+	cell.label = mem_cells.labels[best];
+	cell.affinity = std::sqrt(distances[best]) / max_distance;
+	cell.stimulation = 1.0 - cell.affinity;
 }
 
 void mutate_cell(candidate_solution& cell,
@@ -112,7 +106,7 @@ void mutate_cell(candidate_solution& cell,
 	{
 		const auto min = std::max(v - range / 2.0, 0.0);
 		const auto max = std::min(v + range / 2.0, 1.0);
-		v = min + random_double() * (max - min);
+		v = min + clever::random_uniform() * (max - min);
 	}
 }
 
@@ -126,7 +120,7 @@ void create_arb_pool(std::vector<candidate_solution>& pool,
 	candidate_solution tmp_candidate;
 	create_cell(tmp_candidate, best_match.vector, best_match.label);
 	pool.push_back(tmp_candidate);
-	const auto num_clones = static_cast<size_t>(best_match.stimulation * clone_rate * mutation_rate);
+	const auto num_clones = static_cast<size_t>(std::round(best_match.stimulation * clone_rate * mutation_rate));
 	for (size_t i = 0; i < num_clones; ++i)
 	{
 		candidate_solution cell;
@@ -136,6 +130,11 @@ void create_arb_pool(std::vector<candidate_solution>& pool,
 	}
 }
 
+// Keeps the most stimulated cells whose resources, stimulation times
+// clone_rate each, fit within max_resources, and always the most
+// stimulated one. The cut is found by partial selection: nth_element
+// splits the undecided range at its middle, and the upper half is kept
+// whole when it fits the remaining budget. Returns the resources kept.
 double competition_for_resources(std::vector<candidate_solution>& pool,
                                  const double clone_rate,
                                  const double max_resources)
@@ -144,88 +143,131 @@ double competition_for_resources(std::vector<candidate_solution>& pool,
 	{
 		cell.resources = cell.stimulation * clone_rate;
 	}
-	std::sort(pool.begin(), pool.end(),
-	          [](const candidate_solution& a, const candidate_solution& b)
-	          {
-		          return a.resources < b.resources;
-	          });
-	auto total_resources = 0.0;
-	for (const auto& cell : pool)
+	const auto more_stimulated = [](const candidate_solution& a, const candidate_solution& b)
 	{
-		total_resources += cell.resources;
+		return a.stimulation > b.stimulation;
+	};
+	// pool[0, lo) is kept, pool[lo, hi) undecided and the rest dropped
+	size_t lo = 0;
+	size_t hi = pool.size();
+	double budget = max_resources;
+	while (lo < hi)
+	{
+		const auto mid = lo + (hi - lo) / 2;
+		std::nth_element(pool.begin() + lo, pool.begin() + mid, pool.begin() + hi, more_stimulated);
+		double upper = 0.0;
+		for (size_t i = lo; i <= mid; ++i)
+		{
+			upper += pool[i].resources;
+		}
+		if (upper <= budget)
+		{
+			budget -= upper;
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
 	}
-	while (total_resources > max_resources)
+	if (lo == 0 && !pool.empty())
 	{
-		const auto cell = pool.back();
-		total_resources -= cell.resources;
+		std::iter_swap(pool.begin(), std::min_element(pool.begin(), pool.end(), more_stimulated));
+		budget -= pool[0].resources;
+		lo = 1;
 	}
-
-	return total_resources;
+	pool.resize(lo);
+	return max_resources - budget;
 }
 
+// Competes and clones until the pool's mean stimulation reaches the
+// threshold, or for max_refinements rounds; the candidate is the most
+// stimulated cell of the last round.
 void refine_arb_pool(candidate_solution& candidate,
                      std::vector<candidate_solution>& pool,
                      const candidate_solution& pattern,
                      const double stimulation_threshold,
                      const double clone_rate,
-                     const double max_resources)
+                     const double max_resources,
+                     const size_t max_refinements = 100)
 {
-	double mean_stimulation = 0.0;
-	while (mean_stimulation < stimulation_threshold)
+	for (size_t round = 0; round < max_refinements; ++round)
 	{
 		stimulate(pool, pattern);
-		std::sort(pool.begin(), pool.end(),
-		          [](const candidate_solution& a, const candidate_solution& b)
-		          {
-			          return a.stimulation > b.stimulation;
-		          });
-		candidate = pool[0];
+		candidate = *std::min_element(pool.begin(), pool.end(),
+		                              [](const candidate_solution& a, const candidate_solution& b)
+		                              {
+			                              return a.stimulation > b.stimulation;
+		                              });
+		double mean_stimulation = 0.0;
 		for (const auto& cell : pool)
 		{
 			mean_stimulation += cell.stimulation;
 		}
 		mean_stimulation /= pool.size();
-		if (candidate.stimulation > mean_stimulation)
+		if (mean_stimulation >= stimulation_threshold)
 		{
-			competition_for_resources(pool, clone_rate, max_resources);
-			for (auto& i : pool)
-			{
-				candidate_solution cell;
-				create_cell(cell, i.vector, i.label);
-				mutate_cell(cell, i);
-				i = cell;
-				//pool.push_back(cell);
-			}
+			break;
+		}
+		competition_for_resources(pool, clone_rate, max_resources);
+		const auto survivors = pool.size();
+		for (size_t i = 0; i < survivors; ++i)
+		{
+			candidate_solution cell;
+			create_cell(cell, pool[i].vector, pool[i].label);
+			mutate_cell(cell, pool[i]);
+			pool.push_back(cell);
 		}
 	}
 }
 
 void add_candidate_to_memory_pool(
-	std::vector<candidate_solution>& mem_cells,
+	cell_store& mem_cells,
 	const candidate_solution& candidate,
 	const candidate_solution& best_match)
 {
 	if (candidate.stimulation > best_match.stimulation)
 	{
-		mem_cells.push_back(candidate);
+		add_cell(mem_cells, candidate.vector, candidate.label);
 	}
 }
 
-void classify_pattern(
-	candidate_solution& cell,
-	std::vector<candidate_solution>& mem_cells,
-	const candidate_solution& pattern)
+// Labels of the memory cells nearest to the rows of patterns, spread
+// over the pool. With an index the nearest cell is a k-d tree query;
+// without one it is a distance kernel scan over the store.
+void classify_patterns(
+	std::vector<size_t>& labels,
+	const cell_store& mem_cells,
+	const clever::dataset_view& patterns,
+	const clever::kd_tree* index,
+	clever::thread_pool& pool = clever::default_pool())
 {
-	stimulate(mem_cells, pattern);
-	std::sort(mem_cells.begin(), mem_cells.end(),
-	          [](const candidate_solution& a, const candidate_solution& b)
-	          {
-		          return a.stimulation > b.stimulation;
-	          });
-	cell = mem_cells[0];
+	const size_t run = 64;
+	labels.resize(patterns.rows());
+	pool.parallel_for((patterns.rows() + run - 1) / run, [&](const size_t r)
+	{
+		std::vector<size_t> nearest;
+		std::vector<double> distances;
+		const auto last = std::min((r + 1) * run, patterns.rows());
+		for (size_t i = r * run; i < last; ++i)
+		{
+			size_t best;
+			if (index != nullptr)
+			{
+				index->nearest(patterns.row(i), 1, nearest);
+				best = nearest[0];
+			}
+			else
+			{
+				clever::squared_distances(mem_cells.vectors, patterns.row(i), distances);
+				best = static_cast<size_t>(std::min_element(distances.begin(), distances.end()) - distances.begin());
+			}
+			labels[i] = mem_cells.labels[best];
+		}
+	});
 }
 
-void train_system(std::vector<candidate_solution>& mem_cells,
+void train_system(cell_store& mem_cells,
                   domain_info& domain,
                   const size_t num_patterns,
                   const double clone_rate,
@@ -233,17 +275,16 @@ void train_system(std::vector<candidate_solution>& mem_cells,
                   const double stimulation_threshold,
                   const double max_resources)
 {
+	std::vector<double> distances;
 	for (size_t i = 0; i < num_patterns; ++i)
 	{
 		candidate_solution pattern;
 		generate_random_pattern(pattern, domain);
 		candidate_solution best_match;
-		get_most_stimulated_cell(best_match, mem_cells, pattern);
+		get_most_stimulated_cell(best_match, mem_cells, pattern, distances);
 		if (best_match.label != pattern.label)
 		{
-			candidate_solution candidate;
-			create_cell(candidate, pattern.vector, pattern.label);
-			mem_cells.push_back(candidate);
+			add_cell(mem_cells, pattern.vector, pattern.label);
 		}
 		else if (best_match.stimulation < 1.0)
 		{
@@ -253,22 +294,46 @@ void train_system(std::vector<candidate_solution>& mem_cells,
 			refine_arb_pool(candidate, pool, pattern, stimulation_threshold, clone_rate, max_resources);
 			add_candidate_to_memory_pool(mem_cells, candidate, best_match);
 		}
-		std::cout << " > iter=" << i + 1 << ", mem_cells=" << mem_cells.size() << std::endl;
+		std::cout << " > iter=" << i + 1 << ", mem_cells=" << mem_cells.labels.size() << std::endl;
 	}
 }
 
-size_t test_system(std::vector<candidate_solution>& mem_cells,
+size_t test_system(const cell_store& mem_cells,
                    domain_info& domain,
+                   const bool use_index,
                    const size_t num_trials = 50)
 {
-	size_t correct = 0;
+	const auto n = mem_cells.vectors.dimensions();
+	std::vector<double> patterns(num_trials * n);
+	std::vector<size_t> expected(num_trials);
 	for (size_t i = 0; i < num_trials; ++i)
 	{
 		candidate_solution pattern;
 		generate_random_pattern(pattern, domain);
-		candidate_solution best;
-		classify_pattern(best, mem_cells, pattern);
-		if (best.label == pattern.label)
+		std::copy(pattern.vector.begin(), pattern.vector.end(), patterns.begin() + i * n);
+		expected[i] = pattern.label;
+	}
+
+	std::unique_ptr<clever::kd_tree> index;
+	if (use_index)
+	{
+		std::vector<double> cells(mem_cells.labels.size() * n);
+		for (size_t i = 0; i < mem_cells.labels.size(); ++i)
+		{
+			for (size_t d = 0; d < n; ++d)
+			{
+				cells[i * n + d] = mem_cells.vectors(i, d);
+			}
+		}
+		index.reset(new clever::kd_tree(cells.data(), mem_cells.labels.size(), n));
+	}
+	std::vector<size_t> labels;
+	classify_patterns(labels, mem_cells, clever::dataset_view(patterns.data(), num_trials, n), index.get());
+
+	size_t correct = 0;
+	for (size_t i = 0; i < num_trials; ++i)
+	{
+		if (labels[i] == expected[i])
 		{
 			++correct;
 		}
@@ -277,18 +342,18 @@ size_t test_system(std::vector<candidate_solution>& mem_cells,
 	return correct;
 }
 
-void execute(std::vector<candidate_solution>& mem_cells,
+void execute(cell_store& mem_cells,
              domain_info& domain,
              const size_t num_patterns,
              const double clone_rate,
              const double mutation_rate,
              const double stimulation_threshold,
-             const double max_resources)
+             const double max_resources,
+             const bool use_index)
 {
-	mem_cells.clear();
 	initialize_cells(mem_cells, domain);
 	train_system(mem_cells, domain, num_patterns, clone_rate, mutation_rate, stimulation_threshold, max_resources);
-	test_system(mem_cells, domain);
+	test_system(mem_cells, domain, use_index);
 }
 
 int main(int argc, char* argv[])
@@ -307,8 +372,11 @@ int main(int argc, char* argv[])
 	const double mutation_rate = 2.0;
 	const double stimulation_threshold = 0.9;
 	const double max_resources = 150.0;
+	// classify the test set through a k-d tree over the memory cells
+	const bool use_index = true;
 	// execute the algorithm
-	std::vector<candidate_solution> mem_cells;
-	execute(mem_cells, domain, num_patterns, clone_rate, mutation_rate, stimulation_threshold, max_resources);
+	cell_store mem_cells;
+	execute(mem_cells, domain, num_patterns, clone_rate, mutation_rate, stimulation_threshold, max_resources,
+	        use_index);
 	return 0;
 }
@@ -1,10 +1,11 @@
 #include <vector>
-#include <random>
 #include <algorithm>
 #include <cfloat>
 #include <cmath>
 #include <iostream>
 
+#include "clever_algorithm.h"
+
 using candidate_info = struct candidate_info_t
 {
 	std::vector<double> vector;
@@ -14,26 +15,6 @@ using candidate_info = struct candidate_info_t
 	double sum_nutrients = 0.0;
 };
 
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_real_distribution<> distribution(0.0, 1.0);
-auto random_double = []() { return distribution(generator); };
-
-double objective_function(const std::vector<double>& x)
-{
-	return x[0] * x[0] + x[1] * x[1];
-}
-
-void random_vector(std::vector<double>& x,
-                   const std::vector<std::vector<double>>& min_max)
-{
-	x.resize(min_max.size());
-	for (size_t i = 0; i < x.size(); ++i)
-	{
-		x[i] = min_max[i][0] + random_double() * (min_max[i][1] - min_max[i][0]);
-	}
-}
-
 void generate_random_direction(std::vector<double>& x,
                                const size_t problem_size)
 {
@@ -44,7 +25,7 @@ void generate_random_direction(std::vector<double>& x,
 		bound[0] = -1.0;
 		bound[1] = 1.0;
 	}
-	random_vector(x, bounds);
+	clever::random_vector(x, bounds);
 }
 
 double compute_cell_interaction(const candidate_info& cell,
@@ -84,7 +65,7 @@ void evaluate(candidate_info& cell,
               const double h_rep,
               const double w_rep)
 {
-	cell.cost = objective_function(cell.vector);
+	cell.cost = clever::sphere_function(cell.vector);
 	cell.inter = attract_repel(cell, cells, d_attr, w_attr, h_rep, w_rep);
 	cell.fitness = cell.cost + cell.inter;
 }
@@ -176,7 +157,7 @@ void search(candidate_info& best,
 	std::vector<candidate_info> cells(pop_size);
 	for (auto& cell : cells)
 	{
-		random_vector(cell.vector, search_space);
+		clever::random_vector(cell.vector, search_space);
 	}
 
 	for (size_t l = 0; l < elim_disp_steps; ++l)
@@ -190,6 +171,7 @@ void search(candidate_info& best,
 				best = c_best;
 			}
 			std::cout << "> best fitness=" << best.fitness << ", cost=" << best.cost << std::endl;
+			clever::trace_progress((l * repro_steps + k + 1) * chem_steps * pop_size * (1 + swim_length), best.cost);
 			std::sort(cells.begin(), cells.end(), [](const candidate_info& a, const candidate_info& b)
 			{
 				return a.sum_nutrients < b.sum_nutrients;
@@ -202,9 +184,9 @@ void search(candidate_info& best,
 
 			for (auto& cell : cells)
 			{
-				if (random_double() <= p_eliminate)
+				if (clever::random_uniform() <= p_eliminate)
 				{
-					random_vector(cell.vector, search_space);
+					clever::random_vector(cell.vector, search_space);
 				}
 			}
 		}
@@ -1,9 +1,10 @@
-#include <random>
 #include <algorithm>
 #include <cfloat>
 #include <cmath>
 #include <iostream>
 
+#include "clever_algorithm.h"
+
 
 using candidate_info = struct candidate_info_t
 {
@@ -11,88 +12,64 @@ using candidate_info = struct candidate_info_t
 	double fitness = DBL_MAX;
 };
 
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_real_distribution<> distribution(0.0, 1.0);
-auto random_double = []() { return distribution(generator); };
-
-double objective_function(const std::vector<double>& x)
-{
-	return x[0] * x[0] + x[1] * x[1];
-}
-
-void random_vector(std::vector<double>& x,
-                   const std::vector<std::vector<double>>& min_max)
-{
-	x.resize(min_max.size());
-	for (size_t i = 0; i < x.size(); ++i)
-	{
-		x[i] = min_max[i][0] + random_double() * (min_max[i][1] - min_max[i][0]);
-	}
-}
-
-void create_random_bee(std::vector<double>& x,
-                       const std::vector<std::vector<double>>& search_space)
+// A group of bees in structure-of-arrays form: row d of vectors holds
+// dimension d of every bee, so a whole patch is created in row sweeps.
+using colony_info = struct colony_info_t
 {
-	random_vector(x, search_space);
-}
+	clever::candidate_batch vectors;
+	std::vector<double> fitness;
+};
 
-void create_neigh_bee(candidate_info& bee,
-                      const std::vector<double>& site,
-                      const double patch_size,
-                      const std::vector<std::vector<double>>& search_space)
+// every bee of neigh lands within patch_size of site
+void create_neigh_bees(clever::candidate_batch& neigh,
+                       const std::vector<double>& site,
+                       const double patch_size,
+                       const std::vector<std::vector<double>>& search_space,
+                       std::vector<double>& draws)
 {
-	bee.vector.clear();
-	for (size_t i = 0; i < site.size(); ++i)
+	draws.resize(2 * neigh.size());
+	for (size_t d = 0; d < neigh.dimensions(); ++d)
 	{
-		auto v = site[i];
-		v = random_double() < 0.5 ? v + random_double() * patch_size : v - random_double() * patch_size;
-		if (v < search_space[i][0])
-		{
-			v = search_space[i][0];
-		}
-		if (v > search_space[i][1])
+		clever::default_engine().fill_uniform(draws);
+		const auto row = neigh.dimension(d);
+		for (size_t i = 0; i < neigh.size(); ++i)
 		{
-			v = search_space[i][1];
+			const auto step = draws[2 * i + 1] * patch_size;
+			row[i] = draws[2 * i] < 0.5 ? site[d] + step : site[d] - step;
 		}
-		bee.vector.push_back(v);
 	}
+	clever::clamp_to_bounds(neigh, search_space);
 }
 
-bool cmp_fitness(const candidate_info& lhs, const candidate_info& rhs)
+size_t best_bee(const colony_info& bees)
 {
-	return lhs.fitness < rhs.fitness;
+	return static_cast<size_t>(std::min_element(bees.fitness.begin(), bees.fitness.end()) - bees.fitness.begin());
 }
 
-void search_neigh(candidate_info& best,
-                  const candidate_info& parent,
+// the best bee of a patch of neigh_size around the site becomes bee i of next_gen
+void search_neigh(colony_info& next_gen, const size_t i,
+                  const std::vector<double>& site,
+                  colony_info& neigh,
                   const size_t neigh_size,
                   const double patch_size,
-                  const std::vector<std::vector<double>>& search_space)
+                  const std::vector<std::vector<double>>& search_space,
+                  std::vector<double>& draws)
 {
-	std::vector<candidate_info> neigh;
-	for (size_t i = 0; i < neigh_size; ++i)
-	{
-		candidate_info bee;
-		create_neigh_bee(bee, parent.vector, patch_size, search_space);
-		bee.fitness = objective_function(bee.vector);
-		neigh.push_back(bee);
-	}
-	std::sort(neigh.begin(), neigh.end(), cmp_fitness);
-	best = neigh[0];
+	neigh.vectors.resize(neigh_size, site.size());
+	create_neigh_bees(neigh.vectors, site, patch_size, search_space, draws);
+	clever::sphere_batch(neigh.vectors, neigh.fitness);
+	const auto best = best_bee(neigh);
+	next_gen.vectors.copy(i, neigh.vectors, best);
+	next_gen.fitness[i] = neigh.fitness[best];
 }
 
-void create_scout_bees(std::vector<candidate_info>& bees,
+void create_scout_bees(colony_info& scouts,
                        const std::vector<std::vector<double>>& search_space,
                        const size_t num_scouts)
 {
-	for (size_t i = 0; i < num_scouts; ++i)
-	{
-		candidate_info bee;
-		create_random_bee(bee.vector, search_space);
-		bee.fitness = objective_function(bee.vector);
-		bees.push_back(bee);
-	}
+	scouts.vectors.resize(num_scouts, search_space.size());
+	clever::random_batch(scouts.vectors, search_space);
+	clever::sphere_batch(scouts.vectors, scouts.fitness);
 }
 
 void search(candidate_info& best,
@@ -105,36 +82,37 @@ void search(candidate_info& best,
             const size_t e_bees,
             const size_t o_bees)
 {
-	std::vector<candidate_info> pop(num_bees);
-	for (auto& bee : pop)
-	{
-		create_random_bee(bee.vector, search_space);
-		bee.fitness = objective_function(bee.vector);
-	}
+	colony_info pop, next_gen, neigh, scouts;
+	create_scout_bees(pop, search_space, num_bees);
+	next_gen = pop;
+	std::vector<size_t> order;
+	std::vector<double> site, draws;
+	const auto evaluations_per_gen = elite_sites * e_bees + (num_sites - elite_sites) * o_bees + num_bees - num_sites;
 	for (size_t gen = 0; gen < max_gens; ++gen)
 	{
-		std::sort(pop.begin(), pop.end(), cmp_fitness);
-		if (gen == 0 || pop[0].fitness < best.fitness)
+		clever::order_by_cost(order, pop.fitness);
+		if (gen == 0 || pop.fitness[order[0]] < best.fitness)
 		{
-			best = pop[0];
+			pop.vectors.get(order[0], best.vector);
+			best.fitness = pop.fitness[order[0]];
 		}
-		std::vector<candidate_info> next_gen;
 		for (size_t i = 0; i < num_sites; ++i)
 		{
-			auto& parent = pop[i];
+			pop.vectors.get(order[i], site);
 			const auto neigh_size = i < elite_sites ? e_bees : o_bees;
-			candidate_info tmp;
-			search_neigh(tmp, parent, neigh_size, patch_size, search_space);
-			next_gen.push_back(tmp);
+			search_neigh(next_gen, i, site, neigh, neigh_size, patch_size, search_space, draws);
 		}
-		std::vector<candidate_info> scouts;
 		create_scout_bees(scouts, search_space, num_bees - num_sites);
-		pop.clear();
-		pop.insert(pop.end(), next_gen.begin(), next_gen.end());
-		pop.insert(pop.end(), scouts.begin(), scouts.end());
+		for (size_t i = num_sites; i < num_bees; ++i)
+		{
+			next_gen.vectors.copy(i, scouts.vectors, i - num_sites);
+			next_gen.fitness[i] = scouts.fitness[i - num_sites];
+		}
+		std::swap(pop, next_gen);
 		patch_size = patch_size * 0.95;
 		std::cout << " > it: " << gen << " patch size: " << patch_size
 			<< "f = " << best.fitness << std::endl;
+		clever::trace_progress(num_bees + gen * evaluations_per_gen, best.fitness);
 	}
 }
 
@@ -1,15 +1,11 @@
 #include <vector>
-#include <random>
 #include <algorithm>
 #include <cfloat>
 #include <cmath>
 #include <iostream>
 
+#include "clever_algorithm.h"
 
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_real_distribution<> distribution(0.0, 1.0);
-auto random_double = []() { return distribution(generator); };
 
 using candidate_solution = struct candidate_solution_st
 {
@@ -19,16 +15,6 @@ using candidate_solution = struct candidate_solution_st
 	double affinity = 0.0;
 };
 
-double objective_function(const std::vector<double>& x)
-{
-	double sum = 0.0;
-	for (auto& xi : x)
-	{
-		sum += xi * xi;
-	}
-	return sum;
-}
-
 void decode(std::vector<double>& vector,
             const std::string& bit_string,
             const std::vector<std::vector<double>>& search_space,
@@ -55,14 +41,19 @@ void decode(std::vector<double>& vector,
 	}
 }
 
+// a candidate's vector is only decoded when its fitness is not in the cache
 void evaluate(std::vector<candidate_solution>& population,
               const std::vector<std::vector<double>>& search_space,
-              const size_t bits_per_param)
+              const size_t bits_per_param,
+              clever::string_fitness_cache& cache)
 {
 	for (auto& candidate : population)
 	{
-		decode(candidate.vector, candidate.bit_string, search_space, bits_per_param);
-		candidate.fitness = objective_function(candidate.vector);
+		candidate.fitness = cache.get(candidate.bit_string, [&]()
+		{
+			decode(candidate.vector, candidate.bit_string, search_space, bits_per_param);
+			return clever::sphere_function(candidate.vector);
+		});
 	}
 }
 
@@ -71,7 +62,7 @@ void random_bit_string(std::string& bit_string, const size_t num_bits)
 	bit_string.clear();
 	for (size_t i = 0; i < num_bits; ++i)
 	{
-		bit_string.push_back(random_double() < 0.5 ? '1' : '0');
+		bit_string.push_back(clever::random_uniform() < 0.5 ? '1' : '0');
 	}
 }
 
@@ -83,7 +74,7 @@ void point_mutation(std::string& child,
 
 	for (const auto& item : bit_string)
 	{
-		tmp.push_back(random_double() < rate ? (item == '1' ? '0' : '1') : item);
+		tmp.push_back(clever::random_uniform() < rate ? (item == '1' ? '0' : '1') : item);
 	}
 	child = tmp;
 }
@@ -145,7 +136,8 @@ void random_insertion(std::vector<candidate_solution>& new_pop,
                       const std::vector<std::vector<double>>& search_space,
                       std::vector<candidate_solution>& pop,
                       const size_t num_rand,
-                      const size_t bits_per_param)
+                      const size_t bits_per_param,
+                      clever::string_fitness_cache& cache)
 {
 	std::vector<candidate_solution> tmp_pop;
 	if (num_rand == 0)
@@ -158,7 +150,7 @@ void random_insertion(std::vector<candidate_solution>& new_pop,
 	{
 		random_bit_string(r.bit_string, bits_per_param * search_space.size());
 	}
-	evaluate(rand_pop, search_space, bits_per_param);
+	evaluate(rand_pop, search_space, bits_per_param, cache);
 	tmp_pop.resize(pop.size() + rand_pop.size());
 	std::copy(pop.begin(), pop.end(), tmp_pop.begin());
 	std::copy(rand_pop.begin(), rand_pop.end(), tmp_pop.begin() + pop.size());
@@ -176,6 +168,7 @@ void search(candidate_solution& best,
             const size_t pop_size,
             const double clone_factor,
             const size_t num_rand,
+            clever::string_fitness_cache& cache,
             const size_t bits_per_param = 16)
 {
 	std::vector<candidate_solution> pop(pop_size);
@@ -183,24 +176,26 @@ void search(candidate_solution& best,
 	{
 		random_bit_string(p.bit_string, bits_per_param * search_space.size());
 	}
-	evaluate(pop, search_space, bits_per_param);
+	evaluate(pop, search_space, bits_per_param, cache);
 	std::sort(pop.begin(), pop.end(), [](const candidate_solution& a, const candidate_solution& b)
 	{
 		return a.fitness < b.fitness;
 	});
 	best = pop[0];
+	auto evaluations = pop_size;
 	for (size_t gen = 0; gen < max_gens; ++gen)
 	{
 		std::vector<candidate_solution> clones;
 		clone_and_hyper_mutate(clones, pop, clone_factor);
-		evaluate(clones, search_space, bits_per_param);
+		evaluate(clones, search_space, bits_per_param, cache);
+		evaluations += clones.size() + num_rand;
 		std::copy(clones.begin(), clones.end(), std::back_inserter(pop));
 		std::sort(pop.begin(), pop.end(), [](const candidate_solution& a, const candidate_solution& b)
 		{
 			return a.fitness < b.fitness;
 		});
 		pop.resize(pop_size);
-		random_insertion(pop, search_space, pop, num_rand, bits_per_param);
+		random_insertion(pop, search_space, pop, num_rand, bits_per_param, cache);
 		std::vector<candidate_solution> new_pop;
 		std::copy(pop.begin(), pop.end(), std::back_inserter(new_pop));
 		new_pop.push_back(best);
@@ -209,12 +204,14 @@ void search(candidate_solution& best,
 			return a.fitness < b.fitness;
 		});
 		best = new_pop[0];
+		decode(best.vector, best.bit_string, search_space, bits_per_param);
 		std::cout << "Generation: " << gen + 1 << " Best: " << best.fitness;
 		for (const auto& v : best.vector)
 		{
 			std::cout << " " << v;
 		}
 		std::cout << std::endl;
+		clever::trace_progress(evaluations, best.fitness);
 	}
 }
 
@@ -233,9 +230,13 @@ int main(int argc, char* argv[])
 	const size_t pop_size = 100;
 	const double clone_factor = 0.1;
 	const size_t num_rand = 2;
+	// fitness values remembered for repeated bit strings, 0 turns the cache off
+	const size_t cache_size = 4096;
 	// execute the algorithm
 	candidate_solution best;
-	search(best, search_space, max_gens, pop_size, clone_factor, num_rand);
+	clever::string_fitness_cache cache(cache_size);
+	search(best, search_space, max_gens, pop_size, clone_factor, num_rand, cache);
+	std::cout << "Fitness cache: " << cache.hits() << " hits, " << cache.misses() << " misses" << std::endl;
 	std::cout << "done! Solution: f = " << best.fitness;
 	for (auto& v : best.vector)
 	{
@@ -1,57 +1,26 @@
 #include <iostream>
-#include <random>
 #include <vector>
-#include <string>
 #include <algorithm>
 #include <cfloat>
 
-
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_real_distribution<> distribution(0.0, 1.0);
-auto random_ = []() { return distribution(generator); };
+#include "clever_algorithm.h"
 
 
 using candidate_solution = struct candidate_solution_st
 {
-	std::string bit_string;
+	clever::bit_string bit_string;
 	double fitness = DBL_MIN;
 };
 
 
-double onemax(const std::string& bit_string)
-{
-	double sum = 0.0;
-	for (auto& item : bit_string)
-	{
-		if (item == '1')
-		{
-			sum++;
-		}
-	}
-	return sum;
-}
-
-
-void random_bit_string(std::string& bit_string, const size_t size)
+void generate_candidate(candidate_solution& candidate, const std::vector<double>& vector,
+                        clever::fitness_cache& cache)
 {
-	bit_string.clear();
-	for (size_t i = 0; i < size; ++i)
+	clever::sample_bit_string(candidate.bit_string, vector);
+	candidate.fitness = cache.get(candidate.bit_string, [&]()
 	{
-		bit_string.push_back(random_() < 0.5 ? '1' : '0');
-	}
-}
-
-
-void generate_candidate(candidate_solution& candidate, const std::vector<double>& vector)
-{
-	candidate.bit_string.resize(vector.size());
-	for (size_t i = 0; i < vector.size(); ++i)
-	{
-		const auto& p = vector[i];
-		candidate.bit_string[i] = random_() < p ? '1' : '0';
-	}
-	candidate.fitness = onemax(candidate.bit_string);
+		return clever::onemax(candidate.bit_string);
+	});
 }
 
 
@@ -64,7 +33,7 @@ void update_vector(std::vector<double>& vector,
 	{
 		if (winner.bit_string[i] != loser.bit_string[i])
 		{
-			if (winner.bit_string[i] == '1')
+			if (winner.bit_string[i])
 			{
 				vector[i] += 1.0 / pop_size;
 			}
@@ -80,7 +49,8 @@ void update_vector(std::vector<double>& vector,
 void search(candidate_solution& best,
             const size_t num_bits,
             const size_t max_iterations,
-            const size_t pop_size)
+            const size_t pop_size,
+            clever::fitness_cache& cache)
 {
 	std::vector<double> vector(num_bits);
 	for (auto& v : vector)
@@ -90,8 +60,8 @@ void search(candidate_solution& best,
 	for (size_t iter = 0; iter < max_iterations; ++iter)
 	{
 		candidate_solution c1, c2;
-		generate_candidate(c1, vector);
-		generate_candidate(c2, vector);
+		generate_candidate(c1, vector, cache);
+		generate_candidate(c2, vector, cache);
 
 		candidate_solution winner = c1.fitness > c2.fitness ? c1 : c2;
 		candidate_solution loser = c1.fitness > c2.fitness ? c2 : c1;
@@ -111,6 +81,7 @@ void search(candidate_solution& best,
 		std::cout << " > gen " << iter + 1 << ", f = "
 			<< best.fitness << ", b = "
 			<< best.bit_string << std::endl;
+		clever::trace_progress(2 * (iter + 1), best.fitness);
 
 		if (static_cast<size_t>(best.fitness) == num_bits)
 		{
@@ -127,9 +98,14 @@ int main(int argc, char* argv[])
 	// algorithm configuration
 	const size_t max_iter = 200;
 	const size_t pop_size = 20;
+	// fitness values remembered for repeated samples, 0 turns the cache off;
+	// they become common as the probability vector converges
+	const size_t cache_size = 4096;
 	// execute the algorithm
 	candidate_solution best;
-	search(best, num_bits, max_iter, pop_size);
+	clever::fitness_cache cache(cache_size);
+	search(best, num_bits, max_iter, pop_size, cache);
+	std::cout << "Fitness cache: " << cache.hits() << " hits, " << cache.misses() << " misses" << std::endl;
 
 	std::cout << "Done! Solution: f = " << best.fitness;
 	std::cout << ", b = " << best.bit_string << std::endl;
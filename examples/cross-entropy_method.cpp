@@ -4,56 +4,16 @@
 #include <vector>
 #include <algorithm>
 #include <iostream>
-#include <cstdlib>
 
+#include "clever_algorithm.h"
 
-using candidate_info = struct candidate_info_t
-{
-	std::vector<double> vector;
-	double cost = 0.0;
-};
-
-
-double random(const double min, const double max)
-{
-	const double range = max - min;
-	const double div = RAND_MAX / range;
-	return min + (rand() / div);
-}
 
-
-double objective_function(const std::vector<double>& x)
-{
-	double result = 0.0;
-	for (const double i : x)
-	{
-		result += i * i;
-	}
-	return result;
-}
+using candidate_info = clever::real_solution;
 
 
 double random_variable(const double min, const double max)
 {
-	return random(min, max);
-}
-
-
-double random_gaussian(const double mean = 0.0, const double std_dev = 1.0)
-{
-	double u1 = 2.0 * random(0.0, 1.0) - 1.0;
-	double u2 = 2.0 * random(0.0, 1.0) - 1.0;
-	double w = u1 * u1 + u2 * u2;
-
-	while (w >= 1.0)
-	{
-		u1 = 2.0 * random(0.0, 1.0) - 1.0;
-		u2 = 2.0 * random(0.0, 1.0) - 1.0;
-		w = u1 * u1 + u2 * u2;
-	}
-
-	w = sqrt((-2.0 * log(w)) / w);
-	return mean + (u2 * w) * std_dev;
+	return clever::random_uniform(min, max);
 }
 
 
@@ -61,11 +21,11 @@ void generate_sample(std::vector<double>& x,
                      const std::vector<std::vector<double>>& search_space,
                      const std::vector<double>& means, const std::vector<double>& std_devs)
 {
-	x.clear();
 	x.resize(search_space.size());
+	clever::default_engine().fill_gaussian(x);
 	for (size_t i = 0; i < x.size(); i++)
 	{
-		x[i] = random_gaussian(means[i], std_devs[i]);
+		x[i] = means[i] + std_devs[i] * x[i];
 		if (x[i] < search_space[i][0])
 		{
 			x[i] = search_space[i][0];
@@ -128,13 +88,21 @@ void search(candidate_info& best, const std::vector<std::vector<double>>& search
 		means[i] = random_variable(search_space[i][0], search_space[i][1]);
 		std_devs[i] = search_space[i][1] - search_space[i][0];
 	}
+	// the samples are evaluated together, laid out for the SIMD objective
+	clever::candidate_batch batch(num_samples, search_space.size());
+	std::vector<double> costs;
 	for (size_t iter = 0; iter < max_iterations; ++iter)
 	{
 		std::vector<candidate_info> samples(num_samples);
-		for (auto& sample : samples)
+		for (size_t i = 0; i < samples.size(); ++i)
+		{
+			generate_sample(samples[i].vector, search_space, means, std_devs);
+			batch.set(i, samples[i].vector);
+		}
+		clever::sphere_batch(batch, costs);
+		for (size_t i = 0; i < samples.size(); ++i)
 		{
-			generate_sample(sample.vector, search_space, means, std_devs);
-			sample.cost = objective_function(sample.vector);
+			samples[i].cost = costs[i];
 		}
 		std::sort(samples.begin(), samples.end(), cmp_cost);
 		if (samples[0].cost < best.cost || iter == 0)
@@ -148,6 +116,7 @@ void search(candidate_info& best, const std::vector<std::vector<double>>& search
 		}
 		update_distribution(selected, learning_rate, means, std_devs);
 		std::cout << "Iteration: " << iter << " Best: " << best.cost << std::endl;
+		clever::trace_progress((iter + 1) * num_samples, best.cost);
 	}
 }
 
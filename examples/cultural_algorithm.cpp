@@ -1,15 +1,10 @@
 #include <iostream>
-#include <random>
 #include <vector>
 #include <string>
 #include <algorithm>
 #include <cfloat>
 
-
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_real_distribution<> distribution(0.0, 1.0);
-auto random_ = []() { return distribution(generator); };
+#include "clever_algorithm.h"
 
 
 using candidate_solution = struct candidate_solution_st
@@ -25,36 +20,6 @@ using belief_info = struct belief_info_st
 	candidate_solution situational;
 };
 
-double objective_function(const std::vector<double>& vector)
-{
-	double sum = 0.0;
-	for (const double& i : vector)
-	{
-		sum += i * i;
-	}
-
-	return sum;
-}
-
-
-double rand_in_bounds(const double min, const double max)
-{
-	return min + (max - min) * random_();
-}
-
-
-void random_vector(std::vector<double>& vector,
-                   const std::vector<std::vector<double>>& search_space)
-{
-	vector.clear();
-	vector.resize(search_space.size());
-	for (size_t i = 0; i < vector.size(); ++i)
-	{
-		vector[i] = rand_in_bounds(search_space[i][0], search_space[i][1]);
-	}
-}
-
-
 void mutate_with_inf(std::vector<double>& vector,
                      const candidate_solution& candidate,
                      const belief_info& beliefs,
@@ -65,7 +30,7 @@ void mutate_with_inf(std::vector<double>& vector,
 	for (size_t i = 0; i < candidate.vector.size(); ++i)
 	{
 		// auto& c = candidate.vector[i];
-		vector[i] = rand_in_bounds(beliefs.normative[i][0], beliefs.normative[i][1]);
+		vector[i] = clever::rand_in_bounds(beliefs.normative[i][0], beliefs.normative[i][1]);
 		if (vector[i] < minmax[i][0])
 			vector[i] = minmax[i][0];
 		if (vector[i] > minmax[i][1])
@@ -77,11 +42,11 @@ void mutate_with_inf(std::vector<double>& vector,
 void binary_tournament(candidate_solution& candidate,
                        const std::vector<candidate_solution>& pop)
 {
-	auto i = static_cast<size_t>((pop.size() - 1) * random_());
-	auto j = static_cast<size_t>((pop.size() - 1) * random_());
+	auto i = static_cast<size_t>((pop.size() - 1) * clever::random_uniform());
+	auto j = static_cast<size_t>((pop.size() - 1) * clever::random_uniform());
 	while (j == i)
 	{
-		j = static_cast<size_t>((pop.size() - 1) * random_());
+		j = static_cast<size_t>((pop.size() - 1) * clever::random_uniform());
 	}
 	candidate = pop[i].fitness < pop[j].fitness ? pop[i] : pop[j];
 }
@@ -156,7 +121,7 @@ void search(candidate_solution& best,
 	std::vector<candidate_solution> pop(pop_size);
 	for (auto& item : pop)
 	{
-		random_vector(item.vector, search_space);
+		clever::random_vector(item.vector, search_space);
 	}
 	belief_info belief_space;
 	initialize_beliefspace(belief_space, search_space);
@@ -164,7 +129,7 @@ void search(candidate_solution& best,
 	// evaluate
 	for (auto& c : pop)
 	{
-		c.fitness = objective_function(c.vector);
+		c.fitness = clever::sphere_function(c.vector);
 	}
 	std::sort(pop.begin(), pop.end(), cmp_fitness);
 	best = pop[0];
@@ -183,7 +148,7 @@ void search(candidate_solution& best,
 		// evaluate
 		for (auto& child : children)
 		{
-			child.fitness = objective_function(child.vector);
+			child.fitness = clever::sphere_function(child.vector);
 		}
 		std::sort(children.begin(), children.end(), cmp_fitness);
 		best = children[0];
@@ -221,6 +186,7 @@ void search(candidate_solution& best,
 
 		std::cout << " > generation " << gen + 1 << ", fitness = "
 			<< belief_space.situational.fitness << std::endl;
+		clever::trace_progress((gen + 2) * pop_size, belief_space.situational.fitness);
 	}
 
 	best = belief_space.situational;
@@ -240,7 +206,7 @@ int main(int argc, char* argv[])
 	// algorithm configuration
 	const size_t max_gens = 200;
 	const size_t pop_size = 100;
-	const size_t num_accepted = static_cast<size_t>((pop_size * 0.2) * random_());
+	const size_t num_accepted = static_cast<size_t>((pop_size * 0.2) * clever::random_uniform());
 	// execute the algorithm
 	candidate_solution best;
 	search(best, max_gens, bounds, pop_size, num_accepted);
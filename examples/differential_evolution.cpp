@@ -1,133 +1,151 @@
 #include <iostream>
-#include <random>
 #include <vector>
 #include <string>
 #include <algorithm>
 
+#include "clever_algorithm.h"
 
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_real_distribution<> distribution(0.0, 1.0);
-auto random_ = []() { return distribution(generator); };
 
+using candidate_solution = clever::real_solution;
 
-using candidate_solution = struct candidate_solution_t
+
+// The population in structure-of-arrays form: row d of vectors holds
+// dimension d of every member, so the operators below sweep whole rows.
+using population_info = struct population_info_t
 {
-	std::vector<double> vector;
-	double cost = 0;
+	clever::candidate_batch vectors;
+	std::vector<double> costs;
 };
 
 
-double objective_function(const std::vector<double>& vector)
+// Parents gathered for one generation: p1[i], p2[i], p3[i] are the donors
+// of child i, cut[i] the dimension it always takes from the donors; draws
+// holds one row of crossover draws.
+using parents_info = struct parents_info_t
 {
-	double sum = 0.0;
-	for (const double val : vector)
+	clever::candidate_batch p1, p2, p3;
+	std::vector<size_t> cut;
+	std::vector<double> draws;
+};
+
+
+void select_parents(size_t& p1, size_t& p2, size_t& p3, const size_t pop_size, const size_t current)
+{
+	p1 = clever::random_index(pop_size);
+	p2 = clever::random_index(pop_size);
+	p3 = clever::random_index(pop_size);
+	while (p1 == current)
 	{
-		sum += val * val;
+		p1 = clever::random_index(pop_size);
 	}
 
-	return sum;
-}
-
+	while (p2 == current || p2 == p1)
+	{
+		p2 = clever::random_index(pop_size);
+	}
 
-void random_vector(std::vector<double>& arr, const std::vector<std::vector<double>>& minmax)
-{
-	arr.clear();
-	for (const auto& item : minmax)
+	while (p3 == current || p3 == p2 || p3 == p1)
 	{
-		arr.push_back(item[0] + (item[1] - item[0]) * random_());
+		p3 = clever::random_index(pop_size);
 	}
 }
 
 
-void de_rand_1_bin(candidate_solution& sample, const candidate_solution& p0,
-                   const candidate_solution& p1, const candidate_solution& p2,
-                   const candidate_solution& p3, const double f, const double cr,
+// DE/rand/1/bin for the whole population at once: child = p0, except for
+// the dimensions taken from p3 + f * (p1 - p2)
+void de_rand_1_bin(clever::candidate_batch& children, const clever::candidate_batch& pop,
+                   parents_info& parents, const double f, const double cr,
                    const std::vector<std::vector<double>>& search_space)
 {
-	sample.vector.clear();
-	sample.vector.resize(p0.vector.size());
-	const size_t cut = static_cast<size_t>((sample.vector.size() - 2) * random_()) + 1;
-	for (size_t i = 0; i < sample.vector.size(); ++i)
+	const auto size = pop.size();
+	const auto dims = pop.dimensions();
+	std::vector<size_t> i1(size), i2(size), i3(size);
+	parents.cut.resize(size);
+	for (size_t i = 0; i < size; ++i)
+	{
+		select_parents(i1[i], i2[i], i3[i], size, i);
+		parents.cut[i] = static_cast<size_t>((dims - 2) * clever::random_uniform()) + 1;
+	}
+	parents.p1.gather(pop, i1);
+	parents.p2.gather(pop, i2);
+	parents.p3.gather(pop, i3);
+
+	children.resize(size, dims);
+	parents.draws.resize(size);
+	for (size_t d = 0; d < dims; ++d)
 	{
-		sample.vector[i] = p0.vector[i];
-		if (i == cut || random_() < cr)
+		clever::default_engine().fill_uniform(parents.draws);
+		const auto p0 = pop.dimension(d);
+		const auto p1 = parents.p1.dimension(d);
+		const auto p2 = parents.p2.dimension(d);
+		const auto p3 = parents.p3.dimension(d);
+		const auto child = children.dimension(d);
+		for (size_t i = 0; i < size; ++i)
 		{
-			auto v = p3.vector[i] + f * (p1.vector[i] - p2.vector[i]);
-			if (v < search_space[i][0])
-				v = search_space[i][0];
-			if (v > search_space[i][1])
-				v = search_space[i][1];
-			sample.vector[i] = v;
+			const bool crossed = d == parents.cut[i] || parents.draws[i] < cr;
+			child[i] = crossed ? p3[i] + f * (p1[i] - p2[i]) : p0[i];
 		}
 	}
+	clever::clamp_to_bounds(children, search_space);
 }
 
 
-void select_parents(size_t& p1, size_t& p2, size_t& p3,
-                    const std::vector<candidate_solution>& pop, const size_t current)
+// every member is replaced by its child when the child is no worse
+void select_population(population_info& pop, const population_info& children)
 {
-	p1 = static_cast<size_t>((pop.size() - 1) * random_());
-	p2 = static_cast<size_t>((pop.size() - 1) * random_());
-	p3 = static_cast<size_t>((pop.size() - 1) * random_());
-	while (p1 == current)
+	for (size_t d = 0; d < pop.vectors.dimensions(); ++d)
 	{
-		p1 = static_cast<size_t>((pop.size() - 1) * random_());
-	}
-
-	while (p2 == current || p2 == p1)
-	{
-		p2 = static_cast<size_t>((pop.size() - 1) * random_());
+		const auto child = children.vectors.dimension(d);
+		const auto row = pop.vectors.dimension(d);
+		for (size_t i = 0; i < pop.vectors.size(); ++i)
+		{
+			row[i] = children.costs[i] <= pop.costs[i] ? child[i] : row[i];
+		}
 	}
-
-	while (p3 == current || p3 == p2 || p3 == p1)
+	for (size_t i = 0; i < pop.costs.size(); ++i)
 	{
-		p3 = static_cast<size_t>((pop.size() - 1) * random_());
+		pop.costs[i] = std::min(pop.costs[i], children.costs[i]);
 	}
 }
 
 
-void create_children(std::vector<candidate_solution>& children,
-                     const std::vector<candidate_solution>& pop,
-                     const std::vector<std::vector<double>>& minmax,
-                     const double f, const double cr)
+// A trial vector of the steady-state mode and the member it competes with.
+using trial_info = struct trial_info_t
 {
-	children.clear();
-	for (size_t i = 0; i < pop.size(); ++i)
-	{
-		auto pop0 = pop[i];
-		size_t p1, p2, p3;
-		select_parents(p1, p2, p3, pop, i);
-		candidate_solution child;
-		de_rand_1_bin(child, pop0, pop[p1], pop[p2], pop[p3], f, cr, minmax);
-		children.push_back(child);
-	}
-}
+	std::vector<double> vector;
+	double cost = 0.0;
+	size_t target = 0;
+};
 
 
-void select_population(std::vector<candidate_solution>& pop,
-                       const std::vector<candidate_solution>& parents,
-                       const std::vector<candidate_solution>& children)
+// DE/rand/1/bin for one member, the same operator as de_rand_1_bin
+void de_rand_1_bin(trial_info& trial, const population_info& pop, const size_t target, const double f,
+                   const double cr, const std::vector<std::vector<double>>& search_space)
 {
-	std::vector<candidate_solution> tmp_pop;
-	tmp_pop.resize(parents.size());
-	for (size_t i = 0; i < parents.size(); ++i)
+	const auto dims = pop.vectors.dimensions();
+	size_t p1, p2, p3;
+	select_parents(p1, p2, p3, pop.vectors.size(), target);
+	const auto cut = static_cast<size_t>((dims - 2) * clever::random_uniform()) + 1;
+	trial.target = target;
+	trial.vector.resize(dims);
+	for (size_t d = 0; d < dims; ++d)
 	{
-		tmp_pop[i] = children[i].cost <= parents[i].cost ? children[i] : parents[i];
+		const bool crossed = clever::random_uniform() < cr || d == cut;
+		const auto& v = pop.vectors;
+		trial.vector[d] = crossed ? v(p3, d) + f * (v(p1, d) - v(p2, d)) : v(target, d);
 	}
-
-	pop = tmp_pop;
+	clever::clamp_to_bounds(trial.vector, search_space);
 }
 
 
-bool cmp(const candidate_solution& c_l, const candidate_solution& c_r)
+void update_best(candidate_solution& best, const population_info& pop)
 {
-	if (c_l.cost < c_r.cost)
+	const auto i = static_cast<size_t>(std::min_element(pop.costs.begin(), pop.costs.end()) - pop.costs.begin());
+	if (pop.costs[i] < best.cost)
 	{
-		return true;
+		pop.vectors.get(i, best.vector);
+		best.cost = pop.costs[i];
 	}
-
-	return false;
 }
 
 
@@ -135,34 +153,73 @@ void search(candidate_solution& best, const size_t max_gens,
             const std::vector<std::vector<double>>& search_space,
             const size_t pop_size, const double f, const double cr)
 {
-	std::vector<candidate_solution> pop;
-	pop.resize(pop_size);
-	for (auto& item : pop)
+	population_info pop;
+	pop.vectors.resize(pop_size, search_space.size());
+	clever::random_batch(pop.vectors, search_space);
+	clever::sphere_batch(pop.vectors, pop.costs);
+	update_best(best, pop);
+
+	population_info children;
+	parents_info parents;
+	for (size_t gen = 0; gen < max_gens; ++gen)
 	{
-		random_vector(item.vector, search_space);
-		item.cost = objective_function(item.vector);
+		de_rand_1_bin(children.vectors, pop.vectors, parents, f, cr, search_space);
+		clever::sphere_batch(children.vectors, children.costs);
+
+		select_population(pop, children);
+		update_best(best, pop);
+		std::cout << " > gen " << gen << ", best: " << best.cost << std::endl;
+		clever::trace_progress((gen + 2) * pop_size, best.cost);
 	}
+}
 
-	std::sort(pop.begin(), pop.end(), cmp);
-	best = pop[0];
 
-	for (size_t gen = 0; gen < max_gens; ++gen)
+// Asynchronous steady-state DE for objectives whose evaluation time varies:
+// the members take turns as targets, workers evaluate trials while the next
+// ones are built, and a trial replaces its target as soon as its cost is
+// known, so later trials already draw on it. The budget is max_gens *
+// pop_size trials.
+void steady_state_search(candidate_solution& best, const size_t max_gens,
+                         const std::vector<std::vector<double>>& search_space,
+                         const size_t pop_size, const double f, const double cr)
+{
+	population_info pop;
+	pop.vectors.resize(pop_size, search_space.size());
+	clever::random_batch(pop.vectors, search_space);
+	clever::sphere_batch(pop.vectors, pop.costs);
+	update_best(best, pop);
+
+	clever::evaluation_queue<trial_info> queue([](trial_info& trial)
+	{
+		trial.cost = clever::sphere_function(trial.vector);
+	});
+	size_t next_target = 0;
+	size_t evaluations = pop_size;
+	clever::steady_state(queue, max_gens * pop_size, [&]()
 	{
-		std::vector<candidate_solution> children;
-		create_children(children, pop, search_space, f, cr);
-		for (auto& item : children)
+		trial_info trial;
+		de_rand_1_bin(trial, pop, next_target, f, cr, search_space);
+		next_target = (next_target + 1) % pop_size;
+		return trial;
+	}, [&](const trial_info& trial)
+	{
+		if (trial.cost <= pop.costs[trial.target])
 		{
-			item.cost = objective_function(item.vector);
+			pop.vectors.set(trial.target, trial.vector);
+			pop.costs[trial.target] = trial.cost;
 		}
-
-		select_population(pop, pop, children);
-		std::sort(pop.begin(), pop.end(), cmp);
-		if (pop[0].cost < best.cost)
+		if (trial.cost < best.cost)
 		{
-			best = pop[0];
+			best.vector = trial.vector;
+			best.cost = trial.cost;
 		}
-		std::cout << " > gen " << gen << ", best: " << best.cost << std::endl;
-	}
+		if (++evaluations % pop_size == 0)
+		{
+			std::cout << " > evaluation " << evaluations << ", best: " << best.cost << std::endl;
+			clever::trace_progress(evaluations, best.cost);
+		}
+		return true;
+	});
 }
 
 
@@ -181,9 +238,18 @@ int main(int argc, char* argv[])
 	const size_t pop_size = 10 * problem_size;
 	const double weight_f = 0.8;
 	const double cross_f = 0.9;
+	// asynchronous steady-state evolution instead, see steady_state_search
+	const bool steady_state = false;
 	// execute the algorithm
 	candidate_solution best;
-	search(best, max_gens, search_space, pop_size, weight_f, cross_f);
+	if (steady_state)
+	{
+		steady_state_search(best, max_gens, search_space, pop_size, weight_f, cross_f);
+	}
+	else
+	{
+		search(best, max_gens, search_space, pop_size, weight_f, cross_f);
+	}
 
 	std::cout << "Done. Solution: f = " << best.cost << ", s = ";
 	for (auto& vec : best.vector)
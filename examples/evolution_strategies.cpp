@@ -1,14 +1,10 @@
 #include <iostream>
-#include <random>
+#include <cmath>
 #include <vector>
 #include <string>
 #include <algorithm>
 
-
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_real_distribution<> distribution(0.0, 1.0);
-auto random_ = []() { return distribution(generator); };
+#include "clever_algorithm.h"
 
 
 using candidate_solution = struct candidate_solution_t
@@ -19,89 +15,87 @@ using candidate_solution = struct candidate_solution_t
 };
 
 
-double objective_function(const std::vector<double>& vector)
+// A population in structure-of-arrays form: row d of vectors and strategy
+// holds dimension d of every member, so mutation sweeps whole rows.
+using population_info = struct population_info_t
 {
-	double sum = 0.0;
-	for (const double val : vector)
-	{
-		sum += val * val;
-	}
-
-	return sum;
-}
+	clever::candidate_batch vectors;
+	clever::candidate_batch strategy;
+	std::vector<double> fitness;
+};
 
 
-void random_vector(std::vector<double>& arr, const std::vector<std::vector<double>>& minmax)
+// child = parent + stdev * N(0, 1) for the first children.size() members
+void mutate_problem(clever::candidate_batch& child, const clever::candidate_batch& vectors,
+                    const clever::candidate_batch& stdevs, const std::vector<std::vector<double>>& search_space,
+                    std::vector<double>& draws)
 {
-	arr.clear();
-	for (const auto& item : minmax)
+	draws.resize(child.size());
+	for (size_t d = 0; d < child.dimensions(); ++d)
 	{
-		arr.push_back(item[0] + (item[1] - item[0]) * random_());
+		clever::default_engine().fill_gaussian(draws);
+		const auto parent = vectors.dimension(d);
+		const auto stdev = stdevs.dimension(d);
+		const auto row = child.dimension(d);
+		for (size_t i = 0; i < child.size(); ++i)
+		{
+			row[i] = parent[i] + stdev[i] * draws[i];
+		}
 	}
+	clever::clamp_to_bounds(child, search_space);
 }
 
 
-double random_gaussian(const double mean = 0.0, const double stdev = 1.0)
+// log-normal self-adaptation of the step sizes
+void mutate_strategy(clever::candidate_batch& child, const clever::candidate_batch& stdevs,
+                     std::vector<double>& draws)
 {
-	double u1 = 0.0, u2 = 0.0, w = 0.0;
-	u1 = 2 * random_() - 1;
-	u2 = 2 * random_() - 1;
-	w = u1 * u1 + u2 * u2;
-	while (w >= 1)
+	const double stdevs_size = stdevs.dimensions();
+	const double tau = 1 / sqrt(2.0 * stdevs_size);
+	const double tau_p = 1 / sqrt(2.0 * sqrt(stdevs_size));
+
+	draws.resize(2 * child.size());
+	for (size_t d = 0; d < child.dimensions(); ++d)
 	{
-		u1 = 2 * random_() - 1;
-		u2 = 2 * random_() - 1;
-		w = u1 * u1 + u2 * u2;
+		clever::default_engine().fill_gaussian(draws);
+		const auto stdev = stdevs.dimension(d);
+		const auto row = child.dimension(d);
+		for (size_t i = 0; i < child.size(); ++i)
+		{
+			row[i] = stdev[i] * exp(tau_p * draws[2 * i] + tau * draws[2 * i + 1]);
+		}
 	}
-
-	w = sqrt((-2.0 * log(w)) / w);
-
-	return mean + (u2 * w) * stdev;
 }
 
 
-void mutate_problem(std::vector<double>& child, const std::vector<double>& vector,
-                    const std::vector<double>& stdevs, const std::vector<std::vector<double>>& search_space)
+void mutate(population_info& children, const population_info& parents,
+            const std::vector<std::vector<double>>& minmax, std::vector<double>& draws)
 {
-	child.clear();
-	child.resize(vector.size());
-
-	for (size_t i = 0; i < child.size(); ++i)
-	{
-		const double v = vector[i];
-		child[i] = v + stdevs[i] * random_gaussian();
-		if (child[i] < search_space[i][0])
-			child[i] = search_space[i][0];
-		if (child[i] > search_space[i][1])
-			child[i] = search_space[i][1];
-	}
+	mutate_problem(children.vectors, parents.vectors, parents.strategy, minmax, draws);
+	mutate_strategy(children.strategy, parents.strategy, draws);
 }
 
 
-void mutate_strategy(std::vector<double>& child, const std::vector<double>& stdevs)
+// the same mutation for a single child of member parent
+void mutate(candidate_solution& child, const population_info& pop, const size_t parent,
+            const std::vector<std::vector<double>>& minmax)
 {
-	const double stdevs_size = stdevs.size();
+	const double stdevs_size = pop.strategy.dimensions();
 	const double tau = 1 / sqrt(2.0 * stdevs_size);
 	const double tau_p = 1 / sqrt(2.0 * sqrt(stdevs_size));
 
-	child.clear();
-	child.resize(stdevs.size());
-	for (size_t i = 0; i < child.size(); ++i)
+	pop.vectors.get(parent, child.vector);
+	pop.strategy.get(parent, child.strategy);
+	for (size_t d = 0; d < child.vector.size(); ++d)
 	{
-		child[i] = stdevs[i] * exp(tau_p * random_gaussian() + tau * random_gaussian());
+		child.vector[d] += child.strategy[d] * clever::random_gaussian();
+		child.strategy[d] *= exp(tau_p * clever::random_gaussian() + tau * clever::random_gaussian());
 	}
+	clever::clamp_to_bounds(child.vector, minmax);
 }
 
 
-void mutate(candidate_solution& child, const candidate_solution& par,
-            const std::vector<std::vector<double>>& minmax)
-{
-	mutate_problem(child.vector, par.vector, par.strategy, minmax);
-	mutate_strategy(child.strategy, par.strategy);
-}
-
-
-void init_population(std::vector<candidate_solution>& pop,
+void init_population(population_info& pop,
                      const std::vector<std::vector<double>>& minmax, const size_t pop_size)
 {
 	std::vector<std::vector<double>> strategy;
@@ -113,63 +107,118 @@ void init_population(std::vector<candidate_solution>& pop,
 		strategy.push_back(tmp);
 	}
 
-	pop.clear();
-	pop.resize(pop_size);
-	for (auto& item : pop)
-	{
-		random_vector(item.vector, minmax);
-		random_vector(item.strategy, strategy);
-		item.fitness = objective_function(item.vector);
-	}
+	pop.vectors.resize(pop_size, minmax.size());
+	pop.strategy.resize(pop_size, minmax.size());
+	clever::random_batch(pop.vectors, minmax);
+	clever::random_batch(pop.strategy, strategy);
+	clever::sphere_batch(pop.vectors, pop.fitness);
 }
 
 
-bool cmp(const candidate_solution& c_l, const candidate_solution& c_r)
+// keeps the first order.size() members of from, in that order
+void select(population_info& to, const population_info& from, const std::vector<size_t>& order)
 {
-	if (c_l.fitness < c_r.fitness)
+	to.vectors.gather(from.vectors, order);
+	to.strategy.gather(from.strategy, order);
+	to.fitness.resize(order.size());
+	for (size_t i = 0; i < order.size(); ++i)
 	{
-		return true;
+		to.fitness[i] = from.fitness[order[i]];
 	}
-
-	return false;
 }
 
 
 void search(candidate_solution& best, const size_t max_gens,
             const std::vector<std::vector<double>>& search_space, const size_t pop_size, const size_t num_children)
 {
-	std::vector<candidate_solution> population;
-	init_population(population, search_space, pop_size);
-	std::sort(population.begin(), population.end(), cmp);
-	best = population[0];
+	population_info population, children, union_set;
+	std::vector<size_t> order;
+	std::vector<double> draws;
+	{
+		population_info initial;
+		init_population(initial, search_space, pop_size);
+		clever::order_by_cost(order, initial.fitness);
+		select(population, initial, order);
+	}
+	population.vectors.get(0, best.vector);
+	population.strategy.get(0, best.strategy);
+	best.fitness = population.fitness[0];
 	for (size_t gen = 0; gen < max_gens; ++gen)
 	{
-		std::vector<candidate_solution> children(num_children);
-		for (size_t i = 0; i < num_children; ++i)
+		// child i is bred by member i of the sorted population
+		children.vectors.resize(num_children, search_space.size());
+		children.strategy.resize(num_children, search_space.size());
+		mutate(children, population, search_space, draws);
+		clever::sphere_batch(children.vectors, children.fitness);
+
+		union_set.vectors.concatenate(population.vectors, children.vectors);
+		union_set.strategy.concatenate(population.strategy, children.strategy);
+		union_set.fitness = population.fitness;
+		union_set.fitness.insert(union_set.fitness.end(), children.fitness.begin(), children.fitness.end());
+		clever::order_by_cost(order, union_set.fitness);
+		order.resize(pop_size);
+		select(population, union_set, order);
+		if (population.fitness[0] < best.fitness)
 		{
-			mutate(children[i], population[i], search_space);
-			children[i].fitness = objective_function(children[i].vector);
+			population.vectors.get(0, best.vector);
+			population.strategy.get(0, best.strategy);
+			best.fitness = population.fitness[0];
 		}
-		std::vector<candidate_solution> union_set(population.size() + children.size());
-		for (size_t i = 0; i < population.size(); ++i)
-		{
-			union_set[i] = population[i];
-		}
-		for (size_t i = 0; i < children.size(); ++i)
+		std::cout << " > gen " << gen << ", best: " << best.fitness << std::endl;
+		clever::trace_progress(pop_size + (gen + 1) * num_children, best.fitness);
+	}
+}
+
+
+// Asynchronous steady-state (mu + 1)-ES for objectives whose evaluation
+// time varies: workers evaluate children while the next ones are bred from
+// random members, and a child replaces the worst member as soon as its
+// fitness is known, unless it is worse still. The budget is max_gens *
+// num_children children.
+void steady_state_search(candidate_solution& best, const size_t max_gens,
+                         const std::vector<std::vector<double>>& search_space, const size_t pop_size,
+                         const size_t num_children)
+{
+	population_info population;
+	init_population(population, search_space, pop_size);
+	const auto first = static_cast<size_t>(std::min_element(population.fitness.begin(), population.fitness.end())
+		- population.fitness.begin());
+	population.vectors.get(first, best.vector);
+	population.strategy.get(first, best.strategy);
+	best.fitness = population.fitness[first];
+
+	clever::evaluation_queue<candidate_solution> queue([](candidate_solution& child)
+	{
+		child.fitness = clever::sphere_function(child.vector);
+	});
+	size_t evaluations = pop_size;
+	clever::steady_state(queue, max_gens * num_children, [&]()
+	{
+		candidate_solution child;
+		mutate(child, population, clever::random_index(pop_size), search_space);
+		return child;
+	}, [&](const candidate_solution& child)
+	{
+		const auto worst = static_cast<size_t>(std::max_element(population.fitness.begin(),
+		                                                        population.fitness.end())
+			- population.fitness.begin());
+		if (child.fitness <= population.fitness[worst])
 		{
-			union_set[i + pop_size] = children[i];
+			population.vectors.set(worst, child.vector);
+			population.strategy.set(worst, child.strategy);
+			population.fitness[worst] = child.fitness;
 		}
-		std::sort(union_set.begin(), union_set.end(), cmp);
-		if (union_set[0].fitness < best.fitness)
+		if (child.fitness < best.fitness)
 		{
-			best = union_set[0];
+			best = child;
 		}
-		for (size_t i = 0; i < pop_size; ++i)
+		if (++evaluations % num_children == 0)
 		{
-			population[i] = union_set[i];
+			std::cout << " > evaluation " << evaluations << ", best: " << best.fitness << std::endl;
+			clever::trace_progress(evaluations, best.fitness);
 		}
-		std::cout << " > gen " << gen << ", best: " << best.fitness << std::endl;
-	}
+		return true;
+	});
 }
 
 
@@ -187,9 +236,18 @@ int main(int argc, char* argv[])
 	const size_t max_gens = 100;
 	const size_t pop_size = 30;
 	const size_t num_children = 20;
+	// asynchronous steady-state evolution instead, see steady_state_search
+	const bool steady_state = false;
 	// execute the algorithm
 	candidate_solution best;
-	search(best, max_gens, search_space, pop_size, num_children);
+	if (steady_state)
+	{
+		steady_state_search(best, max_gens, search_space, pop_size, num_children);
+	}
+	else
+	{
+		search(best, max_gens, search_space, pop_size, num_children);
+	}
 
 	std::cout << "Done. Solution: f = " << best.fitness << ", s = ";
 	for (auto& vec : best.vector)
@@ -1,14 +1,10 @@
 #include <iostream>
-#include <random>
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <cmath>
 
-
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_real_distribution<> distribution(0.0, 1.0);
-auto random_ = []() { return distribution(generator); };
+#include "clever_algorithm.h"
 
 
 using candidate_solution = struct candidate_solution_t
@@ -16,87 +12,64 @@ using candidate_solution = struct candidate_solution_t
 	std::vector<double> vector;
 	std::vector<double> strategy;
 	double fitness = 0;
-	size_t wins = 0;
 };
 
 
-double objective_function(const std::vector<double>& vector)
-{
-	double sum = 0.0;
-	for (const double val : vector)
-	{
-		sum += val * val;
-	}
-
-	return sum;
-}
-
-
-void random_vector(std::vector<double>& arr, const std::vector<std::vector<double>>& minmax)
-{
-	arr.clear();
-	for (const auto& item : minmax)
-	{
-		arr.push_back(item[0] + (item[1] - item[0]) * random_());
-	}
-}
-
-
-double random_gaussian(const double mean = 0.0, const double stdev = 1.0)
+// A population in structure-of-arrays form: row d of vectors and strategy
+// holds dimension d of every member, so mutation sweeps whole rows.
+using population_info = struct population_info_t
 {
-	double u1 = 0.0, u2 = 0.0, w = 0.0;
-	u1 = 2 * random_() - 1;
-	u2 = 2 * random_() - 1;
-	w = u1 * u1 + u2 * u2;
-	while (w >= 1)
-	{
-		u1 = 2 * random_() - 1;
-		u2 = 2 * random_() - 1;
-		w = u1 * u1 + u2 * u2;
-	}
-	w = sqrt((-2.0 * log(w)) / w);
-	return mean + (u2 * w) * stdev;
-}
+	clever::candidate_batch vectors;
+	clever::candidate_batch strategy;
+	std::vector<double> fitness;
+	std::vector<size_t> wins;
+};
 
 
-void mutate(candidate_solution& child, const candidate_solution& candidate,
-            const std::vector<std::vector<double>>& search_space)
+// every member of the population breeds one child
+void mutate(population_info& children, const population_info& population,
+            const std::vector<std::vector<double>>& search_space, std::vector<double>& draws)
 {
-	child.vector.clear();
-	child.strategy.clear();
-	for (size_t i = 0; i < candidate.vector.size(); ++i)
+	const auto size = population.vectors.size();
+	children.vectors.resize(size, population.vectors.dimensions());
+	children.strategy.resize(size, population.strategy.dimensions());
+	draws.resize(2 * size);
+	for (size_t d = 0; d < population.vectors.dimensions(); ++d)
 	{
-		const auto v_old = candidate.vector[i];
-		const auto s_old = candidate.strategy[i];
-
-		auto v = v_old + s_old * random_gaussian();
-		if (v < search_space[i][0])
-			v = search_space[i][0];
-		if (v > search_space[i][1])
-			v = search_space[i][1];
-
-		child.vector.push_back(v);
-		child.strategy.push_back(s_old + random_gaussian() * sqrt(abs(s_old)));
+		clever::default_engine().fill_gaussian(draws);
+		const auto v_old = population.vectors.dimension(d);
+		const auto s_old = population.strategy.dimension(d);
+		const auto v = children.vectors.dimension(d);
+		const auto s = children.strategy.dimension(d);
+		for (size_t i = 0; i < size; ++i)
+		{
+			v[i] = v_old[i] + s_old[i] * draws[2 * i];
+			s[i] = s_old[i] + draws[2 * i + 1] * sqrt(fabs(s_old[i]));
+		}
 	}
+	clever::clamp_to_bounds(children.vectors, search_space);
 }
 
 
-void tournament(candidate_solution& candidate, const std::vector<candidate_solution>& population,
-                const size_t bout_size)
+void tournament(population_info& population, const size_t bout_size)
 {
-	candidate.wins = 0;
-	for (size_t i = 0; i < bout_size; ++i)
+	const auto size = population.fitness.size();
+	population.wins.assign(size, 0);
+	for (size_t i = 0; i < size; ++i)
 	{
-		auto& other = population[static_cast<size_t>((population.size() - 1) * random_())];
-		if (candidate.fitness < other.fitness)
+		for (size_t j = 0; j < bout_size; ++j)
 		{
-			candidate.wins += 1;
+			const auto other = clever::random_index(size);
+			if (population.fitness[i] < population.fitness[other])
+			{
+				population.wins[i] += 1;
+			}
 		}
 	}
 }
 
 
-void init_population(std::vector<candidate_solution>& pop,
+void init_population(population_info& pop,
                      const std::vector<std::vector<double>>& minmax,
                      const size_t pop_size)
 {
@@ -108,36 +81,23 @@ void init_population(std::vector<candidate_solution>& pop,
 		tmp_bound.push_back((bound[1] - bound[0]) * 0.05);
 		strategy.push_back(tmp_bound);
 	}
-	pop.clear();
-	pop.resize(pop_size);
-	for (auto& p : pop)
-	{
-		random_vector(p.vector, minmax);
-		random_vector(p.strategy, strategy);
-		p.fitness = objective_function(p.vector);
-	}
-}
-
-
-bool cmp_fitness(const candidate_solution& c_l, const candidate_solution& c_r)
-{
-	if (c_l.fitness < c_r.fitness)
-	{
-		return true;
-	}
-
-	return false;
+	pop.vectors.resize(pop_size, minmax.size());
+	pop.strategy.resize(pop_size, minmax.size());
+	clever::random_batch(pop.vectors, minmax);
+	clever::random_batch(pop.strategy, strategy);
+	clever::sphere_batch(pop.vectors, pop.fitness);
 }
 
 
-bool cmp_wins(const candidate_solution& c_l, const candidate_solution& c_r)
+void update_best(candidate_solution& best, const population_info& pop)
 {
-	if (c_l.wins > c_r.wins)
+	const auto i = static_cast<size_t>(std::min_element(pop.fitness.begin(), pop.fitness.end()) - pop.fitness.begin());
+	if (best.vector.empty() || pop.fitness[i] < best.fitness)
 	{
-		return true;
+		pop.vectors.get(i, best.vector);
+		pop.strategy.get(i, best.strategy);
+		best.fitness = pop.fitness[i];
 	}
-
-	return false;
 }
 
 
@@ -145,44 +105,44 @@ void search(candidate_solution& best, const size_t max_gens,
             const std::vector<std::vector<double>>& search_space,
             const size_t pop_size, const size_t bout_size)
 {
-	std::vector<candidate_solution> population;
+	population_info population, children, union_set;
+	std::vector<double> draws;
+	std::vector<size_t> order(2 * pop_size);
 	init_population(population, search_space, pop_size);
-	std::sort(population.begin(), population.end(), cmp_fitness);
-	best = population[0];
+	update_best(best, population);
 	for (size_t gen = 0; gen < max_gens; ++gen)
 	{
-		std::vector<candidate_solution> children(pop_size);
-		for (size_t i = 0; i < children.size(); ++i)
-		{
-			mutate(children[i], population[i], search_space);
-			children[i].fitness = objective_function(children[i].vector);
-		}
-		std::sort(children.begin(), children.end(), cmp_fitness);
-		if (children[0].fitness < best.fitness)
-			best = children[0];
-		std::vector<candidate_solution> union_set(children.size() + population.size());
-		for (size_t i = 0; i < children.size(); ++i)
-		{
-			union_set[i] = children[i];
-		}
-
-		for (size_t i = 0; i < population.size(); ++i)
+		mutate(children, population, search_space, draws);
+		clever::sphere_batch(children.vectors, children.fitness);
+		update_best(best, children);
+
+		union_set.vectors.concatenate(children.vectors, population.vectors);
+		union_set.strategy.concatenate(children.strategy, population.strategy);
+		union_set.fitness = children.fitness;
+		union_set.fitness.insert(union_set.fitness.end(), population.fitness.begin(), population.fitness.end());
+		tournament(union_set, bout_size);
+
+		// the members with the most wins survive
+		order.resize(union_set.fitness.size());
+		for (size_t i = 0; i < order.size(); ++i)
 		{
-			union_set[i + children.size()] = population[i];
+			order[i] = i;
 		}
-
-		for (size_t i = 0; i < union_set.size(); ++i)
+		std::stable_sort(order.begin(), order.end(), [&](const size_t a, const size_t b)
 		{
-			tournament(union_set[i], union_set, bout_size);
-		}
-
-		std::sort(union_set.begin(), union_set.end(), cmp_wins);
+			return union_set.wins[a] > union_set.wins[b];
+		});
+		order.resize(pop_size);
+		population.vectors.gather(union_set.vectors, order);
+		population.strategy.gather(union_set.strategy, order);
+		population.fitness.resize(pop_size);
 		for (size_t i = 0; i < pop_size; ++i)
 		{
-			population[i] = union_set[i];
+			population.fitness[i] = union_set.fitness[order[i]];
 		}
 
 		std::cout << " > gen " << gen << ", best: " << best.fitness << std::endl;
+		clever::trace_progress((gen + 2) * pop_size, best.fitness);
 	}
 }
 
@@ -1,310 +1,237 @@
 #include <iostream>
-#include <random>
 #include <vector>
 #include <string>
 #include <algorithm>
-#include <map>
+#include <cstdint>
 
+#include "clever_algorithm.h"
 
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_real_distribution<> distribution(0.0, 1.0);
-auto random_ = []() { return distribution(generator); };
 
+using candidate_solution = clever::permutation_solution;
 
-using candidate_solution = struct candidate_solution_st
+
+// Everything tau-EO keeps between steps. A city's fitness is 3 / (r1 + r2),
+// r1 and r2 being the ranks of its two tour neighbours among its nearest
+// cities, so the cities are kept bucketed by that rank sum, worst first,
+// and a count per bucket in a Fenwick tree finds the k-th worst city in
+// O(log n). A move reverses one segment of the tour, which changes the
+// neighbours, and so the fitness, of the four cities at its ends only.
+using eo_state = struct eo_state_t
 {
-	std::vector<size_t> vector;
+	size_t n = 0;
+	std::vector<size_t> tour;
+	// position[c] is the index of city c in tour
+	std::vector<size_t> position;
+	// rank[c * n + j] is the rank of city j from city c, 1 for the nearest
+	std::vector<std::uint32_t> rank;
+	// buckets[b] holds the cities whose rank sum is 2n - b
+	std::vector<std::vector<size_t>> buckets;
+	// the bucket of every city and its place in it
+	std::vector<size_t> bucket;
+	std::vector<size_t> slot;
+	// cities per bucket
+	clever::fenwick_tree counts;
+	// the power-law rank distributions over the cities and over the
+	// neighbours of one city, built once
+	clever::alias_table component_ranks;
+	clever::alias_table neighbour_ranks;
 	double cost = 0.0;
 };
 
 
-using city_info = struct city_st
+size_t previous_city(const eo_state& state, const size_t city)
 {
-	size_t number = 0;
-	double distance = 0.0;
-	double fitness = 0.0;
-	double prob = 0.0;
-};
+	const auto i = state.position[city];
+	return state.tour[i == 0 ? state.n - 1 : i - 1];
+}
 
 
-double euc_2d(const std::vector<double>& c1, const std::vector<double>& c2)
+size_t next_city(const eo_state& state, const size_t city)
 {
-	double sum = 0.0;
-	for (size_t i = 0; i < c1.size(); ++i)
-	{
-		sum += (c1[i] - c2[i]) * (c1[i] - c2[i]);
-	}
-
-	return sqrt(sum);
+	const auto i = state.position[city];
+	return state.tour[i == state.n - 1 ? 0 : i + 1];
 }
 
 
-double cost(const std::vector<size_t>& permutation, const std::vector<std::vector<double>>& cities)
+size_t city_bucket(const eo_state& state, const size_t city)
 {
-	double distance = 0.0;
-	for (size_t i = 0; i < permutation.size(); ++i)
-	{
-		const auto c1 = permutation[i];
-		const auto c2 = (i == permutation.size() - 1) ? permutation[0] : permutation[i + 1];
-		distance += euc_2d(cities[c1], cities[c2]);
-	}
-
-	return distance;
+	const auto* rank = &state.rank[city * state.n];
+	return 2 * state.n - rank[previous_city(state, city)] - rank[next_city(state, city)];
 }
 
 
-void random_permutation(std::vector<size_t>& perm, const std::vector<std::vector<double>>& cities)
+void place_city(eo_state& state, const size_t city)
 {
-	perm.resize(cities.size());
-	for (size_t i = 0; i < cities.size(); ++i)
-	{
-		perm[i] = i;
-	}
-
-	for (size_t i = 0; i < perm.size(); ++i)
-	{
-		const auto r = static_cast<size_t>(random_() * (perm.size() - 1 - i)) + i;
-		const auto tmp = perm[r];
-		perm[r] = perm[i];
-		perm[i] = tmp;
-	}
+	const auto b = city_bucket(state, city);
+	state.bucket[city] = b;
+	state.slot[city] = state.buckets[b].size();
+	state.buckets[b].push_back(city);
+	state.counts.add(b, 1.0);
 }
 
 
-bool cmp_distance(const city_info& l, const city_info& r)
+// moves city to the bucket of its current rank sum
+void update_city_fitness(eo_state& state, const size_t city)
 {
-	if (l.distance < r.distance)
+	const auto old_bucket = state.bucket[city];
+	if (city_bucket(state, city) == old_bucket)
 	{
-		return true;
+		return;
 	}
-	return false;
+	auto& cities = state.buckets[old_bucket];
+	const auto last = cities.back();
+	cities[state.slot[city]] = last;
+	state.slot[last] = state.slot[city];
+	cities.pop_back();
+	state.counts.add(old_bucket, -1.0);
+	place_city(state, city);
 }
 
 
-void calculate_neighbor_rank(std::vector<city_info>& neighbors,
-                             const size_t city_number,
-                             const std::vector<std::vector<double>>& cities,
-                             const std::vector<size_t>& ignore)
+// distance needs its neighbour lists built over every other city
+void initialize_state(eo_state& state,
+                      const clever::distance_provider& distance,
+                      const std::vector<size_t>& tour,
+                      const double tau)
 {
-	for (size_t i = 0; i < cities.size(); ++i)
+	const auto n = distance.size();
+	state.n = n;
+	state.tour = tour;
+	state.position.resize(n);
+	for (size_t i = 0; i < n; ++i)
 	{
-		auto& city = cities[i];
-		if (i == city_number || std::find(ignore.begin(), ignore.end(), i) != ignore.end())
-		{
-			continue;
-		}
-		city_info neighbor;
-		neighbor.number = i;
-		neighbor.distance = euc_2d(cities[city_number], city);
-		neighbors.push_back(neighbor);
+		state.position[tour[i]] = i;
 	}
-
-	std::sort(neighbors.begin(), neighbors.end(), cmp_distance);
-}
-
-
-void get_edges_for_city(size_t& c1, size_t& c2, const size_t city_number,
-                        const std::vector<size_t>& permutation)
-{
-	for (size_t i = 0; i < permutation.size(); ++i)
+	state.rank.assign(n * n, 0);
+	for (size_t c = 0; c < n; ++c)
 	{
-		auto c = permutation[i];
-		if (c == city_number)
+		const auto* neighbours = distance.neighbors(c);
+		for (size_t r = 0; r < n - 1; ++r)
 		{
-			c1 = (i == 0) ? *(permutation.end() - 1) : permutation[i - 1];
-			c2 = (i == permutation.size() - 1) ? permutation[0] : permutation[i + 1];
-			break;
+			state.rank[c * n + neighbours[r]] = static_cast<std::uint32_t>(r + 1);
 		}
 	}
-}
-
-
-double calculate_city_fitness(const std::vector<size_t>& permutation,
-                              const size_t city_number,
-                              const std::vector<std::vector<double>>& cities)
-{
-	size_t c1, c2;
-	get_edges_for_city(c1, c2, city_number, permutation);
-	std::vector<city_info> neighbors;
-	std::vector<size_t> ignore;
-	calculate_neighbor_rank(neighbors, city_number, cities, ignore);
-	long long n1 = -1, n2 = -1;
-	for (size_t i = 0; i < neighbors.size(); ++i)
+	state.buckets.assign(2 * n, std::vector<size_t>());
+	state.bucket.resize(n);
+	state.slot.resize(n);
+	state.counts.resize(2 * n);
+	for (size_t c = 0; c < n; ++c)
 	{
-		const auto& neighbor = neighbors[i];
-		if (neighbor.number == c1)
-			n1 = i + 1;
-		if (neighbor.number == c2)
-			n2 = i + 1;
-		if (n1 != -1 && n2 != -1)
-			break;
+		place_city(state, c);
 	}
-
-	return 3.0 / static_cast<double>(n1 + n2);
+	std::vector<double> weights;
+	clever::power_law_weights(weights, n, tau);
+	state.component_ranks.build(weights);
+	weights.pop_back();
+	state.neighbour_ranks.build(weights);
+	state.cost = clever::tour_cost(tour, distance);
 }
 
 
-bool cmp_fitness(const city_info& l, const city_info& r)
+// the city of the power-law drawn rank among the cities ordered worst first;
+// ties share a bucket and are taken uniformly, as a random order would
+size_t select_component(const eo_state& state)
 {
-	if (l.fitness < r.fitness)
-	{
-		return true;
-	}
-	return false;
+	const auto k = state.component_ranks.sample();
+	const auto& cities = state.buckets[state.counts.find(k + 0.5)];
+	return cities[clever::random_index(cities.size())];
 }
 
-void calculate_city_fitnesses(std::vector<city_info>& city_fitnesses,
-                              const std::vector<std::vector<double>>& cities,
-                              const std::vector<size_t>& permutation)
+
+// the neighbour of the power-law drawn rank from city, other than its two
+// current tour neighbours
+size_t select_neighbour(const eo_state& state,
+                        const clever::distance_provider& distance,
+                        const size_t city)
 {
-	city_fitnesses.clear();
-	for (size_t i = 0; i < cities.size(); ++i)
+	const auto* neighbours = distance.neighbors(city);
+	const auto c1 = previous_city(state, city);
+	const auto c2 = next_city(state, city);
+	size_t selected;
+	do
 	{
-		city_info city_fitness;
-		city_fitness.number = i;
-		city_fitness.fitness = calculate_city_fitness(permutation, i, cities);
-		city_fitnesses.push_back(city_fitness);
-	}
-	std::sort(city_fitnesses.begin(), city_fitnesses.end(), cmp_fitness);
+		selected = neighbours[state.neighbour_ranks.sample()];
+	} while (selected == c1 || selected == c2);
+	return selected;
 }
 
 
-double calculate_component_probabilities(std::vector<city_info>& ordered_components,
-                                         const double tau = 0.0)
+size_t get_long_edge(const eo_state& state,
+                     const clever::distance_provider& distance,
+                     const size_t city)
 {
-	double sum = 0.0;
-	for (size_t i = 0; i < ordered_components.size(); ++i)
-	{
-		auto& component = ordered_components[i];
-		component.prob = pow(i + 1.0, -tau);
-		sum += component.prob;
-	}
-	return sum;
+	const auto c1 = previous_city(state, city);
+	const auto c2 = next_city(state, city);
+	return distance(city, c1) > distance(city, c2) ? c1 : c2;
 }
 
 
-size_t make_selection(const std::vector<city_info>& components, const double sum_probability)
+// Reverses tour positions [i, j]. The cycle is the same when the rest of
+// the tour is reversed instead, so the shorter side is.
+void reverse_segment(eo_state& state,
+                     const clever::distance_provider& distance,
+                     const size_t i,
+                     const size_t j)
 {
-	auto selection = random_();
-	for (const auto& component : components)
+	const auto n = state.n;
+	const auto a = state.tour[(i + n - 1) % n];
+	const auto b = state.tour[i];
+	const auto c = state.tour[j];
+	const auto d = state.tour[(j + 1) % n];
+	state.cost += distance(a, c) + distance(b, d) - distance(a, b) - distance(c, d);
+
+	auto first = i;
+	auto last = j;
+	auto length = j - i + 1;
+	if (2 * length > n)
 	{
-		selection -= component.prob / sum_probability;
-		if (selection <= 0.0)
-		{
-			return component.number;
-		}
+		first = (j + 1) % n;
+		last = (i + n - 1) % n;
+		length = n - length;
 	}
-
-	const auto& last = *(components.end() - 1);
-	return last.number;
-}
-
-
-size_t probabilistic_selection(std::vector<city_info>& ordered_components,
-                               const double tau,
-                               const std::vector<size_t>& exclude)
-{
-	const double sum = calculate_component_probabilities(ordered_components, tau);
-	size_t selected_city = make_selection(ordered_components, sum);
-	while (std::find(exclude.begin(), exclude.end(), selected_city) != exclude.end())
+	for (size_t k = 0; k < length / 2; ++k)
 	{
-		selected_city = make_selection(ordered_components, sum);
+		auto& x = state.tour[(first + k) % n];
+		auto& y = state.tour[(last + n - k) % n];
+		std::swap(x, y);
+		state.position[x] = (first + k) % n;
+		state.position[y] = (last + n - k) % n;
 	}
-	return selected_city;
+	update_city_fitness(state, a);
+	update_city_fitness(state, b);
+	update_city_fitness(state, c);
+	update_city_fitness(state, d);
 }
 
 
-void vary_permutation(std::vector<size_t>& perm,
-                      const std::vector<size_t>& permutation,
+// makes new_value a tour neighbour of selected in place of long_edge
+void vary_permutation(eo_state& state,
+                      const clever::distance_provider& distance,
                       const size_t selected,
                       const size_t new_value,
-                      const size_t long_edge
-)
+                      const size_t long_edge)
 {
-	perm.clear();
-	perm = permutation;
-	const size_t c1 = std::find(perm.begin(), perm.end(), selected) - perm.begin();
-	const size_t c2 = std::find(perm.begin(), perm.end(), new_value) - perm.begin();
-	size_t p1, p2;
-	if (c1 < c2)
-	{
-		p1 = c1;
-		p2 = c2;
-	}
-	else
-	{
-		p1 = c2;
-		p2 = c1;
-	}
-	const auto right = c1 == perm.size() - 1 ? 0 : c1 + 1;
-	if (perm[right] == long_edge)
+	const auto c1 = state.position[selected];
+	const auto c2 = state.position[new_value];
+	const auto p1 = std::min(c1, c2);
+	const auto p2 = std::max(c1, c2);
+	if (next_city(state, selected) == long_edge)
 	{
-		for (size_t i = p1 + 1; i < (p2 - p1 - 1) / 2; ++i)
-		{
-			const auto tmp = perm[i];
-			perm[i] = perm[p2 - i + p1 + 1];
-			perm[p2 - i + p1 + 1] = tmp;
-		}
+		reverse_segment(state, distance, p1 + 1, p2);
 	}
 	else
 	{
-		for (size_t i = p1; i < (p2 - p1) / 2; ++i)
-		{
-			const auto tmp = perm[i];
-			perm[i] = perm[p2 - i + p1];
-			perm[p2 - i + p1] = tmp;
-		}
-	}
-}
-
-
-size_t get_long_edge(const std::vector<size_t>& edges,
-                     const std::vector<city_info>& neighbor_distances)
-{
-	city_info n1, n2;
-	for (const auto& neighbor_distance : neighbor_distances)
-	{
-		if (neighbor_distance.number == edges[0])
-		{
-			n1 = neighbor_distance;
-		}
-	}
-
-	for (const auto& neighbor_distance : neighbor_distances)
-	{
-		if (neighbor_distance.number == edges[1])
-		{
-			n2 = neighbor_distance;
-		}
+		reverse_segment(state, distance, p1, p2 - 1);
 	}
-	return n1.distance > n2.distance ? n1.number : n2.number;
 }
 
 
-void create_new_perm(std::vector<size_t>& permutation,
-                     const std::vector<std::vector<double>>& cities,
-                     const double tau,
-                     const std::vector<size_t>& perm)
+void create_new_perm(eo_state& state, const clever::distance_provider& distance)
 {
-	std::vector<city_info> city_fitnesses;
-	calculate_city_fitnesses(city_fitnesses, cities, perm);
-	std::vector<size_t> exclude;
-	for (size_t i = 0; i < city_fitnesses.size() / 2; ++i)
-	{
-		const auto& tmp = city_fitnesses[i];
-		city_fitnesses[i] = *(city_fitnesses.end() - 1 - i);
-		*(city_fitnesses.end() - 1 - i) = tmp;
-	}
-	const auto selected_city = probabilistic_selection(city_fitnesses, tau, exclude);
-	std::vector<size_t> edges(2);
-	get_edges_for_city(edges[0], edges[1], selected_city, perm);
-	std::vector<city_info> neighbors;
-	std::vector<size_t> ignore;
-	calculate_neighbor_rank(neighbors, selected_city, cities, ignore);
-	const auto new_neighbor = probabilistic_selection(neighbors, tau, edges);
-	const auto long_edge = get_long_edge(edges, neighbors);
-	vary_permutation(permutation, perm, selected_city, new_neighbor, long_edge);
+	const auto selected_city = select_component(state);
+	const auto new_neighbor = select_neighbour(state, distance, selected_city);
+	const auto long_edge = get_long_edge(state, distance, selected_city);
+	vary_permutation(state, distance, selected_city, new_neighbor, long_edge);
 }
 
 
@@ -313,46 +240,44 @@ void search(candidate_solution& best,
             const size_t max_iterations,
             const double tau)
 {
-	candidate_solution current;
-	random_permutation(current.vector, cities);
-	current.cost = cost(current.vector, cities);
-	best = current;
+	clever::distance_provider distance(cities);
+	distance.build_neighbor_lists(cities.size() - 1);
+	std::vector<size_t> tour;
+	clever::random_permutation(tour, cities.size());
+	eo_state state;
+	initialize_state(state, distance, tour, tau);
+	best.vector = state.tour;
+	best.cost = state.cost;
 	for (size_t iter = 0; iter < max_iterations; ++iter)
 	{
-		candidate_solution candidate;
-		create_new_perm(candidate.vector, cities, tau, current.vector);
-		candidate.cost = cost(candidate.vector, cities);
-		current = candidate;
-		if (candidate.cost < best.cost)
+		create_new_perm(state, distance);
+		if (state.cost < best.cost)
 		{
-			best = candidate;
+			best.vector = state.tour;
+			best.cost = clever::tour_cost(best.vector, distance);
 		}
-		std::cout << " > iter " << iter + 1 << ", curr = " << current.cost << ", best = "
+		std::cout << " > iter " << iter + 1 << ", curr = " << state.cost << ", best = "
 			<< best.cost << std::endl;
+		clever::trace_progress(iter + 2, best.cost);
 	}
 }
 
 
 int main(int argc, char* argv[])
 {
-	// problem configuration
-	const std::vector<std::vector<double>> berlin52 = {
-		{565, 575}, {25, 185}, {345, 750}, {945, 685}, {845, 655},
-		{880, 660}, {25, 230}, {525, 1000}, {580, 1175}, {650, 1130}, {1605, 620},
-		{1220, 580}, {1465, 200}, {1530, 5}, {845, 680}, {725, 370}, {145, 665},
-		{415, 635}, {510, 875}, {560, 365}, {300, 465}, {520, 585}, {480, 415},
-		{835, 625}, {975, 580}, {1215, 245}, {1320, 315}, {1250, 400}, {660, 180},
-		{410, 250}, {420, 555}, {575, 665}, {1150, 1160}, {700, 580}, {685, 595},
-		{685, 610}, {770, 610}, {795, 645}, {720, 635}, {760, 650}, {475, 960},
-		{95, 260}, {875, 920}, {700, 500}, {555, 815}, {830, 485}, {1170, 65},
-		{830, 610}, {605, 625}, {595, 360}, {1340, 725}, {1740, 245}
-	};
+	// problem configuration, a TSPLIB instance may be given instead of berlin52
+	auto cities = clever::berlin52();
+	if (argc > 1 && !clever::load_tsplib(argv[1], cities))
+	{
+		std::cout << "Cannot read the TSPLIB instance " << argv[1] << std::endl;
+		return 1;
+	}
 	// algorithm configuration
 	const size_t max_iterations = 250;
 	const double tau = 1.8;
 	// execute the algorithm
 	candidate_solution best;
-	search(best, berlin52, max_iterations, tau);
+	search(best, cities, max_iterations, tau);
 
 	std::cout << "Done. Best Solution: c=" << best.cost << ", v={ ";
 	for (unsigned int i : best.vector)
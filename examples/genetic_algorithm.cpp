@@ -1,103 +1,58 @@
 #include <iostream>
-#include <random>
 #include <vector>
-#include <string>
 #include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <thread>
 
+#include "clever_algorithm.h"
 
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_real_distribution<> distribution(0.0, 1.0);
-auto random_ = []() { return distribution(generator); };
 
 using candidate_solution = struct candidate_solution_t
 {
-	std::string bit_string;
+	clever::bit_string bit_string;
 	double fitness = 0.0;
 };
 
 
-double onemax(std::string& bit_string)
+void binary_tournament(candidate_solution& candidate, std::vector<candidate_solution>& pop,
+                       clever::random_engine& rng)
 {
-	double sum = 0.0;
-	for (auto& item : bit_string)
-	{
-		if (item == '1')
-		{
-			sum++;
-		}
-	}
-	return sum;
-}
-
-
-void random_bit_string(std::string& bit_string, const size_t num_bits)
-{
-	bit_string.clear();
-	for (size_t i = 0; i < num_bits; ++i)
-	{
-		bit_string.push_back(random_() < 0.5 ? '1' : '0');
-	}
-}
-
-
-void binary_tournament(candidate_solution& candidate, std::vector<candidate_solution>& pop)
-{
-	const auto i = static_cast<size_t>((pop.size() - 1) * random_());
-	auto j = static_cast<size_t>((pop.size() - 1) * random_());
+	const auto i = static_cast<size_t>((pop.size() - 1) * rng.uniform());
+	auto j = static_cast<size_t>((pop.size() - 1) * rng.uniform());
 	while (j == i)
 	{
-		j = static_cast<size_t>((pop.size() - 1) * random_());
+		j = static_cast<size_t>((pop.size() - 1) * rng.uniform());
 	}
 	candidate = pop[i].fitness > pop[j].fitness ? pop[i] : pop[j];
 }
 
 
-void point_mutation(std::string& child, std::string& bit_string, const double rate)
+void crossover(clever::bit_string& child, const clever::bit_string& parent1, const clever::bit_string& parent2,
+               const double rate, clever::random_engine& rng)
 {
-	std::string tmp;
-
-	for (auto& item : bit_string)
-	{
-		tmp.push_back(random_() < rate ? (item == '1' ? '0' : '1') : item);
-	}
-
-	child = tmp;
-}
-
-
-void crossover(std::string& child, std::string& parent1, std::string& parent2, const double rate)
-{
-	if (random_() >= rate)
+	if (rng.uniform() >= rate)
 	{
 		child = parent1;
+		return;
 	}
 
-	const size_t point = 1 + static_cast<size_t>((parent1.size() - 3) * random_());
-
-	child.clear();
-	for (size_t i = 0; i < point; ++i)
-	{
-		child.push_back(parent1[i]);
-	}
-	for (size_t i = point; i < parent1.size(); ++i)
-	{
-		child.push_back(parent2[i]);
-	}
+	const size_t point = 1 + static_cast<size_t>((parent1.size() - 3) * rng.uniform());
+	clever::one_point_crossover(child, parent1, parent2, point);
 }
 
 
 void reproduce(std::vector<candidate_solution>& children, std::vector<candidate_solution>& selected,
-               const size_t pop_size, const double p_cross, const double p_mutation)
+               const size_t pop_size, const double p_cross, const double p_mutation, clever::random_engine& rng)
 {
 	children.clear();
 	for (size_t i = 0; i < selected.size(); ++i)
 	{
-		auto p1 = selected[i];
-		auto p2 = i % 2 == 0 ? (i == selected.size() - 1 ? selected[0] : selected[i + 1]) : selected[i - 1];
+		const auto& p1 = selected[i];
+		const auto& p2 = i % 2 == 0 ? (i == selected.size() - 1 ? selected[0] : selected[i + 1]) : selected[i - 1];
 		candidate_solution child;
-		crossover(child.bit_string, p1.bit_string, p2.bit_string, p_cross);
-		point_mutation(child.bit_string, child.bit_string, p_mutation);
+		crossover(child.bit_string, p1.bit_string, p2.bit_string, p_cross, rng);
+		clever::point_mutation(child.bit_string, p_mutation, rng);
 		children.push_back(child);
 
 		if (children.size() >= pop_size)
@@ -119,47 +74,222 @@ bool cmp(candidate_solution& candidate1, candidate_solution& candidate2)
 }
 
 
+// onemax, looked up in the cache first
+void fitness(candidate_solution& candidate, clever::fitness_cache& cache)
+{
+	candidate.fitness = cache.get(candidate.bit_string, [&]()
+	{
+		return clever::onemax(candidate.bit_string);
+	});
+}
+
+
+void random_population(std::vector<candidate_solution>& population, const size_t num_bits, const size_t pop_size,
+                       clever::fitness_cache& cache, clever::random_engine& rng,
+                       clever::thread_pool& pool = clever::default_pool())
+{
+	population.resize(pop_size);
+	for (auto& candidate : population)
+	{
+		clever::random_bit_string(candidate.bit_string, num_bits, rng);
+	}
+	clever::evaluate_population(population, [&](candidate_solution& candidate)
+	{
+		fitness(candidate, cache);
+	}, pool);
+	std::sort(population.begin(), population.end(), cmp);
+}
+
+
+// replaces the population by its children, sorted best first
+void next_generation(std::vector<candidate_solution>& population, const size_t pop_size, const double p_crossover,
+                     const double p_mutation, clever::fitness_cache& cache, clever::random_engine& rng,
+                     clever::thread_pool& pool = clever::default_pool())
+{
+	std::vector<candidate_solution> selected;
+	for (size_t j = 0; j < pop_size; ++j)
+	{
+		candidate_solution tmp_candidate;
+		binary_tournament(tmp_candidate, population, rng);
+		selected.push_back(tmp_candidate);
+	}
+	std::vector<candidate_solution> children;
+	reproduce(children, selected, pop_size, p_crossover, p_mutation, rng);
+	clever::evaluate_population(children, [&](candidate_solution& child)
+	{
+		fitness(child, cache);
+	}, pool);
+	std::sort(children.begin(), children.end(), cmp);
+	population = children;
+}
+
+
 void search(candidate_solution& best, const size_t max_gens, const size_t num_bits, const size_t pop_size,
-            const double p_crossover, const double p_mutation)
+            const double p_crossover, const double p_mutation, clever::fitness_cache& cache)
 {
+	auto& rng = clever::default_engine();
 	std::vector<candidate_solution> population;
-	for (size_t i = 0; i < pop_size; ++i)
+	random_population(population, num_bits, pop_size, cache, rng);
+	best = population[0];
+
+	for (size_t i = 0; i < max_gens; ++i)
 	{
-		candidate_solution candidate;
-		random_bit_string(candidate.bit_string, num_bits);
-		candidate.fitness = onemax(candidate.bit_string);
-		population.push_back(candidate);
+		next_generation(population, pop_size, p_crossover, p_mutation, cache, rng);
+		if (population[0].fitness >= best.fitness)
+		{
+			best = population[0];
+		}
+		std::cout << " > gen " << i << ", best: " << best.fitness
+			<< ", " << best.bit_string << std::endl;
+		clever::trace_progress((i + 2) * pop_size, best.fitness);
+
+		if (static_cast<size_t>(best.fitness) == num_bits)
+			break;
 	}
+}
 
-	std::sort(population.begin(), population.end(), cmp);
+
+// Asynchronous steady-state GA for objectives whose evaluation time varies:
+// workers evaluate children while the next ones are bred, and each child
+// replaces the worst member as soon as its fitness is known, unless it is
+// worse still. There are no generations, only a budget of max_gens *
+// pop_size children.
+void steady_state_search(candidate_solution& best, const size_t max_gens, const size_t num_bits,
+                         const size_t pop_size, const double p_crossover, const double p_mutation,
+                         clever::fitness_cache& cache)
+{
+	auto& rng = clever::default_engine();
+	std::vector<candidate_solution> population;
+	random_population(population, num_bits, pop_size, cache, rng);
 	best = population[0];
 
-	for (size_t i = 0; i < max_gens; ++i)
+	clever::evaluation_queue<candidate_solution> queue([&](candidate_solution& child)
 	{
-		std::vector<candidate_solution> selected;
-		for (size_t j = 0; j < pop_size; ++j)
+		fitness(child, cache);
+	});
+	size_t evaluations = pop_size;
+	clever::steady_state(queue, max_gens * pop_size, [&]()
+	{
+		candidate_solution p1, p2, child;
+		binary_tournament(p1, population, rng);
+		binary_tournament(p2, population, rng);
+		crossover(child.bit_string, p1.bit_string, p2.bit_string, p_crossover, rng);
+		clever::point_mutation(child.bit_string, p_mutation, rng);
+		return child;
+	}, [&](const candidate_solution& child)
+	{
+		auto worst = std::min_element(population.begin(), population.end(),
+		                              [](const candidate_solution& a, const candidate_solution& b)
+		{
+			return a.fitness < b.fitness;
+		});
+		if (child.fitness >= worst->fitness)
 		{
-			candidate_solution tmp_candidate;
-			binary_tournament(tmp_candidate, population);
-			selected.push_back(tmp_candidate);
+			*worst = child;
 		}
-		std::vector<candidate_solution> children;
-		reproduce(children, selected, pop_size, p_crossover, p_mutation);
-		for (auto& item : children)
+		if (child.fitness > best.fitness)
 		{
-			item.fitness = onemax(item.bit_string);
+			best = child;
+			std::cout << " > evaluation " << evaluations << ", best: " << best.fitness
+				<< ", " << best.bit_string << std::endl;
 		}
-		std::sort(children.begin(), children.end(), cmp);
-		if (children[0].fitness >= best.fitness)
+		if (++evaluations % pop_size == 0)
 		{
-			best = children[0];
+			clever::trace_progress(evaluations, best.fitness);
 		}
-		population = children;
-		std::cout << " > gen " << i << ", best: " << best.fitness
-			<< ", " << best.bit_string << std::endl;
+		return static_cast<size_t>(best.fitness) < num_bits;
+	});
+	clever::trace_progress(evaluations, best.fitness);
+}
 
-		if (static_cast<size_t>(best.fitness) == num_bits)
-			break;
+
+// Island model: num_islands populations of pop_size evolve concurrently,
+// each on a thread of its own so that all of them run side by side and
+// exchange migrants while they do. Every migration_interval generations each
+// island sends copies of its num_migrants best members along the topology
+// and replaces its worst members by the migrants that have arrived.
+// An island breeds from its own stream and evaluates its children on its
+// own thread, so islands never wait on a shared pool. Migration never
+// blocks, so the exchange depends on thread timing. The trace follows the
+// best fitness over all islands.
+void island_search(candidate_solution& best, const size_t max_gens, const size_t num_bits, const size_t pop_size,
+                   const double p_crossover, const double p_mutation, const size_t num_islands,
+                   const size_t migration_interval, const size_t num_migrants,
+                   const clever::migration_topology topology, clever::fitness_cache& cache)
+{
+	clever::migration_network<candidate_solution> network(num_islands, topology, 4 * num_migrants);
+	std::vector<candidate_solution> island_best(num_islands);
+	std::atomic<bool> solved(false);
+	std::atomic<size_t> evaluations(0);
+	std::atomic<double> global_best(-DBL_MAX);
+	auto streams = clever::make_streams(clever::default_engine()(), num_islands);
+	auto evolve = [&](const size_t island)
+	{
+		auto& rng = streams[island];
+		// a pool of one runs the evaluations inline on the island's thread
+		clever::thread_pool inline_pool(1);
+		std::vector<candidate_solution> population;
+		random_population(population, num_bits, pop_size, cache, rng, inline_pool);
+		auto& local_best = island_best[island];
+		local_best = population[0];
+		evaluations += pop_size;
+		std::vector<size_t> targets;
+		std::vector<candidate_solution> migrants;
+		for (size_t gen = 0; gen < max_gens && !solved; ++gen)
+		{
+			next_generation(population, pop_size, p_crossover, p_mutation, cache, rng, inline_pool);
+			if ((gen + 1) % migration_interval == 0)
+			{
+				network.targets(targets, island, rng);
+				for (const auto to : targets)
+				{
+					for (size_t i = 0; i < num_migrants && i < population.size(); ++i)
+					{
+						network.send(island, to, population[i]);
+					}
+				}
+				migrants.clear();
+				network.receive(island, migrants);
+				for (size_t i = 0; i < migrants.size() && i < population.size(); ++i)
+				{
+					population[population.size() - 1 - i] = migrants[i];
+				}
+				std::sort(population.begin(), population.end(), cmp);
+			}
+			if (population[0].fitness >= local_best.fitness)
+			{
+				local_best = population[0];
+			}
+			auto seen = global_best.load();
+			while (local_best.fitness > seen && !global_best.compare_exchange_weak(seen, local_best.fitness))
+			{
+			}
+			clever::trace_progress(evaluations += pop_size, std::max(seen, local_best.fitness));
+			if (static_cast<size_t>(local_best.fitness) == num_bits)
+			{
+				solved = true;
+			}
+		}
+	};
+	std::vector<std::thread> threads;
+	for (size_t island = 0; island < num_islands; ++island)
+	{
+		threads.emplace_back(evolve, island);
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	best = island_best[0];
+	for (size_t i = 0; i < num_islands; ++i)
+	{
+		std::cout << " > island " << i << ", best: " << island_best[i].fitness
+			<< ", " << island_best[i].bit_string << std::endl;
+		if (island_best[i].fitness > best.fitness)
+		{
+			best = island_best[i];
+		}
 	}
 }
 
@@ -173,9 +303,32 @@ int main(int argc, char* argv[])
 	const size_t pop_size = 100;
 	const double p_crossover = 0.98;
 	const double p_mutation = 1.0 / num_bits;
+	// island model configuration, a single island is the panmictic GA
+	const size_t num_islands = 1;
+	const size_t migration_interval = 5;
+	const size_t num_migrants = 2;
+	const auto topology = clever::migration_topology::ring;
+	// asynchronous steady-state evolution instead, see steady_state_search
+	const bool steady_state = false;
+	// fitness values remembered for repeated bit strings, 0 turns the cache off
+	const size_t cache_size = 4096;
 	// execute the algorithm
 	candidate_solution best;
-	search(best, max_gens, num_bits, pop_size, p_crossover, p_mutation);
+	clever::fitness_cache cache(cache_size);
+	if (steady_state)
+	{
+		steady_state_search(best, max_gens, num_bits, pop_size, p_crossover, p_mutation, cache);
+	}
+	else if (num_islands > 1)
+	{
+		island_search(best, max_gens, num_bits, pop_size, p_crossover, p_mutation, num_islands,
+		              migration_interval, num_migrants, topology, cache);
+	}
+	else
+	{
+		search(best, max_gens, num_bits, pop_size, p_crossover, p_mutation, cache);
+	}
+	std::cout << "Fitness cache: " << cache.hits() << " hits, " << cache.misses() << " misses" << std::endl;
 
 	std::cout << "Done. Solution: f = " << best.fitness << ", s = " << best.bit_string << std::endl;
 
@@ -1,143 +1,67 @@
 #include <iostream>
 #include <numeric>
-#include <random>
 #include <vector>
-#include <iterator>
 #include <algorithm>
 
+#include "clever_algorithm.h"
 
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_real_distribution<> distribution(0.0, 1.0);
-auto random_ = []() { return distribution(generator); };
 
+using candidate_solution = clever::permutation_solution;
 
-using candidate_solution = struct candidate_solution_t
-{
-	std::vector<size_t> vector;
-	double cost = 0.0;
-};
-
-
-double euc_2d(std::vector<double>& c1, std::vector<double>& c2)
-{
-	return sqrt((c1[0] - c2[0]) * (c1[0] - c2[0]) + (c1[1] - c2[1]) * (c1[1] - c2[1]));
-}
-
-
-double cost(std::vector<size_t>& perm, std::vector<std::vector<double>> cities)
-{
-	double distance = 0.0;
-	for (size_t i = 0; i < perm.size(); ++i)
-	{
-		const size_t c1 = perm[i];
-		const size_t c2 = (i == perm.size() - 1) ? perm[0] : perm[i + 1];
-		distance += euc_2d(cities[c1], cities[c2]);
-	}
-	return distance;
-}
-
-
-void stochastic_two_opt(std::vector<size_t>& perm, std::vector<size_t>& permutation)
-{
-	perm.resize(permutation.size());
-	perm.assign(permutation.begin(), permutation.end());
-
-	auto c1 = static_cast<size_t>((perm.size() - 1) * random_());
-	auto c2 = static_cast<size_t>((perm.size() - 1) * random_());
-
-	std::vector<size_t> exclude;
-	exclude.push_back(c1);
-	exclude.push_back(c1 == 0 ? perm.size() - 1 : c1 - 1);
-	exclude.push_back(c1 == perm.size() - 1 ? 0 : c1 + 1);
-	while (std::find(exclude.begin(), exclude.end(), c2) != exclude.end())
-	{
-		c2 = static_cast<size_t>((perm.size() - 1) * random_());
-	}
-
-	if (c2 < c1)
-	{
-		const size_t tmp = c1;
-		c1 = c2;
-		c2 = tmp;
-	}
 
-	for (size_t i = c1; i < (c2 - c1) / 2; ++i)
-	{
-		const size_t tmp = perm[i];
-		perm[i] = perm[c2 - 1 - i + c1];
-		perm[c2 - 1 - i + c1] = tmp;
-	}
-}
-
-
-void local_search(candidate_solution& best, std::vector<std::vector<double>>& cities, const size_t max_no_improv)
-{
-	size_t count = 0;
-	while (count < max_no_improv)
-	{
-		candidate_solution candidate;
-		stochastic_two_opt(candidate.vector, best.vector);
-		candidate.cost = cost(candidate.vector, cities);
-		count = candidate.cost < best.cost ? 0 : count + 1;
-		if (candidate.cost < best.cost)
-		{
-			best.vector = candidate.vector;
-			best.cost = candidate.cost;
-		}
-	}
-}
-
-
-void construct_randomized_greedy_solution(candidate_solution& candidate, std::vector<std::vector<double>>& cities,
+// The cities left are kept unordered, each taken out by moving the last one
+// into its place, and the next city is drawn uniformly from the restricted
+// candidate list, the cities no farther from the last one than
+// min + alpha (max - min) over the cities left.
+void construct_randomized_greedy_solution(candidate_solution& candidate,
+                                          const clever::distance_provider& distance,
                                           const double alpha)
 {
+	std::vector<size_t> remaining(distance.size());
+	std::iota(remaining.begin(), remaining.end(), 0);
+	std::vector<double> costs;
+	std::vector<size_t> rcl;
 	candidate.vector.clear();
-	candidate.vector.push_back(static_cast<size_t>((cities.size() - 1) * random_()));
-
-	std::vector<size_t> all_cities;
-	for (size_t i = 0; i < cities.size(); ++i)
+	auto take = [&](const size_t i)
 	{
-		all_cities.push_back(i);
-	}
+		candidate.vector.push_back(remaining[i]);
+		remaining[i] = remaining.back();
+		remaining.pop_back();
+	};
+	take(clever::random_index(remaining.size()));
 
-	while (candidate.vector.size() < cities.size())
+	while (!remaining.empty())
 	{
-		std::vector<size_t> sorted_candidate(candidate.vector);
-		std::sort(sorted_candidate.begin(), sorted_candidate.end());
-		std::vector<size_t> candidates;
-		std::set_difference(all_cities.begin(), all_cities.end(), sorted_candidate.begin(), sorted_candidate.end(),
-		                    std::inserter(candidates, candidates.begin()));
-
-		std::vector<double> costs;
-		costs.resize(candidates.size());
-		for (size_t i = 0; i < candidates.size(); ++i)
+		const auto last = candidate.vector.back();
+		costs.resize(remaining.size());
+		for (size_t i = 0; i < remaining.size(); ++i)
 		{
-			costs[i] = euc_2d(cities[*(candidate.vector.end() - 1)], cities[i]);
+			costs[i] = distance(last, remaining[i]);
 		}
-		std::vector<size_t> rcl;
 		const double max = *std::max_element(costs.begin(), costs.end());
 		const double min = *std::min_element(costs.begin(), costs.end());
+		rcl.clear();
 		for (size_t i = 0; i < costs.size(); ++i)
 		{
-			const double c = costs[i];
-			if (c <= min + alpha * (max - min))
-				rcl.push_back(candidates[i]);
+			if (costs[i] <= min + alpha * (max - min))
+				rcl.push_back(i);
 		}
-		candidate.vector.push_back(rcl[static_cast<size_t>((rcl.size() - 1) * random_())]);
+		take(rcl[clever::random_index(rcl.size())]);
 	}
-	candidate.cost = cost(candidate.vector, cities);
+	candidate.cost = clever::tour_cost(candidate.vector, distance);
 }
 
 
-void search(candidate_solution& best, std::vector<std::vector<double>>& cities,
+void search(candidate_solution& best, const std::vector<std::vector<double>>& cities,
             const size_t max_iter, const size_t max_no_improv, const double alpha)
 {
+	const clever::distance_provider distance(cities);
+	size_t evaluations = 0;
 	for (size_t iter = 0; iter < max_iter; ++iter)
 	{
 		candidate_solution candidate;
-		construct_randomized_greedy_solution(candidate, cities, alpha);
-		local_search(candidate, cities, max_no_improv);
+		construct_randomized_greedy_solution(candidate, distance, alpha);
+		evaluations += 1 + clever::two_opt_local_search(candidate, cities, max_no_improv);
 		if (iter == 0)
 		{
 			best = candidate;
@@ -150,31 +74,27 @@ void search(candidate_solution& best, std::vector<std::vector<double>>& cities,
 			}
 		}
 		std::cout << " > iteration " << (iter + 1) << ", best=" << best.cost << std::endl;
+		clever::trace_progress(evaluations, best.cost);
 	}
 }
 
 
 int main(int argc, char* argv[])
 {
-	// problem configuration
-	std::vector<std::vector<double>> berlin52 = {
-		{565, 575}, {25, 185}, {345, 750}, {945, 685}, {845, 655},
-		{880, 660}, {25, 230}, {525, 1000}, {580, 1175}, {650, 1130}, {1605, 620},
-		{1220, 580}, {1465, 200}, {1530, 5}, {845, 680}, {725, 370}, {145, 665},
-		{415, 635}, {510, 875}, {560, 365}, {300, 465}, {520, 585}, {480, 415},
-		{835, 625}, {975, 580}, {1215, 245}, {1320, 315}, {1250, 400}, {660, 180},
-		{410, 250}, {420, 555}, {575, 665}, {1150, 1160}, {700, 580}, {685, 595},
-		{685, 610}, {770, 610}, {795, 645}, {720, 635}, {760, 650}, {475, 960},
-		{95, 260}, {875, 920}, {700, 500}, {555, 815}, {830, 485}, {1170, 65},
-		{830, 610}, {605, 625}, {595, 360}, {1340, 725}, {1740, 245}
-	};
+	// problem configuration, a TSPLIB instance may be given instead of berlin52
+	auto cities = clever::berlin52();
+	if (argc > 1 && !clever::load_tsplib(argv[1], cities))
+	{
+		std::cout << "Cannot read the TSPLIB instance " << argv[1] << std::endl;
+		return 1;
+	}
 	// algorithm configuration
 	const size_t max_iter = 50;
 	const size_t max_no_improv = 50;
-	const size_t greediness_factor = 70;
+	const double greediness_factor = 0.3;
 	// execute the algorithm
 	candidate_solution best;
-	search(best, berlin52, max_iter, max_no_improv, greediness_factor);
+	search(best, cities, max_iter, max_no_improv, greediness_factor);
 
 	std::cout << "Done. Best Solution: c=" << best.cost << ", v={ ";
 	for (auto & i : best.vector)
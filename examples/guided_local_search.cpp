@@ -1,14 +1,10 @@
 #include <iostream>
 #include <numeric>
-#include <random>
+#include <cmath>
 #include <vector>
 #include <algorithm>
 
-
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_real_distribution<> distribution(0.0, 1.0);
-auto random_ = []() { return distribution(generator); };
+#include "clever_algorithm.h"
 
 
 using candidate_solution = struct candidate_solution_t
@@ -19,62 +15,8 @@ using candidate_solution = struct candidate_solution_t
 };
 
 
-double euc_2d(std::vector<double>& c1, std::vector<double>& c2)
-{
-	return sqrt((c1[0] - c2[0]) * (c1[0] - c2[0]) + (c1[1] - c2[1]) * (c1[1] - c2[1]));
-}
-
-
-void random_permutation(std::vector<size_t>& perm, std::vector<std::vector<double>>& cities)
-{
-	perm.resize(cities.size());
-	for (size_t i = 0; i < cities.size(); ++i)
-	{
-		perm[i] = i;
-	}
-	for (size_t i = 0; i < perm.size(); ++i)
-	{
-		const auto r = static_cast<size_t>((perm.size() - 1 - i) * random_() + i);
-		const size_t tmp = perm[r];
-		perm[r] = perm[i];
-		perm[i] = tmp;
-	}
-}
-
-
-void stochastic_two_opt(std::vector<size_t>& perm, std::vector<size_t>& permutation)
-{
-	perm.resize(permutation.size());
-	perm.assign(permutation.begin(), permutation.end());
-	auto c1 = static_cast<size_t>((perm.size() - 1) * random_());
-	auto c2 = static_cast<size_t>((perm.size() - 1) * random_());
-	std::vector<size_t> exclude;
-	exclude.push_back(c1);
-	exclude.push_back(c1 == 0 ? perm.size() - 1 : c1 - 1);
-	exclude.push_back(c1 == perm.size() - 1 ? 0 : c1 + 1);
-	while (std::find(exclude.begin(), exclude.end(), c2) != exclude.end())
-	{
-		c2 = static_cast<size_t>((perm.size() - 1) * random_());
-	}
-
-	if (c2 < c1)
-	{
-		const size_t tmp = c1;
-		c1 = c2;
-		c2 = tmp;
-	}
-
-	for (size_t i = c1; i < (c2 - c1) / 2; ++i)
-	{
-		const size_t tmp = perm[i];
-		perm[i] = perm[c2 - 1 - i + c1];
-		perm[c2 - 1 - i + c1] = tmp;
-	}
-}
-
-
 void augmented_cost(double& distance, double& augmented, std::vector<size_t>& permutation,
-                    std::vector<std::vector<double>>& penalties, std::vector<std::vector<double>>& cities,
+                    std::vector<std::vector<double>>& penalties, const clever::distance_provider& cities,
                     const double lambda)
 {
 	distance = 0.0;
@@ -89,7 +31,7 @@ void augmented_cost(double& distance, double& augmented, std::vector<size_t>& pe
 			c1 = c2;
 			c2 = tmp;
 		}
-		const double d = euc_2d(cities[c1], cities[c2]);
+		const double d = cities(c1, c2);
 		distance += d;
 		augmented += d + (lambda * (penalties[c1][c2]));
 	}
@@ -97,36 +39,44 @@ void augmented_cost(double& distance, double& augmented, std::vector<size_t>& pe
 
 
 void cost(candidate_solution& cand, std::vector<std::vector<double>>& penalties,
-          std::vector<std::vector<double>>& cities, const double lambda)
+          const clever::distance_provider& cities, const double lambda)
 {
 	augmented_cost(cand.cost, cand.aug_cost, cand.vector, penalties, cities, lambda);
 }
 
 
-void local_search(candidate_solution& current, std::vector<std::vector<double>>& cities,
-                  std::vector<std::vector<double>>& penalties, const size_t max_no_improv, const double lambda)
+// returns the number of moves evaluated
+size_t local_search(candidate_solution& current, const clever::distance_provider& cities,
+                    std::vector<std::vector<double>>& penalties, const size_t max_no_improv, const double lambda)
 {
 	cost(current, penalties, cities, lambda);
 	size_t count = 0;
+	size_t evaluations = 1;
 	while (count < max_no_improv)
 	{
-		candidate_solution candidate;
-		stochastic_two_opt(candidate.vector, current.vector);
-		cost(candidate, penalties, cities, lambda);
-		count = (candidate.aug_cost < current.aug_cost) ? 0 : count + 1;
-		if (candidate.aug_cost < current.aug_cost)
+		++evaluations;
+		const auto move = clever::random_two_opt_move(current.vector.size());
+		size_t a, b, c, d;
+		clever::two_opt_cities(current.vector, move, a, b, c, d);
+		const auto delta = clever::two_opt_delta(current.vector, move, cities);
+		const auto penalty = penalties[std::min(a, c)][std::max(a, c)] + penalties[std::min(b, d)][std::max(b, d)]
+			- penalties[std::min(a, b)][std::max(a, b)] - penalties[std::min(c, d)][std::max(c, d)];
+		const auto aug_delta = delta + lambda * penalty;
+		count = aug_delta < 0.0 ? 0 : count + 1;
+		if (aug_delta < 0.0)
 		{
-			current.vector = candidate.vector;
-			current.cost = candidate.cost;
-			current.aug_cost = candidate.aug_cost;
+			clever::apply_two_opt(current.vector, move);
+			current.cost += delta;
+			current.aug_cost += aug_delta;
 		}
 	}
+	return evaluations;
 }
 
 
 void calculate_feature_utilities(std::vector<double>& utilities,
                                  std::vector<std::vector<double>>& penal,
-                                 std::vector<std::vector<double>>& cities, std::vector<size_t>& permutation)
+                                 const clever::distance_provider& cities, std::vector<size_t>& permutation)
 {
 	utilities.resize(permutation.size());
 	for (size_t i = 0; i < permutation.size(); ++i)
@@ -143,13 +93,13 @@ void calculate_feature_utilities(std::vector<double>& utilities,
 			c1 = c2;
 			c2 = tmp;
 		}
-		utilities[i] = euc_2d(cities[c1], cities[c2]) / (1.0 + penal[c1][c2]);
+		utilities[i] = cities(c1, c2) / (1.0 + penal[c1][c2]);
 	}
 }
 
 
 void update_penalties(std::vector<std::vector<double>>& penalties,
-                      std::vector<std::vector<double>>& cities,
+                      const clever::distance_provider& cities,
                       std::vector<size_t>& permutation, std::vector<double>& utilities)
 {
 	const auto max = *max_element(utilities.begin(), utilities.end());
@@ -172,10 +122,11 @@ void update_penalties(std::vector<std::vector<double>>& penalties,
 
 
 void search(candidate_solution& best, const size_t max_iterations,
-            std::vector<std::vector<double>>& cities, const size_t max_no_improv, const double lambda)
+            const std::vector<std::vector<double>>& cities, const size_t max_no_improv, const double lambda)
 {
+	const clever::distance_provider distance(cities);
 	candidate_solution current;
-	random_permutation(current.vector, cities);
+	clever::random_permutation(current.vector, cities.size());
 	std::vector<std::vector<double>> penalties;
 	for (size_t i = 0; i < cities.size(); ++i)
 	{
@@ -187,12 +138,13 @@ void search(candidate_solution& best, const size_t max_iterations,
 		penalties.push_back(penalty);
 	}
 
+	size_t evaluations = 0;
 	for (size_t iter = 0; iter < max_iterations; ++iter)
 	{
-		local_search(current, cities, penalties, max_no_improv, lambda);
+		evaluations += local_search(current, distance, penalties, max_no_improv, lambda);
 		std::vector<double> utilities;
-		calculate_feature_utilities(utilities, penalties, cities, current.vector);
-		update_penalties(penalties, cities, current.vector, utilities);
+		calculate_feature_utilities(utilities, penalties, distance, current.vector);
+		update_penalties(penalties, distance, current.vector, utilities);
 		if (iter == 0)
 		{
 			best = current;
@@ -203,33 +155,29 @@ void search(candidate_solution& best, const size_t max_iterations,
 		}
 
 		std::cout << " > iteration " << iter + 1 << ", best=" << best.cost << std::endl;
+		clever::trace_progress(evaluations, best.cost);
 	}
 }
 
 
 int main(int argc, char* argv[])
 {
-	// problem configuration
-	std::vector<std::vector<double>> berlin52 = {
-		{565, 575}, {25, 185}, {345, 750}, {945, 685}, {845, 655},
-		{880, 660}, {25, 230}, {525, 1000}, {580, 1175}, {650, 1130}, {1605, 620},
-		{1220, 580}, {1465, 200}, {1530, 5}, {845, 680}, {725, 370}, {145, 665},
-		{415, 635}, {510, 875}, {560, 365}, {300, 465}, {520, 585}, {480, 415},
-		{835, 625}, {975, 580}, {1215, 245}, {1320, 315}, {1250, 400}, {660, 180},
-		{410, 250}, {420, 555}, {575, 665}, {1150, 1160}, {700, 580}, {685, 595},
-		{685, 610}, {770, 610}, {795, 645}, {720, 635}, {760, 650}, {475, 960},
-		{95, 260}, {875, 920}, {700, 500}, {555, 815}, {830, 485}, {1170, 65},
-		{830, 610}, {605, 625}, {595, 360}, {1340, 725}, {1740, 245}
-	};
+	// problem configuration, a TSPLIB instance may be given instead of berlin52
+	auto cities = clever::berlin52();
+	if (argc > 1 && !clever::load_tsplib(argv[1], cities))
+	{
+		std::cout << "Cannot read the TSPLIB instance " << argv[1] << std::endl;
+		return 1;
+	}
 	// algorithm configuration
 	const size_t max_iterations = 150;
 	const size_t max_no_improv = 20;
 	const double alpha = 0.3;
 	const double local_search_optima = 12000.0;
-	const double lambda = alpha * (local_search_optima / static_cast<double>(berlin52.size()));
+	const double lambda = alpha * (local_search_optima / static_cast<double>(cities.size()));
 	// execute the algorithm
 	candidate_solution best;
-	search(best, max_iterations, berlin52, max_no_improv, lambda);
+	search(best, max_iterations, cities, max_no_improv, lambda);
 
 	std::cout << "Done. Best Solution: c=" << best.cost << ", v={ ";
 	for (unsigned int i : best.vector)
@@ -1,14 +1,9 @@
 #include <iostream>
-#include <random>
 #include <vector>
 #include <string>
 #include <algorithm>
 
-
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_real_distribution<> distribution(0.0, 1.0);
-auto random_ = []() { return distribution(generator); };
+#include "clever_algorithm.h"
 
 
 using candidate_solution = struct candidate_solution_st
@@ -18,41 +13,16 @@ using candidate_solution = struct candidate_solution_st
 };
 
 
-double objective_function(const std::vector<double>& vector)
+void evaluate(candidate_solution& harmony)
 {
-	double sum = 0.0;
-	for (const double& i : vector)
-	{
-		sum += i * i;
-	}
-
-	return sum;
-}
-
-
-double rand_in_bounds(const double min, const double max)
-{
-	return min + (max - min) * random_();
-}
-
-
-void random_vector(std::vector<double>& vector,
-                   const std::vector<std::vector<double>>& search_space)
-{
-	vector.clear();
-	vector.resize(search_space.size());
-	for (size_t i = 0; i < vector.size(); ++i)
-	{
-		vector[i] = rand_in_bounds(search_space[i][0], search_space[i][1]);
-	}
+	harmony.fitness = clever::sphere_function(harmony.vector);
 }
 
 
 void create_random_harmony(candidate_solution& harmony,
                            const std::vector<std::vector<double>>& search_space)
 {
-	random_vector(harmony.vector, search_space);
-	harmony.fitness = objective_function(harmony.vector);
+	clever::random_vector(harmony.vector, search_space);
 }
 
 
@@ -77,6 +47,7 @@ void initialize_harmony_memory(std::vector<candidate_solution>& memory,
 	{
 		create_random_harmony(item, search_space);
 	}
+	clever::evaluate_population(memory, evaluate);
 	std::sort(memory.begin(), memory.end(), cmp_fitness);
 
 	memory.resize(mem_size);
@@ -95,11 +66,11 @@ void create_harmony(std::vector<double>& vector,
 	vector.resize(search_space.size());
 	for (size_t i = 0; i < vector.size(); ++i)
 	{
-		if (random_() < consid_rate)
+		if (clever::random_uniform() < consid_rate)
 		{
-			auto value = memory[static_cast<size_t>(random_() * (memory.size() - 1))].vector[i];
-			if (random_() < adjust_rate)
-				value += range * rand_in_bounds(-1.0, 1.0);
+			auto value = memory[static_cast<size_t>(clever::random_uniform() * (memory.size() - 1))].vector[i];
+			if (clever::random_uniform() < adjust_rate)
+				value += range * clever::rand_in_bounds(-1.0, 1.0);
 
 			if (value < search_space[i][0])
 				value = search_space[i][0];
@@ -111,7 +82,7 @@ void create_harmony(std::vector<double>& vector,
 		}
 		else
 		{
-			vector[i] = rand_in_bounds(search_space[i][0], search_space[i][1]);
+			vector[i] = clever::rand_in_bounds(search_space[i][0], search_space[i][1]);
 		}
 	}
 }
@@ -130,7 +101,7 @@ void search(candidate_solution& best,
 	{
 		candidate_solution harm;
 		create_harmony(harm.vector, bounds, memory, consid_rate, adjust_rate, range);
-		harm.fitness = objective_function(harm.vector);
+		evaluate(harm);
 		if (harm.fitness < best.fitness)
 		{
 			best = harm;
@@ -140,6 +111,7 @@ void search(candidate_solution& best,
 		memory.pop_back();
 		std::cout << " > iteration " << iter + 1 << ", fitness = "
 			<< best.fitness << std::endl;
+		clever::trace_progress(3 * meme_size + iter + 1, best.fitness);
 	}
 }
 
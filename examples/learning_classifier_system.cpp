@@ -1,69 +1,143 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <functional>
 #include <iostream>
-#include <random>
-#include <vector>
+#include <memory>
 #include <string>
-#include <algorithm>
-#include <map>
-
+#include <vector>
 
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_real_distribution<> distribution(0.0, 1.0);
-auto random_ = []() { return distribution(generator); };
+#include "clever_algorithm.h"
 
 
+// Prediction of one action over a match set; a prediction array holds one
+// per action, indexed by action.
 using prediction_storage = struct prediction_st
 {
 	double sum = 0.0;
 	double count = 0.0;
 	double weight = 0.0;
+	// classifiers of the match set advocating the action
+	size_t size = 0;
 };
 
 
-typedef std::map<std::string, prediction_storage> prediction_solution;
+typedef std::vector<prediction_storage> prediction_array;
+
+
+// One decision of a stream: the input and the reward each action earns.
+using problem_info = struct problem_info_t
+{
+	clever::bit_string input;
+	std::vector<double> rewards;
+};
+
+
+// Streaming environment: fills batch with up to batch.size() problems and
+// returns how many it wrote, 0 once the stream has ended.
+typedef std::function<size_t(std::vector<problem_info> &)> environment;
 
 
 using classifier_solution = struct classifier_solution_t
 {
-	std::string condition;
-	std::string action;
+	clever::ternary_condition condition;
+	// index into the actions of the problem
+	size_t action = 0;
 	size_t lasttime = 0;
 	double pred = 0.0;
 	double error = 0.0;
 	double fitness = 0.0;
 	double exp = 0;
-	size_t setsize = 0;
+	double setsize = 0.0;
 	size_t num = 0;
 	double dvote = 0.0;
 };
 
 
+// The classifiers in slots, with their conditions also held bit-sliced in
+// a match_index. Deleting a classifier moves the last one into its slot.
+using population_info = struct population_info_t
+{
+	std::vector<classifier_solution> classifiers;
+	clever::match_index index;
+	// match sets come from the index rather than from a scan of the slots
+	bool use_index = true;
+};
 
-int neg(const int bit)
+
+
+// The k-multiplexer: the first address_bits bits select one of the data
+// bits that follow, which is the answer. address_bits = 2 is the
+// classic 6-multiplexer.
+size_t multiplexer(const clever::bit_string & input, const size_t address_bits)
 {
-	return bit == 1 ? 0 : 1;
+	size_t address = 0;
+	for(size_t i = 0; i < address_bits; ++i)
+	{
+		address = (address << 1) | (input[i] ? 1 : 0);
+	}
+	return input[address_bits + address] ? 1 : 0;
 }
 
 
-int target_function(const std::string & s)
+// count random multiplexer problems, rewarding the right answer with 1000
+environment multiplexer_stream(const size_t address_bits, const size_t count, const std::uint64_t seed)
 {
-	const size_t n = s.size();
-	int * ints = static_cast<int*>(malloc(sizeof(int) * n));
-	for(size_t i = 0; i < n; ++i)
+	const size_t length = address_bits + (size_t(1) << address_bits);
+	clever::random_engine rng(seed);
+	size_t remaining = count;
+	return [=](std::vector<problem_info> & batch) mutable
 	{
-		ints[i] = s[i] - 48;
-	}
+		const auto n = std::min(batch.size(), remaining);
+		for(size_t k = 0; k < n; ++k)
+		{
+			auto & problem = batch[k];
+			clever::random_bit_string(problem.input, length, rng);
+			problem.rewards.assign(2, 0.0);
+			problem.rewards[multiplexer(problem.input, address_bits)] = 1000.0;
+		}
+		remaining -= n;
+		return n;
+	};
+}
 
-	auto tmp = (neg(ints[0]) * neg(ints[1]) * ints[2] + neg(ints[0]) * ints[1] * ints[3] 
-		+ ints[0] * neg(ints[1]) * ints[4] + ints[0] * ints[1] * ints[5]);
-	free(ints);
 
-	return tmp;
+// Problems read from lines "<input bits> <correct action>", rewarding the
+// correct action with 1000. Lines whose input length differs from the
+// first one, or whose action is out of range, are skipped.
+environment file_stream(const std::shared_ptr<std::istream> & in, const size_t num_actions)
+{
+	size_t length = 0;
+	return [=](std::vector<problem_info> & batch) mutable
+	{
+		size_t n = 0;
+		std::string bits;
+		size_t action;
+		while(n < batch.size() && *in >> bits >> action)
+		{
+			length = length == 0 ? bits.size() : length;
+			if(bits.size() != length || action >= num_actions)
+			{
+				continue;
+			}
+			auto & problem = batch[n++];
+			problem.input.resize(length);
+			for(size_t i = 0; i < length; ++i)
+			{
+				problem.input.set(i, bits[i] == '1');
+			}
+			problem.rewards.assign(num_actions, 0.0);
+			problem.rewards[action] = 1000.0;
+		}
+		return n;
+	};
 }
 
 
-void new_classifier(classifier_solution & other, const std::string & condition,
-	const std::string & action, const size_t gen, const double p1 = 10.0,
+void new_classifier(classifier_solution & other, const clever::ternary_condition & condition,
+	const size_t action, const size_t gen, const double p1 = 10.0,
 	const double e1 = 0.0, const double f1 = 10.0)
 {
 	other.condition = condition;
@@ -73,7 +147,7 @@ void new_classifier(classifier_solution & other, const std::string & condition,
 	other.error = e1;
 	other.fitness = f1;
 	other.exp = 0.0;
-	other.setsize = 1;
+	other.setsize = 1.0;
 	other.num = 1;
 }
 
@@ -93,188 +167,599 @@ void copy_classifier(classifier_solution & child, const classifier_solution & pa
 }
 
 
-void random_bitstring(std::string & bitstring, const size_t size = 6)
+// total and avg_fitness are taken over the whole population once per deletion
+double calculate_deletion_vote(const classifier_solution & classifier, const double avg_fitness,
+	const double del_thresh, const double f_thresh = 0.1)
 {
-	bitstring.clear();
-	bitstring.resize(size);
-	for(size_t i = 0; i < size; ++i)
+	auto  vote = classifier.setsize * classifier.num;
+	const auto derated = classifier.fitness / classifier.num;
+	if(classifier.exp > del_thresh && derated < f_thresh * avg_fitness)
 	{
-		bitstring[i] = random_() < 0.5 ? '1' : '0';
+		return vote * (avg_fitness / derated);
 	}
+
+	return vote;
 }
 
 
-double calculate_deletion_vote(classifier_solution & classifier, const std ::vector<classifier_solution> & pop,
-	const double del_thresh, const double f_thresh = 0.1)
+void add_classifier(population_info & pop, const classifier_solution & classifier)
 {
-	auto  vote = classifier.setsize * classifier.num;
-	double total = 0;
-	for (const auto& i : pop)
-	{
-		total += i.num;
-	}
+	pop.index.insert(pop.classifiers.size(), classifier.condition);
+	pop.classifiers.push_back(classifier);
+}
 
-	double avg_fitness = 0.0;
-	for(const auto & item: pop)
-	{
-		avg_fitness += item.fitness;
-	}
-	avg_fitness /= total;
 
-	const auto derated = classifier.fitness / classifier.num;
-	if(classifier.exp > del_thresh && derated < f_thresh * avg_fitness)
+// Removes the classifier in slot by moving the last one into it, and
+// keeps the slots of match_set pointing at the same classifiers.
+void remove_classifier(population_info & pop, const size_t slot, std::vector<size_t> & match_set)
+{
+	const auto last = pop.classifiers.size() - 1;
+	match_set.erase(std::remove(match_set.begin(), match_set.end(), slot), match_set.end());
+	if(slot != last)
 	{
-		return vote * (avg_fitness / derated);
+		pop.classifiers[slot] = pop.classifiers[last];
+		pop.index.insert(slot, pop.classifiers[slot].condition);
+		std::replace(match_set.begin(), match_set.end(), last, slot);
 	}
-
-	return vote;
+	pop.index.erase(last);
+	pop.classifiers.pop_back();
 }
 
 
-void delete_from_pop(std::vector<classifier_solution> & pop, const size_t pop_size,
+void delete_from_pop(population_info & pop, const size_t pop_size, std::vector<size_t> & match_set,
 	const double del_thresh = 20.0)
 {
+	auto & classifiers = pop.classifiers;
 	double total = 0.0;
-	for(const auto & item : pop)
+	double avg_fitness = 0.0;
+	for(const auto & item : classifiers)
 	{
 		total += item.num;
+		avg_fitness += item.fitness;
 	}
 	if(total <= pop_size)
 	{
 		return;
 	}
+	avg_fitness /= total;
 
 	double vote_sum = 0.0;
-	for(auto & item : pop)
+	for(auto & item : classifiers)
 	{
-		item.dvote = calculate_deletion_vote(item, pop, del_thresh);
+		item.dvote = calculate_deletion_vote(item, avg_fitness, del_thresh);
 		vote_sum += item.dvote;
 	}
 
-	const size_t point = static_cast<size_t>(vote_sum * random_());
+	const double point = vote_sum * clever::random_uniform();
 	vote_sum = 0.0;
 	size_t index = 0;
-	for(size_t i = 0; i < pop.size(); ++i)
+	for(size_t i = 0; i < classifiers.size(); ++i)
 	{
-		vote_sum += pop[i].dvote;
+		vote_sum += classifiers[i].dvote;
 		if(vote_sum >= point)
 		{
 			index = i;
 			break;
 		}
 	}
-	if (pop[index].num > 1)
+	if (classifiers[index].num > 1)
 	{
-		pop[index].num -= 1;
+		classifiers[index].num -= 1;
 	}
 	else
 	{
-		pop.erase(pop.begin() + static_cast<int>(index));
+		remove_classifier(pop, index, match_set);
 	}
 }
 
 
-void generate_random_classifier(classifier_solution & classifier, const std::string & input,
-	const std::vector<std::string> & actions, const size_t gen, const double rate = 1.0 / 3.0)
+void generate_random_classifier(classifier_solution & classifier, const clever::bit_string & input,
+	const std::vector<size_t> & actions, const size_t gen, const double rate = 1.0 / 3.0)
 {
-	std::string condition;
-	for(auto & c : input)
+	clever::ternary_condition condition;
+	condition.care = clever::bit_string(input.size());
+	condition.value = clever::bit_string(input.size());
+	for(size_t i = 0; i < input.size(); ++i)
 	{
-		condition.push_back(random_() < rate ? '#' : c);
+		clever::set_symbol(condition, i, clever::random_uniform() < rate ? '#' : (input[i] ? '1' : '0'));
 	}
-	const std::string action = actions[static_cast<size_t>((actions.size() - 1) * random_())];
+	const auto action = actions[clever::random_index(actions.size())];
 	new_classifier(classifier, condition, action, gen);
 }
 
 
-bool does_match(const std::string & input, const std::string & condition)
+// covered[a] is set when some classifier of match_set advocates action a
+void get_actions(std::vector<char> & covered, const std::vector<size_t> & match_set,
+	const population_info & pop, const size_t num_actions)
 {
-	for(size_t i = 0; i < input.size(); ++i)
+	covered.assign(num_actions, 0);
+	for(const auto slot : match_set)
 	{
-		if(condition[i] != '#' && input[i] != condition[i])
-		{
-			return false;
-		}
+		covered[pop.classifiers[slot].action] = 1;
 	}
-	return true;
 }
 
 
-void get_actions(std::vector <std::string > & actions, const std::vector<classifier_solution> & pop)
+// Slots of the classifiers matching input, ascending, from the index or,
+// with use_index off, from a word-wise test of every condition.
+void match(std::vector<size_t> & match_set, const clever::bit_string & input, const population_info & pop)
 {
-	actions.clear();
-	for(auto & item : pop)
+	if(pop.use_index)
 	{
-		if(std::find(actions.begin(), actions.end(), item.action) == actions.end())
+		pop.index.match(input, match_set);
+		return;
+	}
+	match_set.clear();
+	for(size_t i = 0; i < pop.classifiers.size(); ++i)
+	{
+		if(clever::matches(pop.classifiers[i].condition, input))
 		{
-			actions.push_back(item.action);
+			match_set.push_back(i);
 		}
 	}
 }
 
 
-void generate_match_set(std::vector<classifier_solution> & match_set, 
-	const std::string & input, std::vector<classifier_solution> & pop,
-	const std::vector<std::string> & all_actions, const size_t gen,
+// The match set of input, with actions no classifier advocates covered by
+// new random classifiers.
+void generate_match_set(std::vector<size_t> & match_set,
+	const clever::bit_string & input, population_info & pop,
+	const size_t num_actions, const size_t gen,
 	const size_t pop_size)
 {
-	match_set.clear();
-	for(const auto & c : pop)
+	match(match_set, input, pop);
+	std::vector<char> covered;
+	get_actions(covered, match_set, pop, num_actions);
+	std::vector<size_t> remaining;
+	for(;;)
 	{
-		if (does_match(input, c.condition))
-			match_set.push_back(c);
-	}
-	std::vector <std::string> actions;
-	get_actions(actions, match_set);
-	while(actions.size() < all_actions.size())
-	{
-		std::vector<std::string> remaining;
-		std::set_difference(all_actions.begin(), all_actions.end(),
-			actions.begin(), actions.end(),
-			std::back_inserter(remaining));
+		remaining.clear();
+		for(size_t a = 0; a < num_actions; ++a)
+		{
+			if(!covered[a])
+			{
+				remaining.push_back(a);
+			}
+		}
+		if(remaining.empty())
+		{
+			break;
+		}
 		classifier_solution classifier;
 		generate_random_classifier(classifier, input, remaining, gen);
-		pop.push_back(classifier);
-		match_set.push_back(classifier);
-		delete_from_pop(pop, pop_size);
-		actions.push_back(classifier.action);
+		add_classifier(pop, classifier);
+		match_set.push_back(pop.classifiers.size() - 1);
+		// the deletion may take the new classifier, or another member of
+		// the match set, so the covered actions are counted again
+		delete_from_pop(pop, pop_size, match_set);
+		get_actions(covered, match_set, pop, num_actions);
 	}
 }
 
 
-void generate_prediction(prediction_solution pred, const std::vector<classifier_solution> & match_set)
+void generate_prediction(prediction_array & pred, const std::vector<size_t> & match_set,
+	const population_info & pop, const size_t num_actions)
 {
-	for(auto & classifier : match_set)
+	pred.assign(num_actions, prediction_storage());
+	for(const auto slot : match_set)
 	{
-		auto key = classifier.action;
-		prediction_storage ps;
-		pred.insert({ key, ps });
-		pred[key].sum += classifier.pred * classifier.fitness;
-		pred[key].count += classifier.fitness;
+		const auto & classifier = pop.classifiers[slot];
+		auto & item = pred[classifier.action];
+		item.sum += classifier.pred * classifier.fitness;
+		item.count += classifier.fitness;
+		item.size += 1;
 	}
 
 	for(auto & item: pred)
 	{
-		item.second.weight = 0.0;
-		if(item.second.count > 0)
+		item.weight = 0.0;
+		if(item.count > 0)
 		{
-			item.second.weight = item.second.sum / item.second.count;
+			item.weight = item.sum / item.count;
 		}
 	}
 }
 
-void select_action(std::string & key, const prediction_solution & predictions, const bool p_explore = false)
+
+// A random advocated action when exploring, else the one with the highest
+// prediction; predictions.size() when the match set advocates none.
+void select_action(size_t & action, const prediction_array & predictions, const bool p_explore = false)
 {
-	
+	action = predictions.size();
+	if(p_explore)
+	{
+		size_t advocated = 0;
+		for(const auto & item : predictions)
+		{
+			advocated += item.size > 0 ? 1 : 0;
+		}
+		if(advocated == 0)
+		{
+			return;
+		}
+		auto pick = clever::random_index(advocated);
+		for(size_t a = 0; a < predictions.size(); ++a)
+		{
+			if(predictions[a].size > 0 && pick-- == 0)
+			{
+				action = a;
+				return;
+			}
+		}
+	}
+	for(size_t a = 0; a < predictions.size(); ++a)
+	{
+		if(predictions[a].size > 0 && (action == predictions.size() || predictions[a].weight > predictions[action].weight))
+		{
+			action = a;
+		}
+	}
+}
+
+
+void update_set(population_info & pop, const std::vector<size_t> & action_set, const double reward,
+	const double beta = 0.2)
+{
+	double sum = 0.0;
+	for(const auto slot : action_set)
+	{
+		sum += pop.classifiers[slot].num;
+	}
+	for(const auto slot : action_set)
+	{
+		auto & c = pop.classifiers[slot];
+		c.exp += 1.0;
+		if(c.exp < 1.0 / beta)
+		{
+			c.error = (c.error * (c.exp - 1.0) + std::fabs(reward - c.pred)) / c.exp;
+			c.pred = (c.pred * (c.exp - 1.0) + reward) / c.exp;
+			c.setsize = (c.setsize * (c.exp - 1.0) + sum) / c.exp;
+		}
+		else
+		{
+			c.error += beta * (std::fabs(reward - c.pred) - c.error);
+			c.pred += beta * (reward - c.pred);
+			c.setsize += beta * (sum - c.setsize);
+		}
+	}
 }
 
 
-void search()
+void update_fitness(population_info & pop, const std::vector<size_t> & action_set,
+	const double min_error = 10.0, const double l_rate = 0.2,
+	const double alpha = 0.1, const double v = -5.0)
 {
+	double sum = 0.0;
+	std::vector<double> acc(action_set.size());
+	for(size_t i = 0; i < action_set.size(); ++i)
+	{
+		const auto & c = pop.classifiers[action_set[i]];
+		acc[i] = c.error < min_error ? 1.0 : alpha * std::pow(c.error / min_error, v);
+		sum += acc[i] * c.num;
+	}
+	for(size_t i = 0; i < action_set.size(); ++i)
+	{
+		auto & c = pop.classifiers[action_set[i]];
+		c.fitness += l_rate * ((acc[i] * c.num) / sum - c.fitness);
+	}
 }
 
 
+bool can_run_genetic_algorithm(const population_info & pop, const std::vector<size_t> & action_set,
+	const size_t gen, const size_t ga_freq)
+{
+	if(action_set.size() <= 2)
+	{
+		return false;
+	}
+	double total = 0.0;
+	double sum = 0.0;
+	for(const auto slot : action_set)
+	{
+		const auto & c = pop.classifiers[slot];
+		total += static_cast<double>(c.lasttime) * c.num;
+		sum += c.num;
+	}
+	return gen - (total / sum) > ga_freq;
+}
+
+
+// the fitter of two distinct random members of the action set
+size_t binary_tournament(const population_info & pop, const std::vector<size_t> & action_set)
+{
+	const auto i = clever::random_index(action_set.size());
+	auto j = clever::random_index(action_set.size());
+	while(j == i)
+	{
+		j = clever::random_index(action_set.size());
+	}
+	const auto & a = pop.classifiers[action_set[i]];
+	const auto & b = pop.classifiers[action_set[j]];
+	return a.fitness > b.fitness ? action_set[i] : action_set[j];
+}
+
+
+// flips positions between '#' and the input's bit, and the action to
+// another one
+void mutation(classifier_solution & classifier, const size_t num_actions,
+	const clever::bit_string & input, const double rate = 0.04)
+{
+	auto & condition = classifier.condition;
+	for(size_t i = 0; i < condition.size(); ++i)
+	{
+		if(clever::random_uniform() < rate)
+		{
+			const auto ch = clever::symbol(condition, i) == '#' ? (input[i] ? '1' : '0') : '#';
+			clever::set_symbol(condition, i, ch);
+		}
+	}
+	if(num_actions > 1 && clever::random_uniform() < rate)
+	{
+		const auto other = clever::random_index(num_actions - 1);
+		classifier.action = other >= classifier.action ? other + 1 : other;
+	}
+}
+
+
+// every position comes from either parent, a word of care and value
+// bits at a time under one random mask
+void uniform_crossover(clever::ternary_condition & child, const clever::ternary_condition & parent1,
+	const clever::ternary_condition & parent2)
+{
+	child = parent1;
+	auto & rng = clever::default_engine();
+	for(size_t w = 0; w < child.care.num_words(); ++w)
+	{
+		const auto mask = static_cast<clever::bit_string::word_type>(rng());
+		child.care.words()[w] = (parent1.care.words()[w] & mask) | (parent2.care.words()[w] & ~mask);
+		child.value.words()[w] = (parent1.value.words()[w] & mask) | (parent2.value.words()[w] & ~mask);
+	}
+}
+
+
+void crossover(classifier_solution & c1, classifier_solution & c2,
+	const classifier_solution & p1, const classifier_solution & p2)
+{
+	uniform_crossover(c1.condition, p1.condition, p2.condition);
+	uniform_crossover(c2.condition, p1.condition, p2.condition);
+	c2.pred = c1.pred = (p1.pred + p2.pred) / 2.0;
+	c2.error = c1.error = 0.25 * (p1.error + p2.error) / 2.0;
+	c2.fitness = c1.fitness = 0.1 * (p1.fitness + p2.fitness) / 2.0;
+}
+
+
+// a copy of an existing classifier only raises its numerosity
+void insert_in_pop(population_info & pop, const classifier_solution & classifier)
+{
+	for(auto & c : pop.classifiers)
+	{
+		if(c.action == classifier.action && c.condition == classifier.condition)
+		{
+			c.num += 1;
+			return;
+		}
+	}
+	add_classifier(pop, classifier);
+}
+
+
+// Two children of the action set, deleting until the numerosity is back
+// to pop_size. The slots of action_set are kept valid through deletions.
+void run_ga(population_info & pop, std::vector<size_t> & action_set, const clever::bit_string & input,
+	const size_t pop_size, const size_t num_actions, const double crate = 0.8)
+{
+	const auto & p1 = pop.classifiers[binary_tournament(pop, action_set)];
+	const auto & p2 = pop.classifiers[binary_tournament(pop, action_set)];
+	classifier_solution children[2];
+	copy_classifier(children[0], p1);
+	copy_classifier(children[1], p2);
+	if(clever::random_uniform() < crate)
+	{
+		crossover(children[0], children[1], p1, p2);
+	}
+	for(auto & c : children)
+	{
+		mutation(c, num_actions, input);
+		insert_in_pop(pop, c);
+	}
+
+	size_t total = 0;
+	for(const auto & c : pop.classifiers)
+	{
+		total += c.num;
+	}
+	for(; total > pop_size; --total)
+	{
+		delete_from_pop(pop, pop_size, action_set);
+	}
+}
+
+
+// Problems seen, the exploit steps of the current report window, and
+// the wall time since training started.
+using performance_info = struct performance_info_t
+{
+	size_t problems = 0;
+	size_t exploits = 0;
+	double error = 0.0;
+	size_t correct = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	double problems_per_second() const
+	{
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		return elapsed.count() > 0.0 ? problems / elapsed.count() : 0.0;
+	}
+};
+
+
+// XCS on a stream: explore and exploit steps alternate, learning from the
+// explore steps and reporting error, accuracy and throughput over every
+// report exploit steps.
+void train_model(population_info & pop, environment & env, const size_t num_actions,
+	const size_t pop_size, const size_t ga_freq, const size_t batch_size = 64,
+	const size_t report = 50)
+{
+	std::vector<problem_info> batch(batch_size);
+	std::vector<size_t> match_set, action_set;
+	prediction_array pred;
+	performance_info perf;
+	double best_accuracy = 0.0;
+	size_t gen = 0;
+	for(size_t n = env(batch); n > 0; n = env(batch))
+	{
+		for(size_t k = 0; k < n; ++k, ++gen)
+		{
+			const auto & problem = batch[k];
+			if(pop.classifiers.empty() && pop.index.length() != problem.input.size())
+			{
+				pop.index = clever::match_index(problem.input.size());
+			}
+			const bool explore = gen % 2 == 0;
+			generate_match_set(match_set, problem.input, pop, num_actions, gen, pop_size);
+			generate_prediction(pred, match_set, pop, num_actions);
+			size_t action;
+			select_action(action, pred, explore);
+			++perf.problems;
+			// no action advocated counts as a miss, as in test_model
+			const bool advocated = action < num_actions;
+			const auto reward = advocated ? problem.rewards[action] : 0.0;
+			if(explore)
+			{
+				if(!advocated)
+				{
+					continue;
+				}
+				action_set.clear();
+				for(const auto slot : match_set)
+				{
+					if(pop.classifiers[slot].action == action)
+					{
+						action_set.push_back(slot);
+					}
+				}
+				update_set(pop, action_set, reward);
+				update_fitness(pop, action_set);
+				if(can_run_genetic_algorithm(pop, action_set, gen, ga_freq))
+				{
+					for(const auto slot : action_set)
+					{
+						pop.classifiers[slot].lasttime = gen;
+					}
+					run_ga(pop, action_set, problem.input, pop_size, num_actions);
+				}
+				continue;
+			}
+			if(advocated)
+			{
+				perf.error += std::fabs(pred[action].weight - reward);
+				perf.correct += reward == *std::max_element(problem.rewards.begin(), problem.rewards.end()) ? 1 : 0;
+			}
+			if(++perf.exploits >= report)
+			{
+				std::cout << " >iter=" << gen + 1 << " size=" << pop.classifiers.size()
+					<< ", error=" << std::round(perf.error / perf.exploits)
+					<< ", acc=" << static_cast<double>(perf.correct) / perf.exploits
+					<< ", problems/sec=" << static_cast<size_t>(perf.problems_per_second()) << std::endl;
+				best_accuracy = std::max(best_accuracy, static_cast<double>(perf.correct) / perf.exploits);
+				clever::trace_progress(perf.problems, best_accuracy);
+				perf.exploits = 0;
+				perf.error = 0.0;
+				perf.correct = 0;
+			}
+		}
+	}
+	std::cout << "Trained on " << perf.problems << " problems, "
+		<< static_cast<size_t>(perf.problems_per_second()) << " problems/sec" << std::endl;
+}
+
+
+// exploit only, without covering; a problem no classifier matches counts
+// as misclassified
+size_t test_model(const population_info & pop, environment & env, const size_t num_actions,
+	const size_t batch_size = 64)
+{
+	std::vector<problem_info> batch(batch_size);
+	std::vector<size_t> match_set;
+	prediction_array pred;
+	performance_info perf;
+	size_t correct = 0;
+	for(size_t n = env(batch); n > 0; n = env(batch))
+	{
+		for(size_t k = 0; k < n; ++k)
+		{
+			const auto & problem = batch[k];
+			match(match_set, problem.input, pop);
+			generate_prediction(pred, match_set, pop, num_actions);
+			size_t action;
+			select_action(action, pred, false);
+			++perf.problems;
+			if(action < num_actions
+				&& problem.rewards[action] == *std::max_element(problem.rewards.begin(), problem.rewards.end()))
+			{
+				++correct;
+			}
+		}
+	}
+	std::cout << "Done! classified correctly=" << correct << "/" << perf.problems
+		<< ", problems/sec=" << static_cast<size_t>(perf.problems_per_second()) << std::endl;
+	return correct;
+}
+
+
+// trains on train, then tests on test when it is set
+void search(population_info & pop, environment & train, environment & test, const size_t num_actions,
+	const size_t pop_size, const size_t ga_freq)
+{
+	train_model(pop, train, num_actions, pop_size, ga_freq);
+	if(test)
+	{
+		test_model(pop, test, num_actions);
+	}
+}
+
+
+// With a file argument ("-" for standard input) the system trains on the
+// problems it holds, one "<input bits> <correct action>" per line;
+// otherwise on the 6-multiplexer, then tests on fresh problems.
 int main(int argc, char* argv[])
 {
+	// problem configuration
+	const size_t address_bits = 2;
+	const size_t num_actions = 2;
+	// algorithm configuration
+	const size_t pop_size = 200;
+	const size_t max_gens = 5000;
+	const size_t ga_freq = 25;
+	const size_t num_trials = 50;
+
+	const auto seed = clever::default_engine()();
+	environment train, test;
+	if(argc > 1)
+	{
+		std::shared_ptr<std::istream> in;
+		if(std::string(argv[1]) == "-")
+		{
+			in.reset(&std::cin, [](std::istream *) {});
+		}
+		else
+		{
+			in = std::make_shared<std::ifstream>(argv[1]);
+		}
+		if(!*in)
+		{
+			std::cerr << "cannot read " << argv[1] << std::endl;
+			return 1;
+		}
+		train = file_stream(in, num_actions);
+	}
+	else
+	{
+		train = multiplexer_stream(address_bits, max_gens, seed);
+		test = multiplexer_stream(address_bits, num_trials, seed + 1);
+	}
+
+	population_info pop;
+	search(pop, train, test, num_actions, pop_size, ga_freq);
 	return 0;
 }
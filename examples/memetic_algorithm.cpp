@@ -1,123 +1,80 @@
 #include <iostream>
-#include <random>
 #include <vector>
-#include <string>
 #include <algorithm>
 #include <cfloat>
+#include <cmath>
 
-
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_real_distribution<> distribution(0.0, 1.0);
-auto random_ = []() { return distribution(generator); };
+#include "clever_algorithm.h"
 
 
 using candidate_solution = struct candidate_solution_st
 {
 	std::vector<double> vector;
-	std::string bit_string;
+	clever::bit_string bit_string;
 	double fitness = DBL_MAX;
 };
 
 
-double objective_function(const std::vector<double>& vector)
-{
-	double sum = 0.0;
-	for (const double& i : vector)
-	{
-		sum += i * i;
-	}
-
-	return sum;
-}
-
-
-void random_bit_string(std::string& bit_string, const size_t num_bits)
-{
-	bit_string.clear();
-	for (size_t i = 0; i < num_bits; ++i)
-	{
-		bit_string.push_back(random_() < 0.5 ? '1' : '0');
-	}
-}
-
-
 void decode(std::vector<double>& vector,
-            const std::string& bit_string,
+            const clever::bit_string& bit_string,
             const std::vector<std::vector<double>>& search_space,
             const size_t bits_per_param)
 {
 	vector.clear();
+	const auto scale = 1.0 / (pow(2.0, bits_per_param) - 1.0);
 	for (size_t i = 0; i < search_space.size(); ++i)
 	{
 		auto& bounds = search_space[i];
 		const auto off = i * bits_per_param;
+		// the first bit of a parameter is its most significant one
 		auto sum = 0.0;
-		std::string param;
-		for (size_t j = off + bits_per_param; j > off; --j)
+		for (size_t j = off; j < off + bits_per_param; ++j)
 		{
-			param.push_back(bit_string[j]);
-		}
-		for (size_t k = 0; k < param.size(); ++k)
-		{
-			sum += (param[k] == '1' ? 1.0 : 0.0) * pow(2.0, k);
+			sum = 2.0 * sum + (bit_string[j] ? 1.0 : 0.0);
 		}
 		const auto min = bounds[0];
 		const auto max = bounds[1];
-		vector.push_back(min + ((max - min) / (pow(2.0, bits_per_param) - 1.0)) * sum);
+		vector.push_back(min + (max - min) * scale * sum);
 	}
 }
 
 
+// candidate.vector is only decoded when the fitness is not in the cache
 void fitness(candidate_solution& candidate,
              const std::vector<std::vector<double>>& search_space,
-             const size_t param_bits)
+             const size_t param_bits, clever::fitness_cache& cache)
 {
-	decode(candidate.vector, candidate.bit_string, search_space, param_bits);
-	candidate.fitness = objective_function(candidate.vector);
+	candidate.fitness = cache.get(candidate.bit_string, [&]()
+	{
+		decode(candidate.vector, candidate.bit_string, search_space, param_bits);
+		return clever::sphere_function(candidate.vector);
+	});
 }
 
 
 void binary_tournament(candidate_solution& candidate,
                        const std::vector<candidate_solution>& pop)
 {
-	const auto i = static_cast<size_t>((pop.size() - 1) * random_());
-	auto j = static_cast<size_t>((pop.size() - 1) * random_());
+	const auto i = static_cast<size_t>((pop.size() - 1) * clever::random_uniform());
+	auto j = static_cast<size_t>((pop.size() - 1) * clever::random_uniform());
 	while (j == i)
 	{
-		j = static_cast<size_t>((pop.size() - 1) * random_());
+		j = static_cast<size_t>((pop.size() - 1) * clever::random_uniform());
 	}
 	candidate = pop[i].fitness < pop[j].fitness ? pop[i] : pop[j];
 }
 
 
-void point_mutation(std::string& child, const std::string& bit_string, const double rate)
+void crossover(clever::bit_string& child,
+               const clever::bit_string& parent1,
+               const clever::bit_string& parent2, const double rate)
 {
-	std::string tmp;
-
-	for (const auto& item : bit_string)
-	{
-		tmp.push_back(random_() < rate ? (item == '1' ? '0' : '1') : item);
-	}
-
-	child = tmp;
-}
-
-
-void crossover(std::string& child,
-               const std::string& parent1,
-               const std::string& parent2, const double rate)
-{
-	if (random_() >= rate)
+	if (clever::random_uniform() >= rate)
 	{
 		child = parent1;
 		return;
 	}
-	child.clear();
-	for (size_t i = 0; i < parent1.size(); ++i)
-	{
-		child.push_back(random_() < 0.5 ? parent1[i] : parent2[i]);
-	}
+	clever::uniform_crossover(child, parent1, parent2);
 }
 
 
@@ -128,11 +85,11 @@ void reproduce(std::vector<candidate_solution>& children,
 	children.clear();
 	for (size_t i = 0; i < selected.size(); ++i)
 	{
-		auto p1 = selected[i];
-		auto p2 = i % 2 == 0 ? (i == selected.size() - 1 ? selected[0] : selected[i + 1]) : selected[i - 1];
+		const auto& p1 = selected[i];
+		const auto& p2 = i % 2 == 0 ? (i == selected.size() - 1 ? selected[0] : selected[i + 1]) : selected[i - 1];
 		candidate_solution child;
 		crossover(child.bit_string, p1.bit_string, p2.bit_string, p_cross);
-		point_mutation(child.bit_string, child.bit_string, p_mutation);
+		clever::point_mutation(child.bit_string, p_mutation);
 		children.push_back(child);
 
 		if (children.size() >= pop_size)
@@ -148,14 +105,16 @@ void bit_climber(candidate_solution& current,
                  const std::vector<std::vector<double>>& search_space,
                  const double p_mut,
                  const size_t max_local_gens,
-                 const size_t bits_per_param)
+                 const size_t bits_per_param,
+                 clever::fitness_cache& cache)
 {
 	current = child;
 	for (size_t i = 0; i < max_local_gens; ++i)
 	{
 		candidate_solution candidate;
-		point_mutation(candidate.bit_string, current.bit_string, p_mut);
-		fitness(candidate, search_space, bits_per_param);
+		candidate.bit_string = current.bit_string;
+		clever::point_mutation(candidate.bit_string, p_mut);
+		fitness(candidate, search_space, bits_per_param, cache);
 		if (candidate.fitness <= current.fitness)
 		{
 			current = candidate;
@@ -181,16 +140,18 @@ void search(candidate_solution& best,
             const size_t pop_size,
             const double p_cross, const double p_mut,
             const size_t max_local_gens, const double p_local,
+            clever::fitness_cache& cache,
             const size_t bits_per_param = 16)
 {
 	std::vector<candidate_solution> pop(pop_size);
 	for (auto& c : pop)
 	{
-		random_bit_string(c.bit_string, search_space.size() * bits_per_param);
-		fitness(c, search_space, bits_per_param);
+		clever::random_bit_string(c.bit_string, search_space.size() * bits_per_param);
+		fitness(c, search_space, bits_per_param, cache);
 	}
 	std::sort(pop.begin(), pop.end(), cmp_fitness);
 	best = pop[0];
+	auto evaluations = pop_size;
 
 	for (size_t gen = 0; gen < max_gens; ++gen)
 	{
@@ -203,15 +164,17 @@ void search(candidate_solution& best,
 		reproduce(children, selected, pop_size, p_cross, p_mut);
 		for (auto& c : children)
 		{
-			fitness(c, search_space, bits_per_param);
+			fitness(c, search_space, bits_per_param, cache);
 		}
+		evaluations += children.size();
 		pop.clear();
 		for (auto& child : children)
 		{
-			if (random_() < p_local)
+			if (clever::random_uniform() < p_local)
 			{
 				candidate_solution tmp_child;
-				bit_climber(tmp_child, child, search_space, p_mut, max_local_gens, bits_per_param);
+				bit_climber(tmp_child, child, search_space, p_mut, max_local_gens, bits_per_param, cache);
+				evaluations += max_local_gens;
 				child = tmp_child;
 			}
 			pop.push_back(child);
@@ -225,7 +188,9 @@ void search(candidate_solution& best,
 		std::cout << " > gen " << gen + 1 << ", f = "
 			<< best.fitness << ", b = "
 			<< best.bit_string << std::endl;
+		clever::trace_progress(evaluations, best.fitness);
 	}
+	decode(best.vector, best.bit_string, search_space, bits_per_param);
 }
 
 
@@ -246,10 +211,14 @@ int main(int argc, char* argv[])
 	const double p_mut = 1.0 / (problem_size * 16.0);
 	const size_t max_local_gens = 20;
 	const double p_local = 0.5;
+	// fitness values remembered for repeated bit strings, 0 turns the cache off
+	const size_t cache_size = 4096;
 	// execute the algorithm
 	candidate_solution best;
+	clever::fitness_cache cache(cache_size);
 	search(best, max_gens, bounds, pop_size, p_cross,
-	       p_mut, max_local_gens, p_local);
+	       p_mut, max_local_gens, p_local, cache);
+	std::cout << "Fitness cache: " << cache.hits() << " hits, " << cache.misses() << " misses" << std::endl;
 
 	std::cout << "Done! Solution: f = " << best.fitness << ", v = { ";
 	for (const auto& i : best.vector)
@@ -1,42 +1,17 @@
+#include <algorithm>
+#include <cstdint>
 #include <vector>
-#include <random>
 #include <cmath>
 #include <iostream>
 
+#include "clever_algorithm.h"
 
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_real_distribution<> distribution(0.0, 1.0);
-auto random_double = []() { return distribution(generator); };
 
-using candidate_solution = struct candidate_solution_st
-{
-	std::vector<double> vector;
-};
+// Patterns are kept packed row-major, problem_size values each, and are
+// searched through k-d trees built over them.
 
 
-void random_vector(std::vector<double>& vector,
-                   const std::vector<std::vector<double>>& min_max)
-{
-	vector.resize(min_max.size());
-	for (size_t i = 0; i < vector.size(); ++i)
-	{
-		vector[i] = min_max[i][0] + random_double() * (min_max[i][1] - min_max[i][0]);
-	}
-}
-
-double euclidean_distance(const std::vector<double>& x,
-                          const std::vector<double>& y)
-{
-	double sum = 0.0;
-	for (size_t i = 0; i < x.size(); ++i)
-	{
-		sum += (x[i] - y[i]) * (x[i] - y[i]);
-	}
-	return sqrt(sum);
-}
-
-bool contains(const std::vector<double>& x,
+bool contains(const double* x,
               const std::vector<std::vector<double>>& space)
 {
 	for (size_t i = 0; i < space.size(); ++i)
@@ -49,75 +24,111 @@ bool contains(const std::vector<double>& x,
 	return true;
 }
 
-bool matches(const std::vector<double>& x,
-             const std::vector<candidate_solution>& dataset,
-             const double min_distance)
+void random_pattern(double* x,
+                    const std::vector<std::vector<double>>& space,
+                    clever::random_engine& rng)
 {
-	for (const auto & pattern : dataset)
+	for (size_t i = 0; i < space.size(); ++i)
 	{
-		if (euclidean_distance(x, pattern.vector) < min_distance)
-		{
-			return true;
-		}
+		x[i] = rng.uniform(space[i][0], space[i][1]);
 	}
-	return false;
 }
 
-void generate_detectors(std::vector<candidate_solution>& detectors,
+// Candidates are drawn in rounds and tested against the self index in
+// parallel; candidate k comes from stream k of one seed and the accepted
+// ones are kept in candidate order, so the detectors do not depend on the
+// number of threads.
+void generate_detectors(std::vector<double>& detectors,
                         const size_t max_detectors,
                         const std::vector<std::vector<double>>& search_space,
-                        const std::vector<candidate_solution>& self_dataset,
-                        const double min_distance)
+                        const clever::kd_tree& self_index,
+                        const double min_distance,
+                        clever::thread_pool& pool = clever::default_pool())
 {
+	const auto n = search_space.size();
+	const auto seed = clever::default_engine()();
 	detectors.clear();
-	while (detectors.size() < max_detectors)
+	std::vector<double> candidates;
+	std::vector<char> accepted;
+	std::uint64_t next = 0;
+	while (detectors.size() < max_detectors * n)
 	{
-		candidate_solution detector;
-		random_vector(detector.vector, search_space);
-		if (!matches(detector.vector, self_dataset, min_distance) && !matches(detector.vector, detectors, 0.0))
+		const auto round = std::max<size_t>(64, 2 * (max_detectors - detectors.size() / n));
+		candidates.resize(round * n);
+		accepted.assign(round, 0);
+		pool.parallel_for(round, [&](const size_t k)
 		{
+			clever::random_engine rng(seed, next + k);
+			auto* x = &candidates[k * n];
+			random_pattern(x, search_space, rng);
+			accepted[k] = self_index.any_within(x, min_distance) ? 0 : 1;
+		}, 16);
+		next += round;
+		for (size_t k = 0; k < round && detectors.size() < max_detectors * n; ++k)
+		{
+			if (accepted[k])
 			{
-				detectors.push_back(detector);
+				detectors.insert(detectors.end(), &candidates[k * n], &candidates[(k + 1) * n]);
 			}
-			detectors.push_back(detector);
 		}
 	}
 }
 
-void generate_self_dataset(std::vector<candidate_solution>& self_dataset,
+void generate_self_dataset(std::vector<double>& self_dataset,
                            const size_t num_records,
                            const std::vector<std::vector<double>>& self_space,
                            const std::vector<std::vector<double>>& search_space)
 {
+	const auto n = search_space.size();
 	self_dataset.clear();
-	while (self_dataset.size() < num_records)
+	std::vector<double> pattern(n);
+	while (self_dataset.size() < num_records * n)
 	{
-		candidate_solution pattern;
-		random_vector(pattern.vector, search_space);
-		if (matches(pattern.vector, self_dataset, 0.0))
+		random_pattern(pattern.data(), search_space, clever::default_engine());
+		if (!contains(pattern.data(), self_space))
 		{
-			continue;
-		}
-		if (!contains(pattern.vector, self_space))
-		{
-			self_dataset.push_back(pattern);
+			self_dataset.insert(self_dataset.end(), pattern.begin(), pattern.end());
 		}
 	}
 }
 
-size_t apply_detectors(const std::vector<candidate_solution>& detectors,
+// matched[i] = whether row i of inputs lies within min_distance of some
+// point of index, spread over the pool
+void classify(const clever::kd_tree& index,
+              const clever::dataset_view& inputs,
+              const double min_distance,
+              std::vector<char>& matched,
+              clever::thread_pool& pool = clever::default_pool())
+{
+	matched.resize(inputs.rows());
+	pool.parallel_for(inputs.rows(), [&](const size_t i)
+	{
+		matched[i] = index.any_within(inputs.row(i), min_distance) ? 1 : 0;
+	}, 64);
+}
+
+size_t apply_detectors(const clever::kd_tree& detector_index,
                        const std::vector<std::vector<double>>& bounds,
-                       const std::vector<candidate_solution>& self_dataset,
+                       const clever::kd_tree& self_index,
                        const double min_distance,
                        const size_t trials = 50)
 {
+	const auto n = bounds.size();
+	std::vector<double> inputs(trials * n);
+	for (size_t i = 0; i < trials; ++i)
+	{
+		random_pattern(&inputs[i * n], bounds, clever::default_engine());
+	}
+	const clever::dataset_view view(inputs.data(), trials, n);
+	std::vector<char> detected, self;
+	classify(detector_index, view, min_distance, detected);
+	classify(self_index, view, min_distance, self);
+
 	size_t correct = 0;
 	for (size_t i = 0; i < trials; ++i)
 	{
-		candidate_solution input;
-		random_vector(input.vector, bounds);
-		const auto actual = matches(input.vector, detectors, min_distance) ? 'N' : 'S';
-		const auto expected = matches(input.vector, self_dataset, min_distance) ? 'S' : 'N';
+		const auto actual = detected[i] ? 'N' : 'S';
+		const auto expected = self[i] ? 'S' : 'N';
 		if (actual == expected)
 		{
 			correct += 1;
@@ -129,19 +140,22 @@ size_t apply_detectors(const std::vector<candidate_solution>& detectors,
 	return correct;
 }
 
-void execute(std::vector<candidate_solution>& detectors,
+void execute(std::vector<double>& detectors,
              const std::vector<std::vector<double>>& bounds,
              const std::vector<std::vector<double>>& self_space,
              const size_t max_detect,
              const size_t max_self,
              const double min_distance)
 {
-	std::vector<candidate_solution> self_dataset;
+	const auto n = bounds.size();
+	std::vector<double> self_dataset;
 	generate_self_dataset(self_dataset, max_self, self_space, bounds);
-	std::cout << "Done: prepared " << self_dataset.size() << " self patterns." << std::endl;
-	generate_detectors(detectors, max_detect, bounds, self_dataset, min_distance);
-	std::cout << "Done: prepared " << detectors.size() << " detectors." << std::endl;
-	apply_detectors(detectors, bounds, self_dataset, min_distance);
+	const clever::kd_tree self_index(self_dataset.data(), self_dataset.size() / n, n);
+	std::cout << "Done: prepared " << self_index.size() << " self patterns." << std::endl;
+	generate_detectors(detectors, max_detect, bounds, self_index, min_distance);
+	const clever::kd_tree detector_index(detectors.data(), detectors.size() / n, n);
+	std::cout << "Done: prepared " << detector_index.size() << " detectors." << std::endl;
+	apply_detectors(detector_index, bounds, self_index, min_distance);
 }
 
 int main()
@@ -167,7 +181,7 @@ int main()
 	const size_t max_detectors = 300;
 	const double min_distance = 0.05;
 	// execute the algorithm
-	std::vector<candidate_solution> detectors;
+	std::vector<double> detectors;
 	execute(detectors, bounds, self_space, max_detectors, max_self, min_distance);
 	return 0;
 }
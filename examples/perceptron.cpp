@@ -1,150 +1,88 @@
-#include <random>
+#include <algorithm>
 #include <iostream>
+#include <string>
 #include <vector>
-#include <cmath>
 
+#include "clever_algorithm.h"
 
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_real_distribution<> distribution(0.0, 1.0);
-auto random_double = []() { return distribution(generator); };
 
-
-void random_vector(std::vector<double>& x,
-                   const std::vector<std::vector<double>>& min_max)
-{
-	x.clear();
-	for (const auto& i : min_max)
-	{
-		auto tmp = i[0] + (i[1] - i[0]) * random_double();
-		x.push_back(tmp);
-	}
-}
-
-void initialize_weights(std::vector<double>& w, const size_t problem_size)
-{
-	std::vector<std::vector<double>> min_max;
-	for (size_t i = 0; i < problem_size + 1; i++)
-	{
-		std::vector<double> tmp;
-		tmp.push_back(-1.0);
-		tmp.push_back(1.0);
-		min_max.push_back(tmp);
-	}
-	random_vector(w, min_max);
-}
-
-void update_weights(const size_t num_inputs,
-                    std::vector<double>& weights,
-                    const std::vector<double>& inputs,
-                    const double out_exp,
-                    const double out_act,
-                    const double l_rate)
-{
-	for (size_t i = 0; i < num_inputs; ++i)
-	{
-		weights[i] += l_rate * (out_exp - out_act) * inputs[i];
-	}
-	weights[num_inputs] += l_rate * (out_exp - out_act);
-}
-
-double activate(const std::vector<double>& weights,
-                const std::vector<double>& vector)
-{
-	double sum = 0.0;
-	for (size_t i = 0; i < vector.size(); ++i)
-	{
-		sum += weights[i] * vector[i];
-	}
-	sum += weights[vector.size()];
-	return sum;
-}
-
-double transfer(double activation)
-{
-	return activation >= 0.0 ? 1.0 : 0.0;
-}
-
-double get_output(const std::vector<double>& weights,
-                  const std::vector<double>& vector)
-{
-	const double activation = activate(weights, vector);
-	return transfer(activation);
-}
-
-void train_weights(std::vector<double>& weights,
-                   const std::vector<std::vector<double>>& domain,
-                   const size_t num_inputs,
+void train_weights(clever::perceptron& network,
+                   const clever::dataset_view& domain,
                    const size_t iterations,
-                   const double l_rate)
+                   const double l_rate,
+                   const size_t batch_size)
 {
+	size_t best = domain.rows();
 	for (size_t i = 0; i < iterations; ++i)
 	{
-		double error = 0.0;
-		for (auto& pattern : domain)
-		{
-			std::vector<double> input(num_inputs);
-			for (size_t k = 0; k < num_inputs; ++k)
-			{
-				input[k] = pattern[k];
-			}
-			const auto output = get_output(weights, input);
-			const auto expected = *(pattern.end() - 1);
-			error += abs(output - expected);
-			update_weights(num_inputs, weights, input, expected, output, l_rate);
-		}
+		const auto error = network.train_epoch(domain, l_rate, batch_size);
+		best = std::min(best, error);
+		clever::trace_progress((i + 1) * domain.rows(), static_cast<double>(best));
 		std::cout << "Epoch: " << i << " Error: " << error << std::endl;
 	}
 }
 
-size_t test_weights(const std::vector<double>& weights,
-                    const std::vector<std::vector<double>>& domain,
-                    const size_t num_inputs)
+size_t test_weights(const clever::perceptron& network,
+                    const clever::dataset_view& domain)
 {
-	size_t correct = 0;
-	for (auto& pattern : domain)
-	{
-		std::vector<double> input_vector(num_inputs);
-		for (size_t k = 0; k < num_inputs; ++k)
-		{
-			input_vector[k] = pattern[k];
-		}
-		const auto output = get_output(weights, input_vector);
-		if (output - *(pattern.end() - 1) < 1e-6)
-		{
-			correct += 1;
-		}
-	}
-	std::cout << "Finished test with a score of " << correct / domain.size() << std::endl;
+	const auto correct = network.test(domain);
+	std::cout << "Finished test with a score of "
+		<< (domain.empty() ? 0.0 : static_cast<double>(correct) / domain.rows()) << std::endl;
 	return correct;
 }
 
-void execute(std::vector<double>& weights,
-             const std::vector<std::vector<double>>& domain,
+void execute(clever::perceptron& network,
+             const clever::dataset_view& domain,
              const size_t num_inputs,
              const size_t iterations,
-             const double learning_rate)
+             const double learning_rate,
+             const size_t batch_size,
+             const bool average)
 {
-	initialize_weights(weights, num_inputs);
-	train_weights(weights, domain, num_inputs, iterations, learning_rate);
-	test_weights(weights, domain, num_inputs);
+	network = clever::perceptron(num_inputs);
+	train_weights(network, domain, iterations, learning_rate, batch_size);
+	if (average)
+	{
+		network.use_averaged();
+	}
+	test_weights(network, domain);
 }
 
-int main()
+// With arguments "<file> <num_inputs>" the patterns come from a binary file
+// of packed rows of num_inputs doubles and the expected output, mapped
+// into memory rather than read; otherwise the OR problem is used.
+int main(int argc, char* argv[])
 {
 	// problem configuration
-	const std::vector<std::vector<double>> or_problem = {
-		{0, 0, 0},
-		{0, 1, 1},
-		{1, 0, 1},
-		{1, 1, 1}
+	const std::vector<double> or_problem = {
+		0, 0, 0,
+		0, 1, 1,
+		1, 0, 1,
+		1, 1, 1
 	};
-	const size_t inputs = 2;
+	size_t inputs = 2;
 	// algorithm configuration
 	const size_t iterations = 20;
 	const double learning_rate = 0.1;
+	// rows per update, 1 for the classic per-pattern rule
+	const size_t batch_size = 1;
+	// test with the averaged perceptron
+	const bool average = false;
+
+	clever::dataset_view domain(or_problem.data(), or_problem.size() / (inputs + 1), inputs + 1);
+	clever::mapped_dataset file;
+	if (argc > 2)
+	{
+		inputs = std::stoul(argv[2]);
+		if (!file.open(argv[1], inputs + 1))
+		{
+			std::cerr << "cannot read " << argv[1] << " as rows of " << inputs + 1 << " doubles" << std::endl;
+			return 1;
+		}
+		domain = file.view();
+	}
 	// execute the algorithm
-	std::vector<double> weights(inputs + 1);
-	execute(weights, or_problem, inputs, iterations, learning_rate);
+	clever::perceptron network;
+	execute(network, domain, inputs, iterations, learning_rate, batch_size, average);
 	return 0;
 }
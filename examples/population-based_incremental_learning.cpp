@@ -1,46 +1,21 @@
 #include <iostream>
-#include <random>
 #include <vector>
-#include <string>
 #include <algorithm>
 #include <cfloat>
 
-
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_real_distribution<> distribution(0.0, 1.0);
-auto random_ = []() { return distribution(generator); };
+#include "clever_algorithm.h"
 
 
 using candidate_solution = struct candidate_solution_st
 {
-	std::string bit_string;
+	clever::bit_string bit_string;
 	double fitness = DBL_MIN;
 };
 
 
-double onemax(const std::string& bit_string)
-{
-	double sum = 0.0;
-	for (auto& item : bit_string)
-	{
-		if (item == '1')
-		{
-			sum++;
-		}
-	}
-	return sum;
-}
-
-
 void generate_candidate(candidate_solution& candidate, const std::vector<double>& vector)
 {
-	candidate.bit_string.resize(vector.size());
-	for (size_t i = 0; i < vector.size(); ++i)
-	{
-		const auto& p = vector[i];
-		candidate.bit_string[i] = random_() < p ? '1' : '0';
-	}
+	clever::sample_bit_string(candidate.bit_string, vector);
 }
 
 
@@ -49,7 +24,7 @@ void update_vector(std::vector<double>& vector, const candidate_solution& curren
 	for (size_t i = 0; i < vector.size(); ++i)
 	{
 		const auto& p = vector[i];
-		vector[i] = p * (1.0 - l_rate) + current.bit_string[i] * l_rate;
+		vector[i] = p * (1.0 - l_rate) + (current.bit_string[i] ? 1.0 : 0.0) * l_rate;
 	}
 }
 
@@ -62,9 +37,9 @@ void mutate_vector(std::vector<double>& vector,
 	for (size_t i = 0; i < vector.size(); ++i)
 	{
 		const auto& p = vector[i];
-		if (random_() < rate)
+		if (clever::random_uniform() < rate)
 		{
-			vector[i] = p * (1.0 - coefficient) + random_() * coefficient;
+			vector[i] = p * (1.0 - coefficient) + clever::random_uniform() * coefficient;
 		}
 	}
 }
@@ -101,7 +76,7 @@ void search(candidate_solution& best,
 		{
 			candidate_solution candidate;
 			generate_candidate(candidate, vector);
-			candidate.fitness = onemax(candidate.bit_string);
+			candidate.fitness = clever::onemax(candidate.bit_string);
 			if (i == 0)
 			{
 				current = candidate;
@@ -123,6 +98,7 @@ void search(candidate_solution& best,
 		std::cout << " > gen " << i + 1 << ", f = "
 			<< best.fitness << ", b = "
 			<< best.bit_string << std::endl;
+		clever::trace_progress((i + 1) * num_samples, best.fitness);
 
 		if (static_cast<size_t>(best.fitness) == num_bits)
 		{
@@ -1,40 +1,11 @@
 #include <iostream>
 #include <numeric>
-#include <random>
 #include <vector>
 
-
-using candidate_solution = struct candidate_solution_t
-{
-	std::vector<double> vector;
-	double cost = 0.0;
-};
+#include "clever_algorithm.h"
 
 
-double objective_function(std::vector<double>& vector)
-{
-	return std::inner_product(vector.begin(), vector.end(), vector.begin(), 0.0);
-}
-
-
-void random_vector(std::vector<double>& rand_vec, std::vector<std::vector<double> >& minmax)
-{
-	if (minmax.empty())
-	{
-		return;
-	}
-	rand_vec.resize(minmax.size());
-	std::random_device rd;
-	std::mt19937 generator(rd());
-	std::uniform_real_distribution<> distribution(0.0, 1.0);
-	//auto random = std::bind(distribution, generator);
-	auto random_ = [&](){return distribution(generator);};
-
-	for (size_t i = 0; i < minmax.size(); ++i)
-	{
-		rand_vec[i] = minmax[i][0] + (minmax[i][1] - minmax[i][0]) * random_();
-	}
-}
+using candidate_solution = clever::real_solution;
 
 
 void search(candidate_solution& best, std::vector<std::vector<double> >& search_space, size_t max_iter)
@@ -42,8 +13,8 @@ void search(candidate_solution& best, std::vector<std::vector<double> >& search_
 	for (size_t iter = 0; iter < max_iter; ++iter)
 	{
 		candidate_solution candidate;
-		random_vector(candidate.vector, search_space);
-		candidate.cost = objective_function(candidate.vector);
+		clever::random_vector(candidate.vector, search_space);
+		candidate.cost = clever::sphere_function(candidate.vector);
 
 		if (iter == 0)
 		{
@@ -60,6 +31,7 @@ void search(candidate_solution& best, std::vector<std::vector<double> >& search_
 		}
 
 		std::cout << " > iteration=" << iter + 1 << ", best=" << best.cost << std::endl;
+		clever::trace_progress(iter + 1, best.cost);
 	}
 }
 
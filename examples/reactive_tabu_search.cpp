@@ -1,19 +1,12 @@
 #include <iostream>
 #include <numeric>
-#include <random>
 #include <vector>
 #include <algorithm>
 
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_real_distribution<> distribution(0.0, 1.0);
-auto random_ = []() { return distribution(generator); };
+#include "clever_algorithm.h"
 
-using candidate_solution = struct candidate_solution_t
-{
-	std::vector<size_t> vector;
-	double cost = 0.0;
-};
+
+using candidate_solution = clever::permutation_solution;
 
 using entry_info = struct entry_info_t
 {
@@ -24,98 +17,7 @@ using entry_info = struct entry_info_t
 	bool enable = true;
 };
 
-double euc_2d(std::vector<double>& c1, std::vector<double>& c2)
-{
-	if (c1.size() != c2.size())
-	{
-		return 0.0;
-	}
-
-	double sum = 0.0;
-	for (size_t i = 0; i < c1.size(); ++i)
-	{
-		sum += (c1[i] - c2[i]) * (c1[i] - c2[i]);
-	}
-
-	return sqrt(sum);
-}
-
-
-double cost(std::vector<size_t>& perm, std::vector<std::vector<double>>& cities)
-{
-	double distance = 0.0;
-	for (size_t i = 0; i < perm.size(); ++i)
-	{
-		const size_t c1 = perm[i];
-		const size_t c2 = i == perm.size() - 1 ? perm[0] : perm[i + 1];
-
-		distance += euc_2d(cities[c1], cities[c2]);
-	}
-
-	return distance;
-}
-
-
-void random_permutation(std::vector<size_t>& perm, std::vector<std::vector<double>>& cities)
-{
-	perm.clear();
-	perm.resize(cities.size());
-
-	for (size_t i = 0; i < cities.size(); ++i)
-	{
-		perm[i] = i;
-	}
-
-	for (size_t i = 0; i < cities.size(); ++i)
-	{
-		const size_t r = static_cast<size_t>((perm.size() - 1 - i) * random_()) + i;
-		const size_t tmp = perm[r];
-		perm[r] = perm[i];
-		perm[i] = tmp;
-	}
-}
-
-void stochastic_two_opt(std::vector<size_t>& perm, std::vector<std::vector<size_t>>& edges,
-                        std::vector<size_t>& parent)
-{
-	perm.clear();
-	edges.clear();
-	perm.resize(parent.size());
-	perm.assign(parent.begin(), parent.end());
-	auto c1 = static_cast<size_t>((perm.size() - 1) * random_());
-	auto c2 = static_cast<size_t>((perm.size() - 1) * random_());
-	std::vector<size_t> exclude;
-	exclude.push_back(c1);
-	exclude.push_back(c1 == 0 ? perm.size() - 1 : c1 - 1);
-	exclude.push_back(c1 == perm.size() - 1 ? 0 : c1 + 1);
-	while (std::find(exclude.begin(), exclude.end(), c2) != exclude.end())
-	{
-		c2 = static_cast<size_t>((perm.size() - 1) * random_());
-	}
-	if (c2 < c1)
-	{
-		const size_t tmp = c1;
-		c1 = c2;
-		c2 = tmp;
-	}
-
-	for (size_t i = c1; i < (c2 - c1) / 2; ++i)
-	{
-		const size_t tmp = perm[c1];
-		perm[c1] = perm[c2 - (i - c1)];
-		perm[c2 - (i - c1)] = tmp;
-	}
-
-	const size_t c1_m_1 = c1 == 0 ? perm.size() - 1 : c1 - 1;
-	const size_t c2_m_1 = c2 == 0 ? perm.size() - 1 : c2 - 1;
-
-	const std::vector<size_t> edge0 = {parent[c1_m_1], parent[c1]};
-	const std::vector<size_t> edge1 = {parent[c2_m_1], parent[c2]};
-	edges.push_back(edge0);
-	edges.push_back(edge1);
-}
-
-bool is_tabu(std::vector<size_t>& edge, std::vector<entry_info>& tabu_list,
+bool is_tabu(const std::vector<size_t>& edge, std::vector<entry_info>& tabu_list,
              const size_t iter, const double prohib_period)
 {
 	for (auto& entry : tabu_list)
@@ -133,7 +35,7 @@ bool is_tabu(std::vector<size_t>& edge, std::vector<entry_info>& tabu_list,
 }
 
 void make_tabu(entry_info& entry, std::vector<entry_info>& tabu_list,
-               std::vector<size_t>& edge, const size_t iter)
+               const std::vector<size_t>& edge, const size_t iter)
 {
 	for (size_t i = 0; i < tabu_list.size(); ++i)
 	{
@@ -184,14 +86,6 @@ bool equivalent(std::vector<std::pair<size_t, size_t>>& el1,
 	return true;
 }
 
-void generate_candidate(candidate_solution& candidate, std::vector<std::vector<size_t>>& edges,
-                        candidate_solution& best,
-                        std::vector<std::vector<double>>& cities)
-{
-	stochastic_two_opt(candidate.vector, edges, best.vector);
-	candidate.cost = cost(candidate.vector, cities);
-}
-
 void get_candidate_entry(entry_info& entry, std::vector<entry_info>& visited_list,
                          std::vector<size_t>& permutation)
 {
@@ -223,10 +117,21 @@ void store_permutation(entry_info& entry, std::vector<entry_info>& visited_list,
 
 using candidate_info = struct candidate_info_t
 {
-	candidate_solution candidate;
+	clever::two_opt_move move;
+	double cost = 0.0;
 	std::vector<std::vector<size_t>> edges;
 };
 
+void generate_candidate(candidate_info& candidate, const candidate_solution& current,
+                        const std::vector<std::vector<double>>& cities)
+{
+	size_t a, b, c, d;
+	candidate.move = clever::random_two_opt_move(current.vector.size());
+	clever::two_opt_cities(current.vector, candidate.move, a, b, c, d);
+	candidate.cost = current.cost + clever::two_opt_delta(current.vector, candidate.move, cities);
+	candidate.edges = {{a, b}, {c, d}};
+}
+
 void sort_neighborhood(std::vector<candidate_info>& tabu,
                        std::vector<candidate_info>& admissable,
                        std::vector<candidate_info>& candidates,
@@ -250,9 +155,9 @@ void sort_neighborhood(std::vector<candidate_info>& tabu,
 	}
 }
 
-bool cmp(candidate_info& info_l, candidate_info& info_r)
+bool cmp(const candidate_info& info_l, const candidate_info& info_r)
 {
-	if (info_l.candidate.cost < info_r.candidate.cost)
+	if (info_l.cost < info_r.cost)
 	{
 		return true;
 	}
@@ -261,15 +166,15 @@ bool cmp(candidate_info& info_l, candidate_info& info_r)
 }
 
 void search(candidate_solution& best,
-            std::vector<std::vector<double>>& cities,
+            const std::vector<std::vector<double>>& cities,
             const size_t max_cand,
             const size_t max_iter,
             const double increase,
             const double decrease)
 {
 	candidate_solution current;
-	random_permutation(current.vector, cities);
-	current.cost = cost(current.vector, cities);
+	clever::random_permutation(current.vector, cities.size());
+	current.cost = clever::tour_cost(current.vector, cities);
 	best = current;
 	double prohib_period = 1;
 	double avg_size = 1;
@@ -305,16 +210,10 @@ void search(candidate_solution& best,
 			last_change = iter;
 		}
 
-		std::vector<candidate_info> candidates;
-		for (size_t i = 0; i < max_cand; ++i)
+		std::vector<candidate_info> candidates(max_cand);
+		for (auto& candidate : candidates)
 		{
-			candidate_solution cand;
-			std::vector<std::vector<size_t>> edges;
-			generate_candidate(cand, edges, current, cities);
-			candidate_info item;
-			item.candidate = cand;
-			item.edges = edges;
-			candidates.push_back(item);
+			generate_candidate(candidate, current, cities);
 		}
 
 		std::sort(candidates.begin(), candidates.end(), cmp);
@@ -328,59 +227,46 @@ void search(candidate_solution& best,
 			last_change = iter;
 		}
 
-		std::vector<std::vector<size_t>> best_move_edges;
-
-		if (admis.empty())
-		{
-			current = tabu[0].candidate;
-			best_move_edges = tabu[0].edges;
-		}
-		else
-		{
-			current = admis[0].candidate;
-			best_move_edges = admis[0].edges;
-		}
-
+		const candidate_info* best_move = admis.empty() ? &tabu[0] : &admis[0];
 		if (!tabu.empty())
 		{
-			auto tf = tabu[0].candidate;
-			if (tf.cost < best.cost && tf.cost < current.cost)
+			const auto& tf = tabu[0];
+			if (tf.cost < best.cost && tf.cost < best_move->cost)
 			{
-				current = tabu[0].candidate;
-				best_move_edges = tabu[0].edges;
+				best_move = &tabu[0];
 			}
 		}
 
-		for (size_t i = 0; i < best_move_edges.size(); ++i)
+		if (candidates[0].cost < best.cost)
 		{
-			auto& edge = best_move_edges[i];
-			entry_info tmp_entry;
-			make_tabu(tmp_entry, tabu_list, edge, iter);
+			best.vector = current.vector;
+			clever::apply_two_opt(best.vector, candidates[0].move);
+			best.cost = candidates[0].cost;
 		}
 
-		if (candidates[0].candidate.cost < best.cost)
+		clever::apply_two_opt(current.vector, best_move->move);
+		current.cost = best_move->cost;
+
+		for (auto& edge : best_move->edges)
 		{
-			best = candidates[0].candidate;
+			entry_info tmp_entry;
+			make_tabu(tmp_entry, tabu_list, edge, iter);
 		}
 
 		std::cout << " > iteration " << iter + 1 << ", best=" << best.cost << std::endl;
+		clever::trace_progress(1 + (iter + 1) * max_cand, best.cost);
 	}
 }
 
 int main(int argc, char* argv[])
 {
-	// problem configuration
-	std::vector<std::vector<double>> berlin52 = {
-		{565, 575}, {25, 185}, {345, 750}, {945, 685}, {845, 655},
-		{880, 660}, {25, 230}, {525, 1000}, {580, 1175}, {650, 1130}, {1605, 620},
-		{1220, 580}, {1465, 200}, {1530, 5}, {845, 680}, {725, 370}, {145, 665},
-		{415, 635}, {510, 875}, {560, 365}, {300, 465}, {520, 585}, {480, 415},
-		{835, 625}, {975, 580}, {1215, 245}, {1320, 315}, {1250, 400}, {660, 180},
-		{410, 250}, {420, 555}, {575, 665}, {1150, 1160}, {700, 580}, {685, 595},
-		{685, 610}, {770, 610}, {795, 645}, {720, 635}, {760, 650}, {475, 960},
-		{95, 260}, {875, 920}, {700, 500}, {555, 815}, {830, 485}, {1170, 65},
-		{830, 610}, {605, 625}, {595, 360}, {1340, 725}, {1740, 245}
-	};
+	// problem configuration, a TSPLIB instance may be given instead of berlin52
+	auto cities = clever::berlin52();
+	if (argc > 1 && !clever::load_tsplib(argv[1], cities))
+	{
+		std::cout << "Cannot read the TSPLIB instance " << argv[1] << std::endl;
+		return 1;
+	}
 	// algorithm configuration
 	const size_t max_iter = 100;
 	const size_t max_candidates = 50;
@@ -388,7 +274,7 @@ int main(int argc, char* argv[])
 	const double decrease = 0.9;
 	// execute the algorithm
 	candidate_solution best;
-	search(best, berlin52, max_candidates, max_iter, increase, decrease);
+	search(best, cities, max_candidates, max_iter, increase, decrease);
 
 	std::cout << "Done. Best Solution: c=" << best.cost << ", v={ ";
 	for (auto& i : best.vector)
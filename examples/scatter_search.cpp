@@ -1,15 +1,10 @@
 #include <iostream>
 #include <numeric>
-#include <random>
 #include <vector>
 #include <iterator>
 #include <algorithm>
 
-
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_real_distribution<> distribution(0.0, 1.0);
-auto random_ = []() { return distribution(generator); };
+#include "clever_algorithm.h"
 
 
 using candidate_solution = struct candidate_solution_t
@@ -31,33 +26,8 @@ using candidate_solution = struct candidate_solution_t
 };
 
 
-double objective_function(std::vector<double>& vector)
-{
-	double sum = 0.0;
-	for (double& item : vector)
-	{
-		sum += item * item;
-	}
-
-	return sum;
-}
-
-
-double rand_in_bounds(const double min, const double max)
-{
-	return min + (max - min) * random_();
-}
-
-
-void random_vector(std::vector<double>& arr, std::vector<std::vector<double>>& minmax)
-{
-	arr.clear();
-	arr.resize(minmax.size());
-	for (size_t i = 0; i < minmax.size(); ++i)
-	{
-		arr[i] = rand_in_bounds(minmax[i][0], minmax[i][1]);
-	}
-}
+// objective evaluations so far, for the benchmark trace
+size_t num_evaluations = 0;
 
 
 void take_step(std::vector<double>& position, std::vector<std::vector<double>>& minmax,
@@ -69,7 +39,7 @@ void take_step(std::vector<double>& position, std::vector<std::vector<double>>&
 	{
 		const double min = std::max(minmax[i][0], current[i] - step_size);
 		const double max = std::min(minmax[i][1], current[i] - step_size);
-		position[i] = rand_in_bounds(min, max);
+		position[i] = clever::rand_in_bounds(min, max);
 	}
 }
 
@@ -82,7 +52,8 @@ void local_search(candidate_solution& best, std::vector<std::vector<double>>& bo
 	{
 		candidate_solution candidate;
 		take_step(candidate.vector, bounds, best.vector, step_size);
-		candidate.cost = objective_function(candidate.vector);
+		candidate.cost = clever::sphere_function(candidate.vector);
+		++num_evaluations;
 		count = candidate.cost < best.cost ? 0 : count + 1;
 		if (candidate.cost < best.cost)
 		{
@@ -116,8 +87,9 @@ void construct_initial_set(std::vector<candidate_solution>& diverse_set, std::ve
 	while (diverse_set.size() < set_size)
 	{
 		candidate_solution cand;
-		random_vector(cand.vector, bounds);
-		cand.cost = objective_function(cand.vector);
+		clever::random_vector(cand.vector, bounds);
+		cand.cost = clever::sphere_function(cand.vector);
+		++num_evaluations;
 		local_search(cand, bounds, max_no_improv, step_size);
 		if (!is_any_element_equal(diverse_set, cand.vector))
 		{
@@ -127,24 +99,12 @@ void construct_initial_set(std::vector<candidate_solution>& diverse_set, std::ve
 }
 
 
-double euclidean_distance(std::vector<double>& c1, std::vector<double>& c2)
-{
-	double sum = 0.0;
-	for (size_t i = 0; i < c1.size(); ++i)
-	{
-		sum += (c1[i] - c2[i]) * (c1[i] - c2[i]);
-	}
-
-	return sqrt(sum);
-}
-
-
 double distance(std::vector<double>& v, std::vector<candidate_solution>& set)
 {
 	double s = 0.0;
 	for (auto& i : set)
 	{
-		s += euclidean_distance(v, i.vector);
+		s += clever::euclidean_distance(v, i.vector);
 	}
 	return s;
 }
@@ -279,8 +239,8 @@ void recombine(std::vector<candidate_solution>& children,
 	std::vector<candidate_solution> tmp = {a, b};
 	for (auto& p : tmp)
 	{
-		const double direction = random_() < 0.5 ? 1.0 : -1.0;
-		const double r = random_();
+		const double direction = clever::random_uniform() < 0.5 ? 1.0 : -1.0;
+		const double r = clever::random_uniform();
 		candidate_solution child;
 		child.vector.resize(minmax.size());
 		for (size_t j = 0; j < child.vector.size(); ++j)
@@ -297,7 +257,8 @@ void recombine(std::vector<candidate_solution>& children,
 			}
 		}
 
-		child.cost = objective_function(child.vector);
+		child.cost = clever::sphere_function(child.vector);
+		++num_evaluations;
 		children.push_back(child);
 	}
 }
@@ -373,6 +334,7 @@ void search(candidate_solution& best, std::vector<std::vector<double>>& bounds,
 			best = ref_set[0];
 		}
 		std::cout << " > iter=" << iter + 1 << " best=" << best.cost << std::endl;
+		clever::trace_progress(num_evaluations, best.cost);
 
 		if (!was_change)
 			break;
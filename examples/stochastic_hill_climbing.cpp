@@ -1,13 +1,8 @@
 #include <iostream>
-#include <random>
 #include <vector>
 #include <string>
 
-
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_real_distribution<> distribution(0.0, 1.0);
-auto random_ = []() {return distribution(generator); };
+#include "clever_algorithm.h"
 
 
 using candidate_solution = struct candidate_solution_t
@@ -34,7 +29,7 @@ void random_bitstring(std::string & vector,  const size_t num_bits)
 	vector.clear();
 	for (size_t i = 0; i < num_bits; ++i)
 	{
-		vector.push_back(random_() < 0.5 ? '1' : '0');
+		vector.push_back(clever::random_uniform() < 0.5 ? '1' : '0');
 	}
 }
 
@@ -42,7 +37,7 @@ void random_bitstring(std::string & vector,  const size_t num_bits)
 void random_neighbor(std::string& mutant, std::string & bitstring)
 {
 	mutant = bitstring;
-	const auto pos = static_cast<size_t>((bitstring.size() - 1) * random_());
+	const auto pos = static_cast<size_t>((bitstring.size() - 1) * clever::random_uniform());
 	mutant[pos] = mutant[pos] == '1' ? '0' : '1';
 }
 
@@ -62,6 +57,7 @@ void search(candidate_solution & candidate, const size_t max_iterations, const s
 		}
 
 		std::cout << " > iteration "<< iter + 1 << ", best=" << candidate.cost << std::endl;
+		clever::trace_progress(iter + 2, candidate.cost);
 
 		if (static_cast<size_t>(candidate.cost) == num_bits)
 			break;
@@ -1,164 +1,57 @@
 #include <iostream>
 #include <numeric>
-#include <random>
 #include <vector>
 #include <algorithm>
 
+#include "clever_algorithm.h"
 
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_real_distribution<> distribution(0.0, 1.0);
-auto random_ = []() { return distribution(generator); };
 
+using candidate_solution = clever::permutation_solution;
 
-using candidate_solution = struct candidate_solution_t
+
+using candidate_info = struct candidate_info_t
 {
-	std::vector<size_t> vector;
+	clever::two_opt_move move;
 	double cost = 0.0;
+	std::vector<std::vector<size_t>> edges;
 };
 
 
-double euc_2d(std::vector<double>& c1, std::vector<double>& c2)
-{
-	if (c1.size() != c2.size())
-	{
-		return 0.0;
-	}
-
-	double sum = 0.0;
-	for (size_t i = 0; i < c1.size(); ++i)
-	{
-		sum += (c1[i] - c2[i]) * (c1[i] - c2[i]);
-	}
-
-	return sqrt(sum);
-}
-
-
-double cost(std::vector<size_t>& perm, std::vector<std::vector<double>>& cities)
-{
-	double distance = 0.0;
-	for (size_t i = 0; i < perm.size(); ++i)
-	{
-		const size_t c1 = perm[i];
-		const size_t c2 = i == perm.size() - 1 ? perm[0] : perm[i + 1];
-
-		distance += euc_2d(cities[c1], cities[c2]);
-	}
-
-	return distance;
-}
-
-
-void random_permutation(std::vector<size_t>& perm, std::vector<std::vector<double>>& cities)
-{
-	perm.clear();
-	perm.resize(cities.size());
-
-	for (size_t i = 0; i < cities.size(); ++i)
-	{
-		perm[i] = i;
-	}
-
-	for (size_t i = 0; i < cities.size(); ++i)
-	{
-		const size_t r = static_cast<size_t>((perm.size() - 1 - i) * random_()) + i;
-		const size_t tmp = perm[r];
-		perm[r] = perm[i];
-		perm[i] = tmp;
-	}
-}
-
-void stochastic_two_opt(std::vector<size_t>& perm, std::vector<std::vector<size_t>>& edges,
-                        std::vector<size_t>& parent)
+bool is_tabu(const size_t c1, const size_t c2, const std::vector<std::vector<size_t>>& tabu_list)
 {
-	perm.clear();
-	edges.clear();
-	perm.resize(parent.size());
-	perm.assign(parent.begin(), parent.end());
-	auto c1 = static_cast<size_t>((perm.size() - 1) * random_());
-	auto c2 = static_cast<size_t>((perm.size() - 1) * random_());
-	std::vector<size_t> exclude;
-	exclude.push_back(c1);
-	exclude.push_back(c1 == 0 ? perm.size() - 1 : c1 - 1);
-	exclude.push_back(c1 == perm.size() - 1 ? 0 : c1 + 1);
-	while (std::find(exclude.begin(), exclude.end(), c2) != exclude.end())
-	{
-		c2 = static_cast<size_t>((perm.size() - 1) * random_());
-	}
-	if (c2 < c1)
-	{
-		const size_t tmp = c1;
-		c1 = c2;
-		c2 = tmp;
-	}
-
-	for (size_t i = c1; i < (c2 - c1) / 2; ++i)
+	for (const auto& edge : tabu_list)
 	{
-		const size_t tmp = perm[c1];
-		perm[c1] = perm[c2 - (i - c1)];
-		perm[c2 - (i - c1)] = tmp;
-	}
-
-	const size_t c1_m_1 = c1 == 0 ? perm.size() - 1 : c1 - 1;
-	const size_t c2_m_1 = c2 == 0 ? perm.size() - 1 : c2 - 1;
-
-	const std::vector<size_t> edge0 = {parent[c1_m_1], parent[c1]};
-	const std::vector<size_t> edge1 = {parent[c2_m_1], parent[c2]};
-	edges.push_back(edge0);
-	edges.push_back(edge1);
-}
-
-
-bool is_tabu(std::vector<size_t>& permutation, std::vector<std::vector<size_t>>& tabu_list)
-{
-	for (size_t i = 0; i < permutation.size(); ++i)
-	{
-		const size_t c1 = permutation[i];
-		const size_t c2 = (i == permutation.size() - 1) ? permutation[0] : permutation[i + 1];
-		for (size_t j = 0; j < tabu_list.size(); ++j)
+		if ((edge[0] == c1 && edge[1] == c2) || (edge[0] == c2 && edge[1] == c1))
 		{
-			std::vector<size_t> forbidden_edge;
-			forbidden_edge.resize(tabu_list[j].size());
-			forbidden_edge = tabu_list[j];
-			std::vector<size_t> tmp = {c1, c2};
-			if (forbidden_edge == tmp)
-			{
-				return true;
-			}
+			return true;
 		}
 	}
 	return false;
 }
 
 
-void generate_candidate(candidate_solution& candidate, std::vector<std::vector<size_t>>& edges,
-                        candidate_solution& best,
-                        std::vector<std::vector<size_t>>& tabu_list,
-                        std::vector<std::vector<double>>& cities)
+// A move is tabu when it would add back an edge deleted by a recent move. The
+// current tour holds no tabu edge, so only the two added edges need a check.
+void generate_candidate(candidate_info& candidate, const candidate_solution& current,
+                        const std::vector<std::vector<size_t>>& tabu_list,
+                        const std::vector<std::vector<double>>& cities)
 {
-	std::vector<size_t> perm;
-	edges.clear();
-	stochastic_two_opt(perm, edges, best.vector);
-	while (is_tabu(perm, tabu_list))
+	size_t a, b, c, d;
+	do
 	{
-		stochastic_two_opt(perm, edges, best.vector);
+		candidate.move = clever::random_two_opt_move(current.vector.size());
+		clever::two_opt_cities(current.vector, candidate.move, a, b, c, d);
 	}
-	candidate.vector = perm;
-	candidate.cost = cost(candidate.vector, cities);
-}
-
+	while (is_tabu(a, c, tabu_list) || is_tabu(b, d, tabu_list));
 
-using candidate_info = struct candidate_info_t
-{
-	candidate_solution candidate;
-	std::vector<std::vector<size_t>> edges;
-};
+	candidate.cost = current.cost + clever::two_opt_delta(current.vector, candidate.move, cities);
+	candidate.edges = {{a, b}, {c, d}};
+}
 
 
-bool cmp(candidate_info& info_l, candidate_info& info_r)
+bool cmp(const candidate_info& info_l, const candidate_info& info_r)
 {
-	if (info_l.candidate.cost < info_r.candidate.cost)
+	if (info_l.cost < info_r.cost)
 	{
 		return true;
 	}
@@ -168,35 +61,34 @@ bool cmp(candidate_info& info_l, candidate_info& info_r)
 
 
 void search(candidate_solution& best,
-            std::vector<std::vector<double>>& cities,
+            const std::vector<std::vector<double>>& cities,
             const size_t tabu_list_size,
             const size_t candidate_list_size, const size_t max_iter)
 {
 	candidate_solution current;
-	random_permutation(current.vector, cities);
-	current.cost = cost(current.vector, cities);
+	clever::random_permutation(current.vector, cities.size());
+	current.cost = clever::tour_cost(current.vector, cities);
 	best = current;
 	std::vector<std::vector<size_t>> tabu_list;
 	tabu_list.clear();
 	for (size_t iter = 0; iter < max_iter; ++iter)
 	{
 		std::vector<candidate_info> candidates(candidate_list_size);
-		for (size_t i = 0; i < candidate_list_size; ++i)
+		for (auto& candidate : candidates)
 		{
-			generate_candidate(candidates[i].candidate, candidates[i].edges,
-			                   current, tabu_list, cities);
+			generate_candidate(candidate, current, tabu_list, cities);
 		}
 		std::sort(candidates.begin(), candidates.end(), cmp);
-		const candidate_solution best_candidate = candidates[0].candidate;
-		std::vector<std::vector<size_t>> best_candidate_edges = candidates[0].edges;
+		const auto& best_candidate = candidates[0];
 		if (best_candidate.cost < current.cost)
 		{
-			current = best_candidate;
-			if (best_candidate.cost < best.cost)
+			clever::apply_two_opt(current.vector, best_candidate.move);
+			current.cost = best_candidate.cost;
+			if (current.cost < best.cost)
 			{
-				best = best_candidate;
+				best = current;
 			}
-			for (auto& edge : best_candidate_edges)
+			for (auto& edge : best_candidate.edges)
 			{
 				tabu_list.push_back(edge);
 			}
@@ -206,31 +98,27 @@ void search(candidate_solution& best,
 			}
 		}
 		std::cout << " > iteration " << iter + 1 << ", best=" << best.cost << std::endl;
+		clever::trace_progress(1 + (iter + 1) * candidate_list_size, best.cost);
 	}
 }
 
 
 int main(int argc, char* argv[])
 {
-	// problem configuration
-	std::vector<std::vector<double>> berlin52 = {
-		{565, 575}, {25, 185}, {345, 750}, {945, 685}, {845, 655},
-		{880, 660}, {25, 230}, {525, 1000}, {580, 1175}, {650, 1130}, {1605, 620},
-		{1220, 580}, {1465, 200}, {1530, 5}, {845, 680}, {725, 370}, {145, 665},
-		{415, 635}, {510, 875}, {560, 365}, {300, 465}, {520, 585}, {480, 415},
-		{835, 625}, {975, 580}, {1215, 245}, {1320, 315}, {1250, 400}, {660, 180},
-		{410, 250}, {420, 555}, {575, 665}, {1150, 1160}, {700, 580}, {685, 595},
-		{685, 610}, {770, 610}, {795, 645}, {720, 635}, {760, 650}, {475, 960},
-		{95, 260}, {875, 920}, {700, 500}, {555, 815}, {830, 485}, {1170, 65},
-		{830, 610}, {605, 625}, {595, 360}, {1340, 725}, {1740, 245}
-	};
+	// problem configuration, a TSPLIB instance may be given instead of berlin52
+	auto cities = clever::berlin52();
+	if (argc > 1 && !clever::load_tsplib(argv[1], cities))
+	{
+		std::cout << "Cannot read the TSPLIB instance " << argv[1] << std::endl;
+		return 1;
+	}
 	// algorithm configuration
 	const size_t max_iter = 100;
 	const size_t tabu_list_size = 15;
 	const size_t max_candidates = 50;
 	// execute the algorithm
 	candidate_solution best;
-	search(best, berlin52, tabu_list_size, max_candidates, max_iter);
+	search(best, cities, tabu_list_size, max_candidates, max_iter);
 
 	std::cout << "Done. Best Solution: c=" << best.cost << ", v={ ";
 	for (auto& i : best.vector)
@@ -1,8 +0,0 @@
-#ifndef TEST_FUNCTIONS_H
-#define TEST_FUNCTIONS_H
-
-#include <vector>
-
-
-double ackley_function(std::vector<double> & x);
-#endif
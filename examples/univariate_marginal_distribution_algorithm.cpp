@@ -1,56 +1,26 @@
 #include <iostream>
-#include <random>
 #include <vector>
-#include <string>
 #include <algorithm>
 #include <cfloat>
 
-
-std::random_device rd;
-std::mt19937 generator(rd());
-std::uniform_real_distribution<> distribution(0.0, 1.0);
-auto random_ = []() { return distribution(generator); };
+#include "clever_algorithm.h"
 
 
 using candidate_solution = struct candidate_solution_st
 {
-	std::string bit_string;
+	clever::bit_string bit_string;
 	double fitness = DBL_MIN;
 };
 
 
-double onemax(const std::string& bit_string)
-{
-	double sum = 0.0;
-	for (auto& item : bit_string)
-	{
-		if (item == '1')
-		{
-			sum++;
-		}
-	}
-	return sum;
-}
-
-
-void random_bit_string(std::string& bit_string, const size_t size)
-{
-	bit_string.clear();
-	for (size_t i = 0; i < size; ++i)
-	{
-		bit_string.push_back(random_() < 0.5 ? '1' : '0');
-	}
-}
-
-
 void binary_tournament(candidate_solution& candidate,
 	const std::vector<candidate_solution>& pop)
 {
-	const auto i = static_cast<size_t>((pop.size() - 1) * random_());
-	auto j = static_cast<size_t>((pop.size() - 1) * random_());
+	const auto i = static_cast<size_t>((pop.size() - 1) * clever::random_uniform());
+	auto j = static_cast<size_t>((pop.size() - 1) * clever::random_uniform());
 	while (j == i)
 	{
-		j = static_cast<size_t>((pop.size() - 1) * random_());
+		j = static_cast<size_t>((pop.size() - 1) * clever::random_uniform());
 	}
 	candidate = pop[i].fitness > pop[j].fitness ? pop[i] : pop[j];
 }
@@ -69,7 +39,7 @@ void calculate_bit_probabilities(std::vector<double> & vector,
 	{
 		for(size_t i = 0; i < member.bit_string.size(); ++i)
 		{
-			vector[i] += (member.bit_string[i] - '0');
+			vector[i] += member.bit_string[i] ? 1.0 : 0.0;
 		}
 	}
 	for(size_t i = 0; i < vector.size(); ++i)
@@ -81,12 +51,7 @@ void calculate_bit_probabilities(std::vector<double> & vector,
 
 void generate_candidate(candidate_solution& candidate, const std::vector<double>& vector)
 {
-	candidate.bit_string.resize(vector.size());
-	for (size_t i = 0; i < vector.size(); ++i)
-	{
-		const auto& p = vector[i];
-		candidate.bit_string[i] = random_() < p ? '1' : '0';
-	}
+	clever::sample_bit_string(candidate.bit_string, vector);
 }
 
 
@@ -111,8 +76,8 @@ void search(candidate_solution& best,
 
 	for(auto & item : pop)
 	{
-		random_bit_string(item.bit_string, num_bits);
-		item.fitness = onemax(item.bit_string);
+		clever::random_bit_string(item.bit_string, num_bits);
+		item.fitness = clever::onemax(item.bit_string);
 	}
 	std::sort(pop.begin(), pop.end(), cmp_fitness);
 	best = pop[0];
@@ -130,7 +95,7 @@ void search(candidate_solution& best,
 		for(auto & item : samples)
 		{
 			generate_candidate(item, vector);
-			item.fitness = onemax(item.bit_string);
+			item.fitness = clever::onemax(item.bit_string);
 		}
 		std::sort(samples.begin(), samples.end(), cmp_fitness);
 		if(samples[0].fitness > best.fitness)
@@ -142,6 +107,7 @@ void search(candidate_solution& best,
 		std::cout << " > gen " << i + 1 << ", f = "
 			<< best.fitness << ", b = "
 			<< best.bit_string << std::endl;
+		clever::trace_progress((i + 2) * pop_size, best.fitness);
 
 		if (static_cast<size_t>(best.fitness) == num_bits)
 		{
@@ -0,0 +1,91 @@
+#ifndef CLEVER_ALIGNED_ALLOCATOR_H
+#define CLEVER_ALIGNED_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+
+namespace clever
+{
+	// one x86 cache line, also the width of an AVX-512 register
+	const size_t cache_line_size = 64;
+
+
+	// Allocator returning storage aligned to Alignment bytes, so that packed
+	// loads never split a cache line.
+	template <typename T, size_t Alignment = cache_line_size>
+	class aligned_allocator
+	{
+	public:
+		using value_type = T;
+
+		template <typename U>
+		struct rebind
+		{
+			using other = aligned_allocator<U, Alignment>;
+		};
+
+		aligned_allocator() = default;
+
+		template <typename U>
+		aligned_allocator(const aligned_allocator<U, Alignment>&)
+		{
+		}
+
+		T* allocate(const size_t n)
+		{
+			if (n == 0)
+			{
+				return nullptr;
+			}
+			void* p = nullptr;
+#ifdef _MSC_VER
+			p = _aligned_malloc(n * sizeof(T), Alignment);
+#else
+			if (posix_memalign(&p, Alignment, n * sizeof(T)) != 0)
+			{
+				p = nullptr;
+			}
+#endif
+			if (p == nullptr)
+			{
+				throw std::bad_alloc();
+			}
+			return static_cast<T*>(p);
+		}
+
+		void deallocate(T* p, size_t)
+		{
+#ifdef _MSC_VER
+			_aligned_free(p);
+#else
+			free(p);
+#endif
+		}
+	};
+
+
+	template <typename T, typename U, size_t Alignment>
+	bool operator==(const aligned_allocator<T, Alignment>&, const aligned_allocator<U, Alignment>&)
+	{
+		return true;
+	}
+
+	template <typename T, typename U, size_t Alignment>
+	bool operator!=(const aligned_allocator<T, Alignment>&, const aligned_allocator<U, Alignment>&)
+	{
+		return false;
+	}
+
+
+	template <typename T>
+	using aligned_vector = std::vector<T, aligned_allocator<T>>;
+}
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef CLEVER_BATCH_FUNCTIONS_H
+#define CLEVER_BATCH_FUNCTIONS_H
+
+#include <functional>
+#include <vector>
+
+#include "clever/candidate_batch.h"
+
+
+namespace clever
+{
+	enum class simd_level
+	{
+		// portable code, whatever the compiler makes of it
+		scalar,
+		// 4 candidates per register, needs FMA as well
+		avx2,
+		// 8 candidates per register
+		avx512
+	};
+
+	// Widest level this CPU runs. The vector code is only built by GCC on
+	// x86 (it relies on #pragma GCC target), so other compilers and
+	// architectures, Clang included, always get scalar.
+	simd_level supported_simd_level();
+
+	// Level the batch functions use. It starts at the supported level, or at
+	// the one named by the CLEVER_SIMD environment variable (scalar, avx2 or
+	// avx512) if that is lower.
+	simd_level active_simd_level();
+
+	// Selects the level for later calls, capped at the supported level.
+	// Returns the level actually selected.
+	simd_level set_simd_level(simd_level level);
+
+
+	using batch_objective_function = std::function<void(const candidate_batch&, std::vector<double>&)>;
+
+	// costs[i] = f(candidate i) for the test functions of test_functions.h,
+	// evaluated a register of candidates at a time. Results agree with the
+	// single-vector functions to a few ulps; exp, sin and cos are polynomial
+	// approximations in the SIMD levels.
+	void sphere_batch(const candidate_batch& batch, std::vector<double>& costs);
+	void ackley_batch(const candidate_batch& batch, std::vector<double>& costs);
+	void rastrigin_batch(const candidate_batch& batch, std::vector<double>& costs);
+	void rosenbrock_batch(const candidate_batch& batch, std::vector<double>& costs);
+	void griewank_batch(const candidate_batch& batch, std::vector<double>& costs);
+	void schwefel_batch(const candidate_batch& batch, std::vector<double>& costs);
+	void sum_squares_batch(const candidate_batch& batch, std::vector<double>& costs);
+	void rotated_hyper_ellipsoid_batch(const candidate_batch& batch, std::vector<double>& costs);
+
+	// out[i] = squared Euclidean distance from query, dimensions() values,
+	// to candidate i; a nearest-neighbour scan a register of candidates at
+	// a time
+	void squared_distances(const candidate_batch& batch, const double* query, std::vector<double>& out);
+}
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef CLEVER_BAYESIAN_NETWORK_H
+#define CLEVER_BAYESIAN_NETWORK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "clever/bit_string.h"
+#include "clever/random.h"
+#include "clever/thread_pool.h"
+
+
+namespace clever
+{
+	// log of the K2 metric of one binary node,
+	//   sum over parent configurations j of log(N_j0! N_j1! / (N_j + 1)!)
+	// with counts[2 * j + b] = N_jb, the samples in configuration j whose
+	// node is b. Exact for any number of samples, where the product form
+	// overflows past 170!.
+	double k2_log_score(const std::vector<size_t>& counts);
+
+
+	// Bayesian network over binary variables, the model of the Bayesian
+	// optimization algorithm. Parent configurations are numbered with parent
+	// m of parents(node) as bit m.
+	class bayesian_network
+	{
+	public:
+		// Greedy K2 structure search over samples, all of the same length:
+		// repeatedly adds the edge that raises the log K2 score the most,
+		// keeping the graph acyclic and every node at no more than
+		// max_parents parents, until no edge helps or max_edges are in.
+		// The samples are transposed into one bit column per variable and
+		// every parent configuration of a node keeps its own sample mask,
+		// so a candidate parent is scored with a few popcounts over the
+		// columns. The gains of a node are only recomputed when its parent
+		// set changes, spread over the pool, and each node remembers its
+		// best candidate so that picking an edge is a scan over the nodes.
+		// Ends by filling the conditional probability tables.
+		void learn(const std::vector<bit_string>& samples, size_t max_edges, size_t max_parents = 2,
+		           thread_pool& pool = default_pool());
+
+		size_t size() const { return parents_.size(); }
+		size_t edges() const { return edges_; }
+		const std::vector<size_t>& parents(const size_t node) const { return parents_[node]; }
+		const std::vector<size_t>& children(const size_t node) const { return children_[node]; }
+
+		// log K2 score of node with its current parents
+		double score(const size_t node) const { return scores_[node]; }
+
+		// the nodes, every parent before its children
+		void topological_order(std::vector<size_t>& order) const;
+
+		// P(node = 1 | parent configuration), the frequency N_j1 / N_j of
+		// the samples, or (N_j1 + 1/2) / (N_j + 1) when they all agree;
+		// configurations no sample shows take the node's frequency over
+		// all of them
+		double probability(const size_t node, const size_t configuration) const
+		{
+			return probabilities_[node][configuration];
+		}
+
+		// One draw from the network: the nodes in topological order, each a
+		// lookup in its probability table.
+		void sample(bit_string& bits, random_engine& rng = default_engine()) const;
+
+		// count draws spread over the pool; draw i uses stream i of seed, so
+		// the samples do not depend on the number of threads
+		void sample(std::vector<bit_string>& samples, size_t count, std::uint64_t seed,
+		            thread_pool& pool = default_pool()) const;
+
+	private:
+		// log K2 score of node with parent added to its parents
+		double score_with(size_t node, size_t parent) const;
+		void update_gains(size_t node, thread_pool& pool);
+		void update_best(size_t node);
+		bool path_exists(size_t from, size_t to) const;
+		void add_edge(size_t parent, size_t child, thread_pool& pool);
+
+		size_t num_samples_ = 0;
+		size_t max_parents_ = 2;
+		size_t edges_ = 0;
+		std::vector<std::vector<size_t>> parents_;
+		std::vector<std::vector<size_t>> children_;
+		std::vector<double> scores_;
+		// column i holds variable i of every sample
+		std::vector<bit_string> columns_;
+		// per node, the samples in each configuration of its parents, and
+		// the contingency counts counts_[node][2 * configuration + bit]
+		std::vector<std::vector<bit_string>> configurations_;
+		std::vector<std::vector<size_t>> counts_;
+		// log_factorial_[n] = log(n!) for n up to num_samples_ + 1
+		std::vector<double> log_factorial_;
+		// gains_[child * size() + parent], -DBL_MAX where the edge is not
+		// allowed; best_[child] indexes the largest gain of the row
+		std::vector<double> gains_;
+		std::vector<size_t> best_;
+		// probabilities_[node][configuration] and the order sampling uses
+		std::vector<std::vector<double>> probabilities_;
+		std::vector<size_t> order_;
+		mutable std::vector<char> visited_;
+		mutable std::vector<size_t> stack_;
+	};
+}
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef CLEVER_BENCHMARK_H
+#define CLEVER_BENCHMARK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+namespace clever
+{
+	// seconds since the library was loaded, i.e. about since process start
+	double elapsed_seconds();
+
+	// Appends a "seconds evaluations best" line to the file named by the
+	// CLEVER_TRACE environment variable, and does nothing when it is unset.
+	// The recipes call it once per iteration so that the benchmark runner
+	// can rebuild their best-so-far curves. Safe to call from any thread.
+	void trace_progress(size_t evaluations, double best);
+
+	// peak resident set size of this process in kilobytes, 0 where unknown
+	size_t peak_memory_kb();
+
+
+	using trace_point = struct trace_point_t
+	{
+		double seconds = 0.0;
+		size_t evaluations = 0;
+		double best = 0.0;
+	};
+
+	// parses the lines written by trace_progress
+	void read_trace(std::istream& in, std::vector<trace_point>& curve);
+
+	// seconds until best first reached target, negative when it never did
+	double time_to_target(const std::vector<trace_point>& curve, double target, bool minimize);
+
+
+	using benchmark_run = struct benchmark_run_t
+	{
+		std::string algorithm;
+		std::uint64_t seed = 0;
+		// false when the run crashed or hit the time limit
+		bool completed = false;
+		double seconds = 0.0;
+		size_t evaluations = 0;
+		double best = 0.0;
+		double time_to_target = -1.0;
+		size_t peak_memory_kb = 0;
+		std::vector<trace_point> curve;
+	};
+
+	double evaluations_per_second(const benchmark_run& run);
+
+	// one row per run
+	void write_csv(std::ostream& out, const std::vector<benchmark_run>& runs);
+	// one row per trace point: algorithm, seed, seconds, evaluations, best
+	void write_curves_csv(std::ostream& out, const std::vector<benchmark_run>& runs);
+	// every run with its curve
+	void write_json(std::ostream& out, const std::vector<benchmark_run>& runs);
+}
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef CLEVER_BIT_STRING_H
+#define CLEVER_BIT_STRING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "clever/random.h"
+
+
+namespace clever
+{
+	// Binary genome packed into 64-bit words. Bit i lives in word i / 64 at
+	// position i % 64; bits past size() are kept zero so that whole-word
+	// operations (popcount, masks, comparison) need no special tail case.
+	class bit_string
+	{
+	public:
+		using word_type = std::uint64_t;
+		static const size_t word_bits = 64;
+
+		bit_string() = default;
+		// size zero bits
+		explicit bit_string(size_t size);
+
+		size_t size() const { return size_; }
+		bool empty() const { return size_ == 0; }
+		void resize(size_t size);
+
+		bool operator[](const size_t i) const { return (words_[i / word_bits] >> (i % word_bits)) & 1u; }
+		void set(const size_t i, const bool value)
+		{
+			const auto mask = word_type(1) << (i % word_bits);
+			auto& word = words_[i / word_bits];
+			word = value ? (word | mask) : (word & ~mask);
+		}
+		void flip(const size_t i) { words_[i / word_bits] ^= word_type(1) << (i % word_bits); }
+		// sets every bit to zero, keeping the size
+		void reset();
+
+		// number of set bits
+		size_t count() const;
+
+		size_t num_words() const { return words_.size(); }
+		word_type* words() { return words_.data(); }
+		const word_type* words() const { return words_.data(); }
+		// zeroes the bits past size() after the words were written directly
+		void clear_tail();
+
+		// '0'/'1' characters, bit 0 first
+		std::string to_string() const;
+
+		bool operator==(const bit_string& other) const
+		{
+			return size_ == other.size_ && words_ == other.words_;
+		}
+		bool operator!=(const bit_string& other) const { return !(*this == other); }
+
+	private:
+		size_t size_ = 0;
+		std::vector<word_type> words_;
+	};
+
+
+	std::ostream& operator<<(std::ostream& out, const bit_string& bits);
+
+
+	size_t popcount(bit_string::word_type word);
+
+
+	// size uniformly random bits, drawn a word at a time
+	void random_bit_string(bit_string& bits, size_t size, random_engine& rng = default_engine());
+
+	// bit i is set with probability probabilities[i]
+	void sample_bit_string(bit_string& bits, const std::vector<double>& probabilities,
+	                       random_engine& rng = default_engine());
+
+	// Flips every bit independently with probability rate. The gaps between
+	// flipped bits are drawn from the geometric distribution, so the cost is
+	// proportional to the number of flips rather than to the length.
+	void point_mutation(bit_string& bits, double rate, random_engine& rng = default_engine());
+
+	// child = parent1[0, point) + parent2[point, size), built from word masks
+	void one_point_crossover(bit_string& child, const bit_string& parent1, const bit_string& parent2,
+	                         size_t point);
+
+	// every bit comes from either parent with probability 0.5
+	void uniform_crossover(bit_string& child, const bit_string& parent1, const bit_string& parent2,
+	                       random_engine& rng = default_engine());
+
+	// number of set bits, the classic binary benchmark
+	double onemax(const bit_string& bits);
+}
+
+#endif
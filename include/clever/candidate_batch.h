@@ -0,0 +1,73 @@
+#ifndef CLEVER_CANDIDATE_BATCH_H
+#define CLEVER_CANDIDATE_BATCH_H
+
+#include <cstddef>
+#include <vector>
+
+#include "clever/aligned_allocator.h"
+
+
+namespace clever
+{
+	// Real vectors of a population stored structure-of-arrays: the values of
+	// dimension d of every candidate are contiguous, so one SIMD register
+	// holds the same dimension of several candidates. Each dimension row is
+	// padded to whole cache lines so kernels may always load and store full
+	// registers; the padding starts at zero and is never part of a result.
+	class candidate_batch
+	{
+	public:
+		// doubles per cache line, the stride is a multiple of it
+		static const size_t lanes = cache_line_size / sizeof(double);
+
+		candidate_batch() = default;
+		candidate_batch(size_t size, size_t dimensions);
+
+		// zeroes every value
+		void resize(size_t size, size_t dimensions);
+
+		size_t size() const { return size_; }
+		size_t dimensions() const { return dimensions_; }
+		size_t stride() const { return stride_; }
+
+		double& operator()(const size_t i, const size_t d) { return values_[d * stride_ + i]; }
+		double operator()(const size_t i, const size_t d) const { return values_[d * stride_ + i]; }
+
+		// dimension d of every candidate, stride() values long
+		double* dimension(const size_t d) { return values_.data() + d * stride_; }
+		const double* dimension(const size_t d) const { return values_.data() + d * stride_; }
+
+		// copies candidate i from / to an ordinary vector
+		void set(size_t i, const std::vector<double>& vector);
+		void get(size_t i, std::vector<double>& vector) const;
+
+		// candidate i = candidate j of from, which has the same dimensions
+		void copy(size_t i, const candidate_batch& from, size_t j);
+
+		// Becomes the candidates from[indices[0]], from[indices[1]], ...,
+		// e.g. the survivors of a selection; from must be another batch.
+		void gather(const candidate_batch& from, const std::vector<size_t>& indices);
+
+		// becomes the candidates of a followed by those of b
+		void concatenate(const candidate_batch& a, const candidate_batch& b);
+
+		// Room for capacity candidates: the rows are laid out again with a
+		// stride of at least capacity, so the stride can run ahead of the
+		// size and kernels then also cover the zero padding past it.
+		void reserve(size_t capacity);
+
+		// Appends a candidate with dimensions() values, or sets the
+		// dimensions when the batch is empty. The capacity doubles when it
+		// runs out, so a run of appends copies every value a constant
+		// number of times on average.
+		void push_back(const std::vector<double>& vector);
+
+	private:
+		size_t size_ = 0;
+		size_t dimensions_ = 0;
+		size_t stride_ = 0;
+		aligned_vector<double> values_;
+	};
+}
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef CLEVER_DATASET_H
+#define CLEVER_DATASET_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+namespace clever
+{
+	// Row-major table of doubles read in place: row i starts at
+	// data + i * stride. A view never owns or copies its values.
+	class dataset_view
+	{
+	public:
+		dataset_view() = default;
+		// stride == 0 packs the rows, stride = columns
+		dataset_view(const double* data, size_t rows, size_t columns, size_t stride = 0)
+			: data_(data), rows_(rows), columns_(columns), stride_(stride == 0 ? columns : stride)
+		{
+		}
+
+		size_t rows() const { return rows_; }
+		size_t columns() const { return columns_; }
+		size_t stride() const { return stride_; }
+		bool empty() const { return rows_ == 0; }
+
+		const double* row(const size_t i) const { return data_ + i * stride_; }
+		double operator()(const size_t i, const size_t j) const { return data_[i * stride_ + j]; }
+
+		// rows [first, first + count)
+		dataset_view slice(const size_t first, const size_t count) const
+		{
+			return dataset_view(row(first), count, columns_, stride_);
+		}
+
+	private:
+		const double* data_ = nullptr;
+		size_t rows_ = 0;
+		size_t columns_ = 0;
+		size_t stride_ = 0;
+	};
+
+
+	// Binary file of packed row-major doubles in native byte order, mapped
+	// into memory where the platform has mmap and read into a buffer
+	// elsewhere. Mapped pages are loaded as rows are touched, so files
+	// larger than memory can be streamed through.
+	class mapped_dataset
+	{
+	public:
+		mapped_dataset() = default;
+		~mapped_dataset() { close(); }
+
+		mapped_dataset(const mapped_dataset&) = delete;
+		mapped_dataset& operator=(const mapped_dataset&) = delete;
+
+		// false when the file cannot be read or does not hold a whole
+		// number of rows of columns values
+		bool open(const std::string& path, size_t columns);
+		void close();
+		bool is_open() const { return data_ != nullptr; }
+
+		dataset_view view() const { return dataset_view(data_, rows_, columns_); }
+
+	private:
+		const double* data_ = nullptr;
+		size_t rows_ = 0;
+		size_t columns_ = 0;
+		// bytes mapped, 0 when the values are in buffer_
+		size_t mapped_ = 0;
+		std::vector<double> buffer_;
+	};
+
+
+	// writes the rows of data packed, as mapped_dataset reads them
+	bool save_dataset(const std::string& path, const dataset_view& data);
+}
+
+#endif
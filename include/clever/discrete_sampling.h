@@ -0,0 +1,96 @@
+#ifndef CLEVER_DISCRETE_SAMPLING_H
+#define CLEVER_DISCRETE_SAMPLING_H
+
+#include <cstddef>
+#include <vector>
+
+#include "clever/random.h"
+
+
+namespace clever
+{
+	// Walker's alias method for repeated draws from a fixed distribution:
+	// after an O(n) build every draw is one uniform number, a table lookup
+	// and a comparison, whatever the number of outcomes.
+	class alias_table
+	{
+	public:
+		alias_table() = default;
+		// weights need not be normalized; all zero draws uniformly
+		explicit alias_table(const std::vector<double>& weights) { build(weights); }
+
+		void build(const std::vector<double>& weights);
+
+		size_t size() const { return probability_.size(); }
+
+		// index i with probability weights[i] / sum of weights
+		size_t sample(random_engine& rng = default_engine()) const
+		{
+			const auto u = rng.uniform() * static_cast<double>(probability_.size());
+			const auto i = static_cast<size_t>(u);
+			return u - static_cast<double>(i) < probability_[i] ? i : alias_[i];
+		}
+
+	private:
+		// probability_[i] keeps column i, alias_[i] takes the rest of it
+		std::vector<double> probability_;
+		std::vector<size_t> alias_;
+	};
+
+
+	// weights[k] = (k + 1)^-tau for k < n, the rank distribution of
+	// tau-extremal optimization
+	void power_law_weights(std::vector<double>& weights, size_t n, double tau);
+
+
+	// A draw from prefix sums: the first i with u * cumulative[n - 1] <
+	// cumulative[i], found by binary search; n when the total is not
+	// positive.
+	size_t sample_cumulative(const double* cumulative, size_t n, random_engine& rng = default_engine());
+
+	// One draw from weights that are used only once, such as an ant's
+	// choices from the city it stands on: the weights are replaced by their
+	// prefix sums, taken with packed math, and searched as above.
+	size_t sample_once(double* weights, size_t n, random_engine& rng = default_engine());
+
+
+	// Binary indexed tree over non-negative weights for distributions that
+	// change one weight at a time: updates, prefix sums and draws all take
+	// O(log n).
+	class fenwick_tree
+	{
+	public:
+		fenwick_tree() = default;
+		// size zero weights
+		explicit fenwick_tree(const size_t size) { resize(size); }
+		explicit fenwick_tree(const std::vector<double>& weights) { assign(weights); }
+
+		void resize(size_t size);
+		// O(n) build
+		void assign(const std::vector<double>& weights);
+
+		size_t size() const { return weights_.size(); }
+		double weight(const size_t i) const { return weights_[i]; }
+		double total() const { return prefix(size()); }
+
+		void add(size_t i, double delta);
+		void set(const size_t i, const double weight) { add(i, weight - weights_[i]); }
+
+		// sum of the first count weights
+		double prefix(size_t count) const;
+
+		// the index whose interval [prefix(i), prefix(i + 1)) holds target,
+		// for 0 <= target < total()
+		size_t find(double target) const;
+
+		// index i with probability weight(i) / total()
+		size_t sample(random_engine& rng = default_engine()) const { return find(rng.uniform() * total()); }
+
+	private:
+		std::vector<double> weights_;
+		// tree_[k - 1] sums the weights of (k - (k & -k), k]
+		std::vector<double> tree_;
+	};
+}
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef CLEVER_DISTANCE_H
+#define CLEVER_DISTANCE_H
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "clever/tsp.h"
+
+
+namespace clever
+{
+	enum class distance_storage
+	{
+		// dense for instances up to dense_limit cities, on the fly beyond
+		automatic,
+		// full n x n matrix of doubles
+		dense,
+		// full n x n matrix of floats, half the memory of dense
+		dense_float,
+		// recomputed from the coordinates on every lookup, O(n) memory
+		on_the_fly
+	};
+
+
+	// Euclidean distances between the cities of an instance, shared by the TSP
+	// solvers. Optionally keeps the k nearest neighbours of every city as
+	// candidate lists, found with a k-d tree.
+	class distance_provider
+	{
+	public:
+		// 4000 cities is a 128 MB double matrix
+		static const size_t dense_limit = 4000;
+
+		explicit distance_provider(const city_list& cities, distance_storage storage = distance_storage::automatic);
+
+		size_t size() const { return size_; }
+		distance_storage storage() const { return storage_; }
+
+		double operator()(const size_t i, const size_t j) const
+		{
+			switch (storage_)
+			{
+			case distance_storage::dense:
+				return dense_[i * size_ + j];
+			case distance_storage::dense_float:
+				return dense_float_[i * size_ + j];
+			default:
+				return compute(i, j);
+			}
+		}
+
+		// out[j] = distance from city i to city j for every j
+		void distances_from(size_t i, double* out) const;
+
+		// builds the candidate lists; k is capped at size() - 1
+		void build_neighbor_lists(size_t k);
+		size_t num_neighbors() const { return k_; }
+		// the num_neighbors() cities closest to i, nearest first
+		const size_t* neighbors(const size_t i) const { return &neighbors_[i * k_]; }
+
+	private:
+		double compute(const size_t i, const size_t j) const
+		{
+			double sum = 0.0;
+			for (const auto& axis : coordinates_)
+			{
+				sum += (axis[i] - axis[j]) * (axis[i] - axis[j]);
+			}
+			return std::sqrt(sum);
+		}
+
+		void compute_row(size_t i, double* out) const;
+
+		size_t size_ = 0;
+		distance_storage storage_;
+		// one array per dimension so that rows are computed with packed math
+		std::vector<std::vector<double>> coordinates_;
+		std::vector<double> dense_;
+		std::vector<float> dense_float_;
+		size_t k_ = 0;
+		std::vector<size_t> neighbors_;
+	};
+}
+
+#endif
@@ -0,0 +1,227 @@
+#ifndef CLEVER_EVALUATION_QUEUE_H
+#define CLEVER_EVALUATION_QUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "clever/thread_pool.h"
+
+
+namespace clever
+{
+	// Candidates evaluated by a set of worker threads of their own, handed
+	// back in the order their evaluations finish. There is no barrier between
+	// candidates, so a slow evaluation only holds up its own worker. At most
+	// capacity candidates are waiting or being evaluated at any time; submit
+	// blocks beyond that, which bounds the memory and keeps the breeding
+	// thread from running ahead of the population it breeds from.
+	template <typename T>
+	class evaluation_queue
+	{
+	public:
+		// evaluate(candidate) stores the result in the candidate and runs on
+		// several workers at once; num_threads == 0 uses as many workers as
+		// default_pool has threads, capacity == 0 twice that many
+		explicit evaluation_queue(std::function<void(T&)> evaluate, const size_t num_threads = 0,
+		                          const size_t capacity = 0)
+			: evaluate_(std::move(evaluate))
+		{
+			const auto n = num_threads == 0 ? default_pool().size() : num_threads;
+			capacity_ = capacity == 0 ? 2 * n : capacity;
+			for (size_t i = 0; i < n; ++i)
+			{
+				workers_.emplace_back(&evaluation_queue::worker_loop, this);
+			}
+		}
+
+		// candidates not yet started are dropped, running ones finish first
+		~evaluation_queue()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				stop_ = true;
+			}
+			pending_changed_.notify_all();
+			for (auto& worker : workers_)
+			{
+				worker.join();
+			}
+		}
+
+		evaluation_queue(const evaluation_queue&) = delete;
+		evaluation_queue& operator=(const evaluation_queue&) = delete;
+
+		size_t capacity() const { return capacity_; }
+		size_t threads() const { return workers_.size(); }
+
+		// candidates submitted whose result has not been taken yet
+		size_t in_flight() const
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			return in_flight_;
+		}
+
+		// queues candidate for evaluation, waits while capacity are in flight
+		void submit(T candidate)
+		{
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				space_.wait(lock, [this]() { return in_flight_ < capacity_; });
+				++in_flight_;
+				pending_.push_back(std::move(candidate));
+			}
+			pending_changed_.notify_one();
+		}
+
+		// Waits for the next finished candidate. False when nothing is in
+		// flight. Rethrows the first exception thrown by evaluate.
+		bool next(T& evaluated)
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			finished_changed_.wait(lock, [this]() { return !finished_.empty() || error_ || in_flight_ == 0; });
+			if (error_)
+			{
+				auto error = error_;
+				error_ = nullptr;
+				std::rethrow_exception(error);
+			}
+			if (finished_.empty())
+			{
+				return false;
+			}
+			evaluated = std::move(finished_.front());
+			finished_.pop_front();
+			--in_flight_;
+			lock.unlock();
+			space_.notify_one();
+			return true;
+		}
+
+		// drops the candidates no worker has started on yet
+		void clear()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				in_flight_ -= pending_.size();
+				pending_.clear();
+			}
+			space_.notify_all();
+			finished_changed_.notify_all();
+		}
+
+	private:
+		void worker_loop()
+		{
+			for (;;)
+			{
+				T candidate;
+				{
+					std::unique_lock<std::mutex> lock(mutex_);
+					pending_changed_.wait(lock, [this]() { return stop_ || !pending_.empty(); });
+					if (stop_)
+					{
+						return;
+					}
+					candidate = std::move(pending_.front());
+					pending_.pop_front();
+				}
+
+				std::exception_ptr error;
+				try
+				{
+					evaluate_(candidate);
+				}
+				catch (...)
+				{
+					error = std::current_exception();
+				}
+
+				{
+					std::lock_guard<std::mutex> lock(mutex_);
+					if (error)
+					{
+						// the candidate is lost, its slot is freed
+						--in_flight_;
+						if (!error_)
+						{
+							error_ = error;
+						}
+					}
+					else
+					{
+						finished_.push_back(std::move(candidate));
+					}
+				}
+				finished_changed_.notify_one();
+				if (error)
+				{
+					space_.notify_one();
+				}
+			}
+		}
+
+		std::function<void(T&)> evaluate_;
+		size_t capacity_ = 0;
+		std::vector<std::thread> workers_;
+
+		mutable std::mutex mutex_;
+		std::condition_variable pending_changed_;
+		std::condition_variable finished_changed_;
+		std::condition_variable space_;
+		std::deque<T> pending_;
+		std::deque<T> finished_;
+		size_t in_flight_ = 0;
+		bool stop_ = false;
+		std::exception_ptr error_;
+	};
+
+
+	// Asynchronous steady-state loop. Keeps the queue full of children from
+	// breed(), and hands every evaluated child to replace(child) the moment
+	// it comes back, so breeding always sees the latest population. Stops
+	// after evaluations children, or as soon as replace returns false; then
+	// the children still queued are dropped and the running ones awaited.
+	// Returns the number of children replace has seen. breed and replace
+	// both run on the calling thread.
+	template <typename T, typename Breed, typename Replace>
+	size_t steady_state(evaluation_queue<T>& queue, const size_t evaluations, Breed breed, Replace replace)
+	{
+		size_t submitted = 0;
+		size_t received = 0;
+		while (submitted < evaluations && queue.in_flight() < queue.capacity())
+		{
+			queue.submit(breed());
+			++submitted;
+		}
+
+		T child;
+		while (queue.next(child))
+		{
+			++received;
+			if (!replace(child))
+			{
+				break;
+			}
+			if (submitted < evaluations)
+			{
+				queue.submit(breed());
+				++submitted;
+			}
+		}
+
+		queue.clear();
+		while (queue.next(child))
+		{
+		}
+		return received;
+	}
+}
+
+#endif
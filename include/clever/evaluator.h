@@ -0,0 +1,83 @@
+#ifndef CLEVER_EVALUATOR_H
+#define CLEVER_EVALUATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "clever/batch_functions.h"
+#include "clever/candidate_batch.h"
+#include "clever/random.h"
+#include "clever/thread_pool.h"
+
+
+namespace clever
+{
+	using objective_function = std::function<double(const std::vector<double>&)>;
+
+
+	// Wraps an objective function and counts how often it is called, so that
+	// algorithms can be compared by evaluations rather than by iterations.
+	class evaluator
+	{
+	public:
+		explicit evaluator(objective_function function);
+		// batch evaluates a whole candidate_batch at once, e.g. sphere_batch
+		evaluator(objective_function function, batch_objective_function batch);
+
+		evaluator(const evaluator&) = delete;
+		evaluator& operator=(const evaluator&) = delete;
+
+		double operator()(const std::vector<double>& vector) const;
+
+		// costs[i] = f(vectors[i]), spread over the pool; the wrapped function
+		// must be safe to call concurrently
+		void evaluate_batch(const std::vector<std::vector<double>>& vectors, std::vector<double>& costs,
+		                    thread_pool& pool = default_pool()) const;
+
+		// costs[i] = f(candidate i); uses the batch function when there is
+		// one, otherwise calls the wrapped function per candidate on the pool
+		void evaluate_batch(const candidate_batch& batch, std::vector<double>& costs,
+		                    thread_pool& pool = default_pool()) const;
+
+		size_t evaluations() const;
+		void reset_evaluations();
+
+	private:
+		objective_function function_;
+		batch_objective_function batch_;
+		mutable std::atomic<size_t> evaluations_;
+	};
+
+
+	// Runs evaluate(candidate) for every member of the population on the pool.
+	// evaluate may only write to the candidate it is given.
+	template <typename Candidate, typename Function>
+	void evaluate_population(std::vector<Candidate>& population, Function evaluate,
+	                         thread_pool& pool = default_pool())
+	{
+		pool.parallel_for(population.size(), [&](const size_t i)
+		{
+			evaluate(population[i]);
+		});
+	}
+
+
+	// As above for stochastic objectives: evaluate(candidate, rng) draws from
+	// stream i of seed for candidate i, so the result does not depend on how
+	// many threads the pool has.
+	template <typename Candidate, typename Function>
+	void evaluate_population(std::vector<Candidate>& population, const std::uint64_t seed, Function evaluate,
+	                         thread_pool& pool = default_pool())
+	{
+		pool.parallel_for(population.size(), [&](const size_t i)
+		{
+			random_engine rng(seed, i);
+			evaluate(population[i], rng);
+		});
+	}
+}
+
+#endif
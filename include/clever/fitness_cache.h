@@ -0,0 +1,107 @@
+#ifndef CLEVER_FITNESS_CACHE_H
+#define CLEVER_FITNESS_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "clever/bit_string.h"
+
+
+namespace clever
+{
+	// 64-bit hashes of genomes, a multiply-xorshift mix over whole words
+	std::uint64_t hash_genome(const bit_string& bits);
+	std::uint64_t hash_genome(const std::string& bits);
+
+
+	// Bounded memo of fitness values keyed by genome, so that clones,
+	// surviving elites and converged populations are not evaluated twice.
+	// Entries are spread over shards by hash, each with its own lock, so
+	// evaluations on the thread pool rarely contend. A full shard evicts with
+	// the CLOCK policy: a hit only marks its entry as referenced, and the
+	// clock hand passes over referenced entries once before evicting them.
+	// The whole genome is stored and compared, so hash collisions cost a
+	// miss but never a wrong fitness. Instantiated for bit_string and for
+	// genomes held as '0'/'1' strings.
+	template <typename Genome>
+	class basic_fitness_cache
+	{
+	public:
+		// capacity is split evenly over the shards, rounding up; capacity == 0
+		// disables the cache and get then always evaluates
+		explicit basic_fitness_cache(size_t capacity, size_t num_shards = 16);
+
+		basic_fitness_cache(const basic_fitness_cache&) = delete;
+		basic_fitness_cache& operator=(const basic_fitness_cache&) = delete;
+
+		size_t capacity() const { return capacity_; }
+		size_t size() const;
+
+		// true and the cached fitness on a hit; counts the hit or miss
+		bool find(const Genome& genome, double& fitness);
+		void insert(const Genome& genome, double fitness);
+
+		// Cached fitness of genome, or evaluate() on a miss. Threads missing
+		// on the same genome at once each evaluate it.
+		template <typename Function>
+		double get(const Genome& genome, Function evaluate)
+		{
+			double fitness;
+			if (capacity_ == 0)
+			{
+				return evaluate();
+			}
+			if (find(genome, fitness))
+			{
+				return fitness;
+			}
+			fitness = evaluate();
+			insert(genome, fitness);
+			return fitness;
+		}
+
+		size_t hits() const { return hits_.load(std::memory_order_relaxed); }
+		size_t misses() const { return misses_.load(std::memory_order_relaxed); }
+
+		// drops every entry and zeroes the counters
+		void clear();
+
+	private:
+		using entry = struct entry_t
+		{
+			Genome genome;
+			std::uint64_t hash = 0;
+			double fitness = 0.0;
+			bool referenced = false;
+		};
+
+		using shard = struct shard_t
+		{
+			std::mutex mutex;
+			// hash -> index into entries
+			std::unordered_map<std::uint64_t, size_t> index;
+			std::vector<entry> entries;
+			size_t hand = 0;
+		};
+
+		shard& shard_of(const std::uint64_t hash) { return *shards_[(hash >> 32) % shards_.size()]; }
+
+		size_t capacity_ = 0;
+		size_t shard_capacity_ = 0;
+		std::vector<std::unique_ptr<shard>> shards_;
+		std::atomic<size_t> hits_;
+		std::atomic<size_t> misses_;
+	};
+
+
+	using fitness_cache = basic_fitness_cache<bit_string>;
+	using string_fitness_cache = basic_fitness_cache<std::string>;
+}
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef CLEVER_KD_TREE_H
+#define CLEVER_KD_TREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+
+namespace clever
+{
+	// Static k-d tree over a point set, stored implicitly: the points are
+	// reordered so that the median of every range is the splitting node.
+	class kd_tree
+	{
+	public:
+		static const size_t npos = std::numeric_limits<size_t>::max();
+
+		kd_tree() = default;
+		explicit kd_tree(const std::vector<std::vector<double>>& points);
+		kd_tree(const double* points, size_t count, size_t dimensions);
+
+		void build(const std::vector<std::vector<double>>& points);
+		// count points of dimensions coordinates each, packed row-major
+		void build(const double* points, size_t count, size_t dimensions);
+
+		size_t size() const { return order_.size(); }
+		size_t dimensions() const { return dims_; }
+
+		// Indices of the k points nearest to query, closest first. The point
+		// with index exclude (e.g. the query itself) is skipped.
+		void nearest(const double* query, size_t k, std::vector<size_t>& indices, size_t exclude = npos) const;
+		void nearest(const std::vector<double>& query, size_t k, std::vector<size_t>& indices,
+		             size_t exclude = npos) const
+		{
+			nearest(query.data(), k, indices, exclude);
+		}
+
+		// whether some point lies closer than radius to query; stops at the
+		// first one found
+		bool any_within(const double* query, double radius, size_t exclude = npos) const;
+		// indices of every point closer than radius to query, in tree order
+		void within(const double* query, double radius, std::vector<size_t>& indices) const;
+
+	private:
+		using heap_entry = struct heap_entry_t
+		{
+			double distance;
+			size_t index;
+		};
+
+		void build_nodes();
+		void build(size_t lo, size_t hi);
+		void search(size_t lo, size_t hi, const double* query, size_t k, size_t exclude,
+		            std::vector<heap_entry>& heap) const;
+		bool any_within(size_t lo, size_t hi, const double* query, double squared_radius, size_t exclude) const;
+		void within(size_t lo, size_t hi, const double* query, double squared_radius,
+		            std::vector<size_t>& indices) const;
+		double squared_distance(size_t point, const double* query) const;
+		const double* point(const size_t i) const { return &coordinates_[i * dims_]; }
+
+		size_t dims_ = 0;
+		// row-major coordinates, indexed by original point index
+		std::vector<double> coordinates_;
+		// tree order of the point indices and the split axis of each node
+		std::vector<size_t> order_;
+		std::vector<std::uint32_t> axis_;
+	};
+}
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef CLEVER_MIGRATION_H
+#define CLEVER_MIGRATION_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "clever/random.h"
+#include "clever/spsc_queue.h"
+
+
+namespace clever
+{
+	enum class migration_topology
+	{
+		// island i sends to island i + 1, the last one to the first
+		ring,
+		// every island sends to every other island
+		fully_connected,
+		// every migration goes to one other island picked at random
+		random
+	};
+
+
+	// Destinations of the migrants island sends in one migration.
+	void migration_targets(std::vector<size_t>& targets, migration_topology topology, size_t island,
+	                       size_t num_islands, random_engine& rng = default_engine());
+
+
+	// Channels between the islands of a parallel model. Every directed pair
+	// the topology can use has its own single-producer single-consumer queue,
+	// so islands exchange migrants without locks and never wait for each
+	// other: a migrant sent to a full queue is dropped. send and receive are
+	// the only points of contact between islands, which keeps the door open
+	// to other transports such as sockets between processes.
+	template <typename T>
+	class migration_network
+	{
+	public:
+		migration_network(const size_t num_islands, const migration_topology topology, const size_t capacity)
+			: num_islands_(num_islands), topology_(topology), queues_(num_islands * num_islands)
+		{
+			std::vector<size_t> targets;
+			random_engine rng(0);
+			for (size_t from = 0; from < num_islands; ++from)
+			{
+				if (topology == migration_topology::ring)
+				{
+					migration_targets(targets, topology, from, num_islands, rng);
+				}
+				else
+				{
+					targets.clear();
+					for (size_t to = 0; to < num_islands; ++to)
+					{
+						if (to != from)
+						{
+							targets.push_back(to);
+						}
+					}
+				}
+				for (const auto to : targets)
+				{
+					queues_[from * num_islands + to].reset(new spsc_queue<T>(capacity));
+				}
+			}
+		}
+
+		size_t size() const { return num_islands_; }
+		migration_topology topology() const { return topology_; }
+
+		void targets(std::vector<size_t>& targets, const size_t island, random_engine& rng) const
+		{
+			migration_targets(targets, topology_, island, num_islands_, rng);
+		}
+
+		// called only by island from; false when the migrant was dropped
+		bool send(const size_t from, const size_t to, const T& migrant)
+		{
+			auto& queue = queues_[from * num_islands_ + to];
+			return queue && queue->try_push(migrant);
+		}
+
+		// called only by island to; appends every migrant waiting for it
+		void receive(const size_t to, std::vector<T>& migrants)
+		{
+			T migrant;
+			for (size_t from = 0; from < num_islands_; ++from)
+			{
+				auto& queue = queues_[from * num_islands_ + to];
+				while (queue && queue->try_pop(migrant))
+				{
+					migrants.push_back(migrant);
+				}
+			}
+		}
+
+	private:
+		size_t num_islands_;
+		migration_topology topology_;
+		// queues_[from * num_islands + to], empty for unused pairs
+		std::vector<std::unique_ptr<spsc_queue<T>>> queues_;
+	};
+}
+
+#endif
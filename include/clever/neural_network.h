@@ -0,0 +1,74 @@
+#ifndef CLEVER_NEURAL_NETWORK_H
+#define CLEVER_NEURAL_NETWORK_H
+
+#include <cstddef>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "clever/random.h"
+#include "clever/thread_pool.h"
+
+
+namespace clever
+{
+	// Error derivatives of every layer, shaped like the network's weights.
+	using network_gradient = struct network_gradient_t
+	{
+		std::vector<Eigen::MatrixXd> weights;
+		std::vector<Eigen::VectorXd> biases;
+	};
+
+
+	// Fully connected feed-forward network of sigmoid units trained with
+	// back-propagation. Layer l is a weight matrix of outputs x inputs and
+	// a bias vector, and a batch is a matrix with one sample per column, so
+	// a pass over the batch is one matrix product per layer.
+	class neural_network
+	{
+	public:
+		neural_network() = default;
+
+		// sizes lists the width of every layer, inputs first and outputs
+		// last; weights are uniform in +-1/sqrt(fan-in)
+		explicit neural_network(const std::vector<size_t>& sizes, random_engine& rng = default_engine());
+
+		size_t inputs() const { return weights_.empty() ? 0 : weights_.front().cols(); }
+		size_t outputs() const { return weights_.empty() ? 0 : weights_.back().rows(); }
+		// weight layers, one less than the widths given
+		size_t layers() const { return weights_.size(); }
+
+		Eigen::MatrixXd& weights(const size_t layer) { return weights_[layer]; }
+		const Eigen::MatrixXd& weights(const size_t layer) const { return weights_[layer]; }
+		Eigen::VectorXd& bias(const size_t layer) { return biases_[layer]; }
+		const Eigen::VectorXd& bias(const size_t layer) const { return biases_[layer]; }
+
+		// outputs x columns of input
+		void forward(const Eigen::Ref<const Eigen::MatrixXd>& input, Eigen::MatrixXd& output) const;
+
+		// Derivatives of the squared error over the columns of input against
+		// target, summed over the batch and signed so that adding them
+		// lowers the error. Returns the squared error.
+		double gradient(const Eigen::Ref<const Eigen::MatrixXd>& input,
+		                const Eigen::Ref<const Eigen::MatrixXd>& target, network_gradient& grad) const;
+
+		// One pass over the columns of inputs in mini-batches of batch_size,
+		// each followed by a step of learning_rate times the mean gradient
+		// plus momentum times the previous step. A batch is split into
+		// fixed runs of columns whose gradients are computed on the pool
+		// and summed in order, so training does not depend on the number
+		// of threads. Returns the mean squared error seen over the epoch.
+		double train_epoch(const Eigen::MatrixXd& inputs, const Eigen::MatrixXd& targets, size_t batch_size,
+		                   double learning_rate, double momentum = 0.8, thread_pool& pool = default_pool());
+
+	private:
+		void zero_like(network_gradient& grad) const;
+
+		std::vector<Eigen::MatrixXd> weights_;
+		std::vector<Eigen::VectorXd> biases_;
+		// the previous step, for momentum
+		network_gradient last_step_;
+	};
+}
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef CLEVER_PERCEPTRON_H
+#define CLEVER_PERCEPTRON_H
+
+#include <cstddef>
+#include <vector>
+
+#include "clever/dataset.h"
+#include "clever/random.h"
+#include "clever/thread_pool.h"
+
+
+namespace clever
+{
+	// Single-layer perceptron with a step transfer. A row of a dataset
+	// holds inputs() values followed by the expected output, 0 or 1, and is
+	// read in place; activations are SIMD dot products.
+	class perceptron
+	{
+	public:
+		perceptron() = default;
+		// weights uniform in [-1, 1), the bias last
+		explicit perceptron(size_t num_inputs, random_engine& rng = default_engine());
+
+		size_t inputs() const { return weights_.empty() ? 0 : weights_.size() - 1; }
+		const std::vector<double>& weights() const { return weights_; }
+
+		double activate(const double* input) const;
+		double output(const double* input) const { return activate(input) >= 0.0 ? 1.0 : 0.0; }
+
+		// One pass over the rows of data; returns how many were
+		// misclassified. batch_size 1 is the classic rule, an update after
+		// every row. Larger batches classify their rows with the weights
+		// they start with, spread over the pool in fixed runs, and apply
+		// the summed update once, so the result does not depend on the
+		// number of threads.
+		size_t train_epoch(const dataset_view& data, double l_rate, size_t batch_size = 1,
+		                   thread_pool& pool = default_pool());
+
+		// The averaged perceptron: the mean of the weights after every
+		// update step since construction, which generalizes better than the
+		// last weights when the data is not separable.
+		void averaged(std::vector<double>& weights) const;
+		// takes the averaged weights as the weights
+		void use_averaged();
+
+		// outputs[i] = output(row i), spread over the pool
+		void classify(const dataset_view& data, std::vector<double>& outputs, thread_pool& pool = default_pool()) const;
+		// rows whose output equals the expected one
+		size_t test(const dataset_view& data, thread_pool& pool = default_pool()) const;
+
+	private:
+		// adds scale * (row inputs, 1) to weights
+		void add_row(const double* row, double scale, std::vector<double>& weights) const;
+
+		std::vector<double> weights_;
+		// the average is weights_ - weighted_ / steps_, where weighted_ sums
+		// every step scaled by its number
+		std::vector<double> weighted_;
+		double steps_ = 1.0;
+	};
+}
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef CLEVER_PHEROMONE_H
+#define CLEVER_PHEROMONE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "clever/aligned_allocator.h"
+
+
+namespace clever
+{
+	enum class pheromone_layout
+	{
+		// n x n matrix, each row padded to a whole number of cache lines
+		full,
+		// lower triangle only, about half the memory of full
+		triangular
+	};
+
+
+	// Pheromone trails of a symmetric TSP in one flat, cache-aligned buffer.
+	// Updates are per undirected edge: with the full layout both (i, j) and
+	// (j, i) are written, so reads stay a single load either way.
+	// Instantiated for float and double.
+	template <typename T>
+	class basic_pheromone_matrix
+	{
+	public:
+		using value_type = T;
+
+		basic_pheromone_matrix() = default;
+		basic_pheromone_matrix(size_t size, T initial, pheromone_layout layout = pheromone_layout::full);
+
+		void reset(size_t size, T initial, pheromone_layout layout = pheromone_layout::full);
+
+		size_t size() const { return size_; }
+		pheromone_layout layout() const { return layout_; }
+
+		T operator()(const size_t i, const size_t j) const { return values_[index(i, j)]; }
+
+		// contiguous trails from city i, only available with the full layout
+		const T* row(const size_t i) const { return &values_[i * stride_]; }
+
+		void fill(T value);
+
+		// every trail *= 1 - rate
+		void evaporate(double rate);
+
+		// trail(i, j) += amount
+		void deposit(size_t i, size_t j, double amount)
+		{
+			update(i, j, 1.0, amount);
+		}
+
+		// trail(i, j) = keep * trail(i, j) + add
+		void update(const size_t i, const size_t j, const double keep, const double add)
+		{
+			auto& v = values_[index(i, j)];
+			v = static_cast<T>(keep * v + add);
+			if (layout_ == pheromone_layout::full)
+			{
+				values_[index(j, i)] = v;
+			}
+		}
+
+		// applies deposit / update to every edge of a closed tour
+		void deposit(const std::vector<size_t>& tour, double amount);
+		void update(const std::vector<size_t>& tour, double keep, double add);
+
+		// Thread-safe variants for ants that update trails while others are
+		// still reading them. update_atomic blends only the edge's canonical
+		// cell (min(i, j), max(i, j)) with a compare-and-swap loop and load
+		// reads that cell; with the full layout sync_mirror has to copy the
+		// canonical cells over their mirrors once the parallel section is
+		// over, before operator() or the plain updates are used again.
+		T load(size_t i, size_t j) const;
+		void update_atomic(size_t i, size_t j, double keep, double add);
+		void update_atomic(const std::vector<size_t>& tour, double keep, double add);
+		void sync_mirror();
+
+	private:
+		size_t index(const size_t i, const size_t j) const
+		{
+			if (layout_ == pheromone_layout::full)
+			{
+				return i * stride_ + j;
+			}
+			const auto hi = std::max(i, j);
+			return hi * (hi + 1) / 2 + std::min(i, j);
+		}
+
+		size_t size_ = 0;
+		size_t stride_ = 0;
+		pheromone_layout layout_ = pheromone_layout::full;
+		aligned_vector<T> values_;
+	};
+
+
+	using pheromone_matrix = basic_pheromone_matrix<double>;
+	using pheromone_matrix_float = basic_pheromone_matrix<float>;
+}
+
+#endif
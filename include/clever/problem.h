@@ -0,0 +1,54 @@
+#ifndef CLEVER_PROBLEM_H
+#define CLEVER_PROBLEM_H
+
+#include <cfloat>
+#include <cstddef>
+#include <vector>
+
+#include "clever/candidate_batch.h"
+#include "clever/random.h"
+
+
+namespace clever
+{
+	// One {min, max} pair per dimension, as used by every real-valued recipe.
+	using search_bounds = std::vector<std::vector<double>>;
+
+
+	using real_solution = struct real_solution_t
+	{
+		std::vector<double> vector;
+		double cost = DBL_MAX;
+	};
+
+
+	using permutation_solution = struct permutation_solution_t
+	{
+		std::vector<size_t> vector;
+		double cost = DBL_MAX;
+	};
+
+
+	void make_bounds(search_bounds& bounds, size_t problem_size, double min, double max);
+
+	double rand_in_bounds(double min, double max, random_engine& rng = default_engine());
+
+	void random_vector(std::vector<double>& vector, const search_bounds& minmax,
+	                   random_engine& rng = default_engine());
+
+	double euclidean_distance(const std::vector<double>& x, const std::vector<double>& y);
+
+	// clamps every component of vector into its {min, max} pair
+	void clamp_to_bounds(std::vector<double>& vector, const search_bounds& minmax);
+
+	// The same for every candidate of a batch, one dimension at a time so
+	// that each pass is a contiguous sweep. random_batch keeps the batch's
+	// size and draws one dimension row after the other.
+	void random_batch(candidate_batch& batch, const search_bounds& minmax, random_engine& rng = default_engine());
+	void clamp_to_bounds(candidate_batch& batch, const search_bounds& minmax);
+
+	// indices of costs from the lowest cost up, ties in index order
+	void order_by_cost(std::vector<size_t>& order, const std::vector<double>& costs);
+}
+
+#endif
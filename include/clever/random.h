@@ -0,0 +1,102 @@
+#ifndef CLEVER_RANDOM_H
+#define CLEVER_RANDOM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+
+namespace clever
+{
+	// Random number source shared by every algorithm: xoshiro256** with
+	// splitmix64 seeding. Engines are cheap to copy and are not shared
+	// between threads; use one stream per worker instead.
+	class random_engine
+	{
+	public:
+		using result_type = std::uint64_t;
+
+		// seeded from std::random_device
+		random_engine();
+		explicit random_engine(std::uint64_t seed);
+		// independent stream number `stream` of the sequence family `seed`,
+		// derived by hashing so that any stream can be built directly
+		random_engine(std::uint64_t seed, std::uint64_t stream);
+
+		void seed(std::uint64_t seed);
+
+		// advances the engine by 2^128 draws; successive jumps give
+		// non-overlapping subsequences
+		void jump();
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+		result_type operator()() { return next(); }
+
+		// uniform draw from [0, 1)
+		double uniform() { return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0); }
+		// uniform draw from [min, max)
+		double uniform(const double min, const double max) { return min + (max - min) * uniform(); }
+		// uniform index from [0, n)
+		size_t index(size_t n);
+		// normally distributed draw (Marsaglia polar method)
+		double gaussian(double mean = 0.0, double stdev = 1.0);
+
+		// bulk draws, for loops that need a value per gene or dimension
+		void fill_uniform(double* values, size_t n);
+		void fill_uniform(double* values, size_t n, double min, double max);
+		void fill_gaussian(double* values, size_t n, double mean = 0.0, double stdev = 1.0);
+		void fill_uniform(std::vector<double>& values) { fill_uniform(values.data(), values.size()); }
+		void fill_gaussian(std::vector<double>& values, const double mean = 0.0, const double stdev = 1.0)
+		{
+			fill_gaussian(values.data(), values.size(), mean, stdev);
+		}
+
+	private:
+		static std::uint64_t rotl(const std::uint64_t x, const int k) { return (x << k) | (x >> (64 - k)); }
+
+		std::uint64_t next()
+		{
+			const auto result = rotl(state_[1] * 5, 7) * 9;
+			const auto t = state_[1] << 17;
+			state_[2] ^= state_[0];
+			state_[3] ^= state_[1];
+			state_[1] ^= state_[2];
+			state_[0] ^= state_[3];
+			state_[2] ^= t;
+			state_[3] = rotl(state_[3], 45);
+			return result;
+		}
+
+		void polar_pair(double& z0, double& z1);
+
+		std::uint64_t state_[4];
+		double spare_ = 0.0;
+		bool has_spare_ = false;
+	};
+
+
+	// count non-overlapping streams of seed, each one jump() apart; meant for
+	// long-lived workers such as islands
+	std::vector<random_engine> make_streams(std::uint64_t seed, size_t count);
+
+
+	// Engine used when an algorithm is not handed one explicitly. Every thread
+	// has its own stream; the family is seeded from CLEVER_SEED when set.
+	// The main thread always draws from stream 0, other threads from streams
+	// numbered in the order they first draw, so work spread over threads
+	// should take a stream of its own, per task or from make_streams,
+	// seeded from the caller's engine.
+	random_engine& default_engine();
+
+	// reseeds the calling thread's default engine
+	void seed_default_engine(std::uint64_t seed);
+
+	double random_uniform(random_engine& rng = default_engine());
+	double random_uniform(double min, double max, random_engine& rng = default_engine());
+	size_t random_index(size_t n, random_engine& rng = default_engine());
+	double random_gaussian(double mean = 0.0, double stdev = 1.0, random_engine& rng = default_engine());
+}
+
+#endif
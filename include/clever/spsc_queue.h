@@ -0,0 +1,76 @@
+#ifndef CLEVER_SPSC_QUEUE_H
+#define CLEVER_SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "clever/aligned_allocator.h"
+
+
+namespace clever
+{
+	// Bounded lock-free queue for exactly one producer thread and one
+	// consumer thread. The capacity is rounded up to a power of two.
+	template <typename T>
+	class spsc_queue
+	{
+	public:
+		explicit spsc_queue(const size_t capacity)
+		{
+			size_t size = 1;
+			while (size < capacity)
+			{
+				size *= 2;
+			}
+			slots_.resize(size);
+			mask_ = size - 1;
+			head_.store(0, std::memory_order_relaxed);
+			tail_.store(0, std::memory_order_relaxed);
+		}
+
+		spsc_queue(const spsc_queue&) = delete;
+		spsc_queue& operator=(const spsc_queue&) = delete;
+
+		size_t capacity() const { return slots_.size(); }
+
+		// producer side; false when the queue is full
+		bool try_push(const T& value)
+		{
+			const auto tail = tail_.load(std::memory_order_relaxed);
+			if (tail - head_.load(std::memory_order_acquire) == slots_.size())
+			{
+				return false;
+			}
+			slots_[tail & mask_] = value;
+			tail_.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		// consumer side; false when the queue is empty
+		bool try_pop(T& value)
+		{
+			const auto head = head_.load(std::memory_order_relaxed);
+			if (head == tail_.load(std::memory_order_acquire))
+			{
+				return false;
+			}
+			value = slots_[head & mask_];
+			head_.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+	private:
+		std::vector<T> slots_;
+		size_t mask_ = 0;
+		// head and tail on separate cache lines so that the two threads do
+		// not invalidate each other's line on every operation
+		char pad0_[cache_line_size];
+		std::atomic<size_t> head_;
+		char pad1_[cache_line_size - sizeof(std::atomic<size_t>)];
+		std::atomic<size_t> tail_;
+		char pad2_[cache_line_size - sizeof(std::atomic<size_t>)];
+	};
+}
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef CLEVER_SWARM_H
+#define CLEVER_SWARM_H
+
+#include <cstddef>
+#include <vector>
+
+#include "clever/aligned_allocator.h"
+#include "clever/candidate_batch.h"
+#include "clever/problem.h"
+#include "clever/random.h"
+
+
+namespace clever
+{
+	// A particle swarm stored structure-of-arrays, see candidate_batch.
+	using swarm_state = struct swarm_state_t
+	{
+		candidate_batch position;
+		candidate_batch velocity;
+		// each particle's best position so far, and its cost
+		candidate_batch b_position;
+		std::vector<double> cost;
+		std::vector<double> b_cost;
+		// 1 for the particles whose last evaluation beat their best, as
+		// doubles so the kernels can blend with them; move_swarm takes over
+		// their positions into b_position before moving them
+		aligned_vector<double> improved;
+		// uniform draws of one move, a stride-long row per dimension
+		aligned_vector<double> r1, r2;
+		// the search space, one value per dimension
+		std::vector<double> lower, upper;
+	};
+
+	// Random positions and velocities; b_cost starts at DBL_MAX.
+	void create_swarm(swarm_state& swarm, size_t size, const search_bounds& search_space,
+	                  const search_bounds& velocity_space, random_engine& rng = default_engine());
+
+	// To be called once swarm.cost holds the costs of the current positions:
+	// lowers b_cost, marks the improved particles and returns the index of the
+	// lowest cost, all in one pass.
+	size_t update_personal_best(swarm_state& swarm);
+
+	// One generation's move in a single fused sweep per dimension: pending
+	// personal bests, velocity
+	//   v += c1 * r1 * (b_position - position) + c2 * r2 * (g_best - position)
+	// clamped to +-max_velocity, then position += v with particles that
+	// leave the search space reflected back and their velocity reversed.
+	// r1 and r2 are drawn in bulk beforehand, uses the active simd_level.
+	void move_swarm(swarm_state& swarm, const std::vector<double>& g_best, double max_velocity,
+	                double c1, double c2, random_engine& rng = default_engine());
+
+	// Applies the pending personal bests now, for reading b_position
+	// between update_personal_best and the next move_swarm.
+	void commit_personal_best(swarm_state& swarm);
+}
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef CLEVER_TERNARY_H
+#define CLEVER_TERNARY_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "clever/bit_string.h"
+
+
+namespace clever
+{
+	// Condition over {0, 1, #} as two bit strings: care has a bit for every
+	// position that is not '#', value the bit those positions require.
+	// Value bits are zero wherever care is, so equal conditions compare equal.
+	using ternary_condition = struct ternary_condition_t
+	{
+		bit_string care;
+		bit_string value;
+
+		size_t size() const { return care.size(); }
+
+		bool operator==(const ternary_condition_t& other) const
+		{
+			return care == other.care && value == other.value;
+		}
+		bool operator!=(const ternary_condition_t& other) const { return !(*this == other); }
+	};
+
+	// from '0', '1' and '#' characters, position 0 first
+	void make_condition(ternary_condition& condition, const std::string& text);
+	std::string to_string(const ternary_condition& condition);
+
+	// position i of the condition, '0', '1' or '#'
+	char symbol(const ternary_condition& condition, size_t i);
+	void set_symbol(ternary_condition& condition, size_t i, char symbol);
+
+	// care & (input ^ value) == 0, a word at a time
+	bool matches(const ternary_condition& condition, const bit_string& input);
+
+	// every input condition matches is also matched by general
+	bool subsumes(const ternary_condition& general, const ternary_condition& specific);
+
+
+	// Conditions of a population stored bit-sliced for match-set formation:
+	// column (i, v) has bit k set when the condition in slot k accepts value
+	// v at position i. The slots matching an input are the AND of one column
+	// per position, size() / 64 words each, instead of a pass over every
+	// condition.
+	class match_index
+	{
+	public:
+		match_index() = default;
+		explicit match_index(size_t length);
+
+		size_t length() const { return length_; }
+		// one past the highest slot ever used
+		size_t size() const { return used_.size(); }
+
+		// puts condition in slot, replacing whatever was there
+		void insert(size_t slot, const ternary_condition& condition);
+		void erase(size_t slot);
+
+		// the slots whose condition matches input, ascending
+		void match(const bit_string& input, std::vector<size_t>& slots) const;
+
+	private:
+		size_t length_ = 0;
+		std::vector<bit_string> columns_;
+		bit_string used_;
+	};
+}
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef CLEVER_TEST_FUNCTIONS_H
+#define CLEVER_TEST_FUNCTIONS_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "clever/batch_functions.h"
+#include "clever/evaluator.h"
+#include "clever/problem.h"
+
+
+namespace clever
+{
+	// Standard test functions, all minimised. Their usual domains and global
+	// minima are listed by benchmark_suite below.
+
+	// any dimension
+	double sphere_function(const std::vector<double>& x);
+	double ackley_function(const std::vector<double>& x);
+	double rastrigin_function(const std::vector<double>& x);
+	double rosenbrock_function(const std::vector<double>& x);
+	double griewank_function(const std::vector<double>& x);
+	double schwefel_function(const std::vector<double>& x);
+	double sum_of_different_powers_function(const std::vector<double>& x);
+	double sum_squares_function(const std::vector<double>& x);
+	double rotated_hyper_ellipsoid_function(const std::vector<double>& x);
+	double dixon_price_function(const std::vector<double>& x);
+	double levy_function(const std::vector<double>& x);
+
+	// two dimensions
+	double beale_function(const std::vector<double>& x);
+	double booth_function(const std::vector<double>& x);
+	double branin_function(const std::vector<double>& x);
+	// Bukin function N. 6
+	double bukin_function(const std::vector<double>& x);
+	double holder_table_function(const std::vector<double>& x);
+	double cross_in_tray_function(const std::vector<double>& x);
+	double matyas_function(const std::vector<double>& x);
+	double easom_function(const std::vector<double>& x);
+	double drop_wave_function(const std::vector<double>& x);
+	double eggholder_function(const std::vector<double>& x);
+	double six_hump_camel_function(const std::vector<double>& x);
+	double three_hump_camel_function(const std::vector<double>& x);
+
+
+	using benchmark_function = struct benchmark_function_t
+	{
+		std::string name;
+		objective_function function;
+		// SIMD version from batch_functions.h, empty when there is none
+		batch_objective_function batch;
+		search_bounds bounds;
+		// value of the global minimum
+		double optimum = 0.0;
+	};
+
+	// Every function above with its usual domain. The functions of any
+	// dimension get the given number of dimensions, the others two.
+	void benchmark_suite(std::vector<benchmark_function>& suite, size_t dimensions);
+}
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef CLEVER_THREAD_POOL_H
+#define CLEVER_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace clever
+{
+	// Fixed set of worker threads that run data-parallel loops. The calling
+	// thread takes part in every loop, so a pool of size 1 runs inline.
+	class thread_pool
+	{
+	public:
+		// num_threads == 0 uses the hardware concurrency
+		explicit thread_pool(size_t num_threads = 0);
+		~thread_pool();
+
+		thread_pool(const thread_pool&) = delete;
+		thread_pool& operator=(const thread_pool&) = delete;
+
+		// number of threads a loop is spread over, including the caller
+		size_t size() const;
+
+		// Calls body(i) for every i in [0, count) and blocks until all calls
+		// returned. Indices are handed out in runs of grain. The first
+		// exception thrown by body is rethrown here. Calls made from inside a
+		// running loop execute inline.
+		void parallel_for(size_t count, const std::function<void(size_t)>& body, size_t grain = 1);
+
+	private:
+		void worker_loop();
+		void run_chunks();
+
+		std::vector<std::thread> workers_;
+		std::mutex loop_mutex_;
+
+		std::mutex mutex_;
+		std::condition_variable wake_;
+		std::condition_variable done_;
+		const std::function<void(size_t)>* body_ = nullptr;
+		size_t count_ = 0;
+		size_t grain_ = 1;
+		std::atomic<size_t> next_;
+		size_t active_ = 0;
+		size_t generation_ = 0;
+		bool stop_ = false;
+		std::exception_ptr error_;
+	};
+
+
+	// Pool shared by the algorithms. Its size is taken from the
+	// CLEVER_NUM_THREADS environment variable when set.
+	thread_pool& default_pool();
+}
+
+#endif
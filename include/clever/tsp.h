@@ -0,0 +1,83 @@
+#ifndef CLEVER_TSP_H
+#define CLEVER_TSP_H
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "clever/problem.h"
+#include "clever/random.h"
+
+
+namespace clever
+{
+	class distance_provider;
+
+
+	// One coordinate row per city.
+	using city_list = std::vector<std::vector<double>>;
+
+
+	// The 52 locations in Berlin (TSPLIB berlin52), optimal tour length 7542.
+	const city_list& berlin52();
+
+	// Reads the NODE_COORD_SECTION of a TSPLIB instance. Returns false when
+	// the input has no coordinates (e.g. EXPLICIT edge weights) or is
+	// malformed. Distances are then taken as unrounded Euclidean, whatever
+	// the instance's EDGE_WEIGHT_TYPE.
+	bool read_tsplib(std::istream& in, city_list& cities);
+	bool load_tsplib(const std::string& path, city_list& cities);
+
+	double euc_2d(const std::vector<double>& c1, const std::vector<double>& c2);
+
+	// length of the closed tour visiting cities in permutation order
+	double tour_cost(const std::vector<size_t>& permutation, const city_list& cities);
+	double tour_cost(const std::vector<size_t>& permutation, const distance_provider& distance);
+
+	void random_permutation(std::vector<size_t>& permutation, size_t size,
+	                        random_engine& rng = default_engine());
+
+	// Reverses a random segment [c1, c2) of the tour in place. The two edges
+	// broken by the move are (c1 - 1, c1) and (c2 - 1, c2), positions taken
+	// modulo the tour size, which tabu-style recipes need to remember.
+	void stochastic_two_opt(std::vector<size_t>& permutation, size_t& c1, size_t& c2,
+	                        random_engine& rng = default_engine());
+
+	void stochastic_two_opt(std::vector<size_t>& permutation, random_engine& rng = default_engine());
+
+
+	// 2-opt move reversing the tour segment [c1, c2), c1 < c2. It deletes the
+	// edges (a, b) and (c, d) and adds (a, c) and (b, d), where a = p[c1 - 1],
+	// b = p[c1], c = p[c2 - 1] and d = p[c2], positions modulo the tour size.
+	using two_opt_move = struct two_opt_move_t
+	{
+		size_t c1 = 0;
+		size_t c2 = 0;
+	};
+
+
+	// draws c1 and c2 the way stochastic_two_opt does, without touching a tour
+	two_opt_move random_two_opt_move(size_t size, random_engine& rng = default_engine());
+
+	void two_opt_cities(const std::vector<size_t>& permutation, const two_opt_move& move,
+	                    size_t& a, size_t& b, size_t& c, size_t& d);
+
+	// change in tour length the move would cause, from the four edges it
+	// touches
+	double two_opt_delta(const std::vector<size_t>& permutation, const two_opt_move& move, const city_list& cities);
+	double two_opt_delta(const std::vector<size_t>& permutation, const two_opt_move& move,
+	                     const distance_provider& distance);
+
+	// Commits the move. The shorter of the segment and its complement is
+	// reversed; both give the same cycle. Applying a move twice undoes it.
+	void apply_two_opt(std::vector<size_t>& permutation, const two_opt_move& move);
+
+	// Stochastic 2-opt hill climbing: tries random moves until max_no_improv
+	// in a row fail to shorten the tour. Each try costs O(1); only improving
+	// moves are applied. Returns the number of moves tried.
+	size_t two_opt_local_search(permutation_solution& solution, const city_list& cities, size_t max_no_improv,
+	                            random_engine& rng = default_engine());
+}
+
+#endif
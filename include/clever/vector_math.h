@@ -0,0 +1,25 @@
+#ifndef CLEVER_VECTOR_MATH_H
+#define CLEVER_VECTOR_MATH_H
+
+#include <cstddef>
+
+
+namespace clever
+{
+	// Kernels over contiguous arrays of any alignment, run with the
+	// instruction set of active_simd_level(). Sums are taken in a different
+	// order than a plain loop, so results can differ from one in the last
+	// bits.
+
+	// sum of a[i] * b[i] for i < n
+	double dot(const double* a, const double* b, size_t n);
+
+	// y[i] += alpha * x[i] for i < n
+	void axpy(double alpha, const double* x, double* y, size_t n);
+
+	// out[i] = x[0] + ... + x[i] for i < n, in place when out is x; returns
+	// the total
+	double prefix_sums(const double* x, size_t n, double* out);
+}
+
+#endif
@@ -1,4 +1,31 @@
 #ifndef CLEVER_ALGORITHM_H
 #define CLEVER_ALGORITHM_H
 
+#include "clever/random.h"
+#include "clever/bit_string.h"
+#include "clever/fitness_cache.h"
+#include "clever/ternary.h"
+#include "clever/neural_network.h"
+#include "clever/vector_math.h"
+#include "clever/dataset.h"
+#include "clever/perceptron.h"
+#include "clever/discrete_sampling.h"
+#include "clever/bayesian_network.h"
+#include "clever/thread_pool.h"
+#include "clever/problem.h"
+#include "clever/candidate_batch.h"
+#include "clever/batch_functions.h"
+#include "clever/swarm.h"
+#include "clever/evaluator.h"
+#include "clever/evaluation_queue.h"
+#include "clever/test_functions.h"
+#include "clever/tsp.h"
+#include "clever/kd_tree.h"
+#include "clever/distance.h"
+#include "clever/aligned_allocator.h"
+#include "clever/pheromone.h"
+#include "clever/spsc_queue.h"
+#include "clever/migration.h"
+#include "clever/benchmark.h"
+
 #endif
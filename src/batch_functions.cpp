@@ -0,0 +1,252 @@
+#include "clever/batch_functions.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include "batch_kernels.h"
+
+
+namespace clever
+{
+	namespace batch
+	{
+		namespace
+		{
+			// one candidate at a time with the standard library's maths, the
+			// same operations as test_functions.cpp
+			using pack = struct pack_t
+			{
+				static const size_t width = 1;
+
+				double v;
+
+				static pack_t load(const double* p) { return {*p}; }
+				static pack_t loadu(const double* p) { return {*p}; }
+				static pack_t broadcast(const double x) { return {x}; }
+			};
+
+			pack operator+(const pack a, const pack b) { return {a.v + b.v}; }
+			pack operator-(const pack a, const pack b) { return {a.v - b.v}; }
+			pack operator*(const pack a, const pack b) { return {a.v * b.v}; }
+			pack operator/(const pack a, const pack b) { return {a.v / b.v}; }
+
+			void store(double* p, const pack a) { *p = a.v; }
+			pack fmadd(const pack a, const pack b, const pack c) { return {a.v * b.v + c.v}; }
+			pack sqrt_(const pack a) { return {std::sqrt(a.v)}; }
+			pack abs_(const pack a) { return {std::fabs(a.v)}; }
+			pack min_(const pack a, const pack b) { return {std::min(a.v, b.v)}; }
+			pack max_(const pack a, const pack b) { return {std::max(a.v, b.v)}; }
+			pack less_(const pack a, const pack b) { return {a.v < b.v ? 1.0 : 0.0}; }
+			pack select_(const pack flag, const pack a, const pack b) { return {flag.v != 0.0 ? a.v : b.v}; }
+			double sum_(const pack a) { return a.v; }
+			pack scan_(const pack a) { return a; }
+			pack exp_(const pack a) { return {std::exp(a.v)}; }
+			pack sin_(const pack a) { return {std::sin(a.v)}; }
+			pack cos_(const pack a) { return {std::cos(a.v)}; }
+		}
+
+
+		void move_swarm_scalar(const swarm_arguments& a)
+		{
+			move_swarm<pack>(a);
+		}
+
+
+		double dot_scalar(const double* a, const double* b, const size_t n)
+		{
+			return dot<pack>(a, b, n);
+		}
+
+
+		void axpy_scalar(const double alpha, const double* x, double* y, const size_t n)
+		{
+			axpy<pack>(alpha, x, y, n);
+		}
+
+
+		double prefix_sums_scalar(const double* x, const size_t n, double* out)
+		{
+			return prefix_sums<pack>(x, n, out);
+		}
+
+
+		void squared_distances_scalar(const double* values, const size_t count, const size_t dimensions,
+		                              const size_t stride, const double* query, double* out)
+		{
+			squared_distances<pack>(values, count, dimensions, stride, query, out);
+		}
+	}
+
+
+	namespace
+	{
+		simd_level detect_simd_level()
+		{
+#ifdef CLEVER_BATCH_X86
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx512f"))
+			{
+				return simd_level::avx512;
+			}
+			if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+			{
+				return simd_level::avx2;
+			}
+#endif
+			return simd_level::scalar;
+		}
+
+
+		std::atomic<simd_level>& selected_level()
+		{
+			static std::atomic<simd_level> level([]()
+			{
+				auto level = supported_simd_level();
+				const char* value = std::getenv("CLEVER_SIMD");
+				if (value != nullptr && std::strcmp(value, "scalar") == 0)
+				{
+					level = simd_level::scalar;
+				}
+				else if (value != nullptr && std::strcmp(value, "avx2") == 0 && level == simd_level::avx512)
+				{
+					level = simd_level::avx2;
+				}
+				return level;
+			}());
+			return level;
+		}
+
+
+		// count rounded up to whole registers of width; never past the
+		// stride, which is a multiple of candidate_batch::lanes and so of
+		// every width
+		size_t padded(const size_t count, const size_t width)
+		{
+			return (count + width - 1) / width * width;
+		}
+
+
+		void run_kernel(const batch::kernel k, const candidate_batch& batch, std::vector<double>& costs)
+		{
+			// The kernels write whole registers, padding included. The stride
+			// is only the row pitch: a batch grown by push_back can have up to
+			// as much spare capacity again, which is not evaluated.
+			costs.resize(padded(batch.size(), candidate_batch::lanes));
+			const double* values = batch.dimensions() == 0 ? nullptr : batch.dimension(0);
+			switch (active_simd_level())
+			{
+#ifdef CLEVER_BATCH_X86
+			case simd_level::avx512:
+				batch::run_avx512(k, values, padded(batch.size(), 8), batch.dimensions(), batch.stride(), costs.data());
+				break;
+			case simd_level::avx2:
+				batch::run_avx2(k, values, padded(batch.size(), 4), batch.dimensions(), batch.stride(), costs.data());
+				break;
+#endif
+			default:
+				batch::run<batch::pack>(k, values, batch.size(), batch.dimensions(), batch.stride(), costs.data());
+				break;
+			}
+			costs.resize(batch.size());
+		}
+	}
+
+
+	void squared_distances(const candidate_batch& batch, const double* query, std::vector<double>& out)
+	{
+		// whole registers, but not the spare capacity, see run_kernel
+		out.resize(padded(batch.size(), candidate_batch::lanes));
+		const double* values = batch.dimensions() == 0 ? nullptr : batch.dimension(0);
+		switch (active_simd_level())
+		{
+#ifdef CLEVER_BATCH_X86
+		case simd_level::avx512:
+			batch::squared_distances_avx512(values, padded(batch.size(), 8), batch.dimensions(), batch.stride(),
+			                                query, out.data());
+			break;
+		case simd_level::avx2:
+			batch::squared_distances_avx2(values, padded(batch.size(), 4), batch.dimensions(), batch.stride(),
+			                              query, out.data());
+			break;
+#endif
+		default:
+			batch::squared_distances_scalar(values, batch.size(), batch.dimensions(), batch.stride(), query,
+			                                out.data());
+			break;
+		}
+		out.resize(batch.size());
+	}
+
+
+	simd_level supported_simd_level()
+	{
+		static const simd_level level = detect_simd_level();
+		return level;
+	}
+
+
+	simd_level active_simd_level()
+	{
+		return selected_level().load(std::memory_order_relaxed);
+	}
+
+
+	simd_level set_simd_level(const simd_level level)
+	{
+		const auto capped = static_cast<int>(level) < static_cast<int>(supported_simd_level())
+			? level : supported_simd_level();
+		selected_level().store(capped, std::memory_order_relaxed);
+		return capped;
+	}
+
+
+	void sphere_batch(const candidate_batch& batch, std::vector<double>& costs)
+	{
+		run_kernel(batch::kernel::sphere, batch, costs);
+	}
+
+
+	void ackley_batch(const candidate_batch& batch, std::vector<double>& costs)
+	{
+		run_kernel(batch::kernel::ackley, batch, costs);
+	}
+
+
+	void rastrigin_batch(const candidate_batch& batch, std::vector<double>& costs)
+	{
+		run_kernel(batch::kernel::rastrigin, batch, costs);
+	}
+
+
+	void rosenbrock_batch(const candidate_batch& batch, std::vector<double>& costs)
+	{
+		run_kernel(batch::kernel::rosenbrock, batch, costs);
+	}
+
+
+	void griewank_batch(const candidate_batch& batch, std::vector<double>& costs)
+	{
+		run_kernel(batch::kernel::griewank, batch, costs);
+	}
+
+
+	void schwefel_batch(const candidate_batch& batch, std::vector<double>& costs)
+	{
+		run_kernel(batch::kernel::schwefel, batch, costs);
+	}
+
+
+	void sum_squares_batch(const candidate_batch& batch, std::vector<double>& costs)
+	{
+		run_kernel(batch::kernel::sum_squares, batch, costs);
+	}
+
+
+	void rotated_hyper_ellipsoid_batch(const candidate_batch& batch, std::vector<double>& costs)
+	{
+		run_kernel(batch::kernel::rotated_hyper_ellipsoid, batch, costs);
+	}
+}
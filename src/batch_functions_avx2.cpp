@@ -0,0 +1,128 @@
+// AVX2 + FMA instantiation of the batch kernels. Only reached after
+// batch_functions.cpp checked that the CPU has both; everything after the
+// pragma is compiled for them, so nothing above it may be inline code that
+// other translation units share.
+
+#include <cstddef>
+
+#if defined(__GNUC__) && !defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+
+#include <immintrin.h>
+
+#pragma GCC target("avx2,fma")
+
+#include "batch_kernels.h"
+
+
+namespace clever
+{
+	namespace batch
+	{
+		namespace
+		{
+			using pack = struct pack_t
+			{
+				static const size_t width = 4;
+
+				__m256d v;
+
+				static pack_t load(const double* p) { return {_mm256_load_pd(p)}; }
+				static pack_t loadu(const double* p) { return {_mm256_loadu_pd(p)}; }
+				static pack_t broadcast(const double x) { return {_mm256_set1_pd(x)}; }
+			};
+
+			pack operator+(const pack a, const pack b) { return {_mm256_add_pd(a.v, b.v)}; }
+			pack operator-(const pack a, const pack b) { return {_mm256_sub_pd(a.v, b.v)}; }
+			pack operator*(const pack a, const pack b) { return {_mm256_mul_pd(a.v, b.v)}; }
+			pack operator/(const pack a, const pack b) { return {_mm256_div_pd(a.v, b.v)}; }
+
+			void store(double* p, const pack a) { _mm256_storeu_pd(p, a.v); }
+			pack fmadd(const pack a, const pack b, const pack c) { return {_mm256_fmadd_pd(a.v, b.v, c.v)}; }
+			pack sqrt_(const pack a) { return {_mm256_sqrt_pd(a.v)}; }
+			pack abs_(const pack a) { return {_mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v)}; }
+			pack min_(const pack a, const pack b) { return {_mm256_min_pd(a.v, b.v)}; }
+			pack max_(const pack a, const pack b) { return {_mm256_max_pd(a.v, b.v)}; }
+			pack round_(const pack a) { return {_mm256_round_pd(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)}; }
+			pack floor_(const pack a) { return {_mm256_floor_pd(a.v)}; }
+
+			// 2^n for integral n in [-1022, 1023]: adding 2^52 + 1023 leaves the
+			// biased exponent in the low mantissa bits, shifting moves it up
+			pack pow2_(const pack n)
+			{
+				const auto biased = _mm256_add_pd(n.v, _mm256_set1_pd(4503599627370496.0 + 1023.0));
+				return {_mm256_castsi256_pd(_mm256_slli_epi64(_mm256_castpd_si256(biased), 52))};
+			}
+
+			// 1 where a < b, else 0
+			pack less_(const pack a, const pack b)
+			{
+				return {_mm256_and_pd(_mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ), _mm256_set1_pd(1.0))};
+			}
+
+			// flag != 0 ? a : b
+			pack select_(const pack flag, const pack a, const pack b)
+			{
+				return {_mm256_blendv_pd(b.v, a.v, _mm256_cmp_pd(flag.v, _mm256_setzero_pd(), _CMP_NEQ_OQ))};
+			}
+
+			double sum_(const pack a)
+			{
+				const auto half = _mm_add_pd(_mm256_castpd256_pd128(a.v), _mm256_extractf128_pd(a.v, 1));
+				return _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+			}
+
+			// two shifted adds, by one lane and by two
+			pack scan_(const pack a)
+			{
+				const auto by_one = _mm256_blend_pd(_mm256_permute4x64_pd(a.v, _MM_SHUFFLE(2, 1, 0, 0)),
+				                                    _mm256_setzero_pd(), 1);
+				const auto s = _mm256_add_pd(a.v, by_one);
+				return {_mm256_add_pd(s, _mm256_permute2f128_pd(s, s, 0x08))};
+			}
+
+			pack exp_(const pack a) { return exp_approx(a); }
+			pack sin_(const pack a) { return sin_approx(a, 0.0); }
+			pack cos_(const pack a) { return cos_approx(a); }
+		}
+
+
+		void run_avx2(const kernel k, const double* values, const size_t count, const size_t dimensions,
+		              const size_t stride, double* costs)
+		{
+			run<pack>(k, values, count, dimensions, stride, costs);
+		}
+
+
+		void move_swarm_avx2(const swarm_arguments& a)
+		{
+			move_swarm<pack>(a);
+		}
+
+
+		double dot_avx2(const double* a, const double* b, const size_t n)
+		{
+			return dot<pack>(a, b, n);
+		}
+
+
+		void axpy_avx2(const double alpha, const double* x, double* y, const size_t n)
+		{
+			axpy<pack>(alpha, x, y, n);
+		}
+
+
+		double prefix_sums_avx2(const double* x, const size_t n, double* out)
+		{
+			return prefix_sums<pack>(x, n, out);
+		}
+
+
+		void squared_distances_avx2(const double* values, const size_t count, const size_t dimensions,
+		                            const size_t stride, const double* query, double* out)
+		{
+			squared_distances<pack>(values, count, dimensions, stride, query, out);
+		}
+	}
+}
+
+#endif
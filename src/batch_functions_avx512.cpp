@@ -0,0 +1,129 @@
+// AVX-512F instantiation of the batch kernels, see batch_functions_avx2.cpp.
+
+#include <cstddef>
+
+#if defined(__GNUC__) && !defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+
+#include <immintrin.h>
+
+#pragma GCC target("avx512f")
+// GCC 12 warns about the deliberately undefined registers inside several
+// AVX-512 intrinsics
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+#include "batch_kernels.h"
+
+
+namespace clever
+{
+	namespace batch
+	{
+		namespace
+		{
+			using pack = struct pack_t
+			{
+				static const size_t width = 8;
+
+				__m512d v;
+
+				static pack_t load(const double* p) { return {_mm512_load_pd(p)}; }
+				static pack_t loadu(const double* p) { return {_mm512_loadu_pd(p)}; }
+				static pack_t broadcast(const double x) { return {_mm512_set1_pd(x)}; }
+			};
+
+			pack operator+(const pack a, const pack b) { return {_mm512_add_pd(a.v, b.v)}; }
+			pack operator-(const pack a, const pack b) { return {_mm512_sub_pd(a.v, b.v)}; }
+			pack operator*(const pack a, const pack b) { return {_mm512_mul_pd(a.v, b.v)}; }
+			pack operator/(const pack a, const pack b) { return {_mm512_div_pd(a.v, b.v)}; }
+
+			void store(double* p, const pack a) { _mm512_storeu_pd(p, a.v); }
+			pack fmadd(const pack a, const pack b, const pack c) { return {_mm512_fmadd_pd(a.v, b.v, c.v)}; }
+			pack sqrt_(const pack a) { return {_mm512_sqrt_pd(a.v)}; }
+			pack abs_(const pack a) { return {_mm512_abs_pd(a.v)}; }
+			pack min_(const pack a, const pack b) { return {_mm512_min_pd(a.v, b.v)}; }
+			pack max_(const pack a, const pack b) { return {_mm512_max_pd(a.v, b.v)}; }
+			pack round_(const pack a)
+			{
+				return {_mm512_roundscale_pd(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)};
+			}
+			pack floor_(const pack a) { return {_mm512_roundscale_pd(a.v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC)}; }
+
+			// 2^n for integral n in [-1022, 1023], as in the AVX2 version
+			pack pow2_(const pack n)
+			{
+				const auto biased = _mm512_add_pd(n.v, _mm512_set1_pd(4503599627370496.0 + 1023.0));
+				return {_mm512_castsi512_pd(_mm512_slli_epi64(_mm512_castpd_si512(biased), 52))};
+			}
+
+			// 1 where a < b, else 0
+			pack less_(const pack a, const pack b)
+			{
+				return {_mm512_maskz_mov_pd(_mm512_cmp_pd_mask(a.v, b.v, _CMP_LT_OQ), _mm512_set1_pd(1.0))};
+			}
+
+			// flag != 0 ? a : b
+			pack select_(const pack flag, const pack a, const pack b)
+			{
+				return {_mm512_mask_blend_pd(_mm512_cmp_pd_mask(flag.v, _mm512_setzero_pd(), _CMP_NEQ_OQ), b.v, a.v)};
+			}
+
+			double sum_(const pack a) { return _mm512_reduce_add_pd(a.v); }
+
+			// three shifted adds, by one, two and four lanes
+			pack scan_(const pack a)
+			{
+				const auto by_one = _mm512_set_epi64(6, 5, 4, 3, 2, 1, 0, 0);
+				const auto by_two = _mm512_set_epi64(5, 4, 3, 2, 1, 0, 0, 0);
+				const auto by_four = _mm512_set_epi64(3, 2, 1, 0, 0, 0, 0, 0);
+				auto s = _mm512_add_pd(a.v, _mm512_maskz_permutexvar_pd(0xFE, by_one, a.v));
+				s = _mm512_add_pd(s, _mm512_maskz_permutexvar_pd(0xFC, by_two, s));
+				return {_mm512_add_pd(s, _mm512_maskz_permutexvar_pd(0xF0, by_four, s))};
+			}
+
+			pack exp_(const pack a) { return exp_approx(a); }
+			pack sin_(const pack a) { return sin_approx(a, 0.0); }
+			pack cos_(const pack a) { return cos_approx(a); }
+		}
+
+
+		void run_avx512(const kernel k, const double* values, const size_t count, const size_t dimensions,
+		                const size_t stride, double* costs)
+		{
+			run<pack>(k, values, count, dimensions, stride, costs);
+		}
+
+
+		void move_swarm_avx512(const swarm_arguments& a)
+		{
+			move_swarm<pack>(a);
+		}
+
+
+		double dot_avx512(const double* a, const double* b, const size_t n)
+		{
+			return dot<pack>(a, b, n);
+		}
+
+
+		void axpy_avx512(const double alpha, const double* x, double* y, const size_t n)
+		{
+			axpy<pack>(alpha, x, y, n);
+		}
+
+
+		double prefix_sums_avx512(const double* x, const size_t n, double* out)
+		{
+			return prefix_sums<pack>(x, n, out);
+		}
+
+
+		void squared_distances_avx512(const double* values, const size_t count, const size_t dimensions,
+		                              const size_t stride, const double* query, double* out)
+		{
+			squared_distances<pack>(values, count, dimensions, stride, query, out);
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,478 @@
+#ifndef CLEVER_BATCH_KERNELS_H
+#define CLEVER_BATCH_KERNELS_H
+
+#include <cstddef>
+
+// Internal to batch_functions*.cpp. The kernels are written once as
+// templates over a register type P and instantiated by every translation
+// unit for its own instruction set, which is why this header has to be
+// included after that unit's target pragma.
+//
+// P provides P::width, P::load (aligned), P::loadu (unaligned),
+// P::broadcast, + - * /, and the free functions store (unaligned), fmadd,
+// sqrt_, abs_, min_, max_, less_ (1 where a < b, else 0), select_
+// (flag != 0 ? a : b), sum_ (of the lanes), scan_ (their inclusive prefix
+// sums), exp_, sin_ and cos_.
+// The vector packs build the last three from exp_approx, sin_approx and
+// cos_approx below, which also need round_, floor_ and pow2_.
+
+// Clang defines __GNUC__ but ignores #pragma GCC target, which the vector
+// units depend on, so it takes the scalar path
+#if defined(__GNUC__) && !defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+#define CLEVER_BATCH_X86
+#endif
+
+
+namespace clever
+{
+	namespace batch
+	{
+		enum class kernel
+		{
+			sphere,
+			ackley,
+			rastrigin,
+			rosenbrock,
+			griewank,
+			schwefel,
+			sum_squares,
+			rotated_hyper_ellipsoid
+		};
+
+		// costs[i] for i < count, count a multiple of the register width;
+		// values holds dimensions rows of stride values each, every row
+		// aligned to a cache line
+		void run_avx2(kernel k, const double* values, size_t count, size_t dimensions, size_t stride, double* costs);
+		void run_avx512(kernel k, const double* values, size_t count, size_t dimensions, size_t stride,
+		                double* costs);
+
+
+		// One PSO move, see move_swarm in swarm.h; every pointer but g_best,
+		// lower and upper is cache aligned, rows are stride apart
+		using swarm_arguments = struct swarm_arguments_t
+		{
+			double* position;
+			double* velocity;
+			double* b_position;
+			const double* improved;
+			const double* r1;
+			const double* r2;
+			const double* g_best;
+			const double* lower;
+			const double* upper;
+			size_t count;
+			size_t dimensions;
+			size_t stride;
+			double max_velocity;
+			double c1;
+			double c2;
+		};
+
+		void move_swarm_scalar(const swarm_arguments& a);
+		void move_swarm_avx2(const swarm_arguments& a);
+		void move_swarm_avx512(const swarm_arguments& a);
+
+
+		// the vector_math.h functions, any alignment
+		double dot_scalar(const double* a, const double* b, size_t n);
+		double dot_avx2(const double* a, const double* b, size_t n);
+		double dot_avx512(const double* a, const double* b, size_t n);
+		void axpy_scalar(double alpha, const double* x, double* y, size_t n);
+		void axpy_avx2(double alpha, const double* x, double* y, size_t n);
+		void axpy_avx512(double alpha, const double* x, double* y, size_t n);
+		double prefix_sums_scalar(const double* x, size_t n, double* out);
+		double prefix_sums_avx2(const double* x, size_t n, double* out);
+		double prefix_sums_avx512(const double* x, size_t n, double* out);
+
+		// out[i] = squared distance from query to candidate i, laid out as
+		// the batch kernels read them
+		void squared_distances_scalar(const double* values, size_t count, size_t dimensions, size_t stride,
+		                              const double* query, double* out);
+		void squared_distances_avx2(const double* values, size_t count, size_t dimensions, size_t stride,
+		                            const double* query, double* out);
+		void squared_distances_avx512(const double* values, size_t count, size_t dimensions, size_t stride,
+		                              const double* query, double* out);
+
+
+		// Horner's rule, coefficients from the highest power down
+		template <typename P, size_t N>
+		P polynomial(const P x, const double (&coefficients)[N])
+		{
+			auto p = P::broadcast(coefficients[0]);
+			for (size_t k = 1; k < N; ++k)
+			{
+				p = fmadd(p, x, P::broadcast(coefficients[k]));
+			}
+			return p;
+		}
+
+
+		// exp(x) = 2^n exp(r) with |r| <= ln 2 / 2 and the Taylor series of
+		// exp(r) to r^12, within about 2 ulp; x is clamped to the finite range
+		template <typename P>
+		P exp_approx(P x)
+		{
+			static const double coefficients[] = {
+				1.0 / 479001600.0, 1.0 / 39916800.0, 1.0 / 3628800.0, 1.0 / 362880.0, 1.0 / 40320.0,
+				1.0 / 5040.0, 1.0 / 720.0, 1.0 / 120.0, 1.0 / 24.0, 1.0 / 6.0, 0.5, 1.0, 1.0};
+			x = min_(max_(x, P::broadcast(-708.0)), P::broadcast(709.0));
+			const auto n = round_(x * P::broadcast(1.44269504088896340736));
+			auto r = fmadd(n, P::broadcast(-6.93147180369123816490e-01), x);
+			r = fmadd(n, P::broadcast(-1.90821492927058770002e-10), r);
+			return polynomial(r, coefficients) * pow2_(n);
+		}
+
+
+		// sin(x + quarter * pi / 2): x is reduced to |r| <= pi / 4 around the
+		// nearest multiple q of pi / 2, then the quadrant of q + quarter picks
+		// the sine or cosine series of r and its sign
+		template <typename P>
+		P sin_approx(const P x, const double quarter)
+		{
+			static const double sin_coefficients[] = {
+				1.0 / 355687428096000.0, -1.0 / 1307674368000.0, 1.0 / 6227020800.0, -1.0 / 39916800.0,
+				1.0 / 362880.0, -1.0 / 5040.0, 1.0 / 120.0, -1.0 / 6.0};
+			static const double cos_coefficients[] = {
+				1.0 / 20922789888000.0, -1.0 / 87178291200.0, 1.0 / 479001600.0, -1.0 / 3628800.0,
+				1.0 / 40320.0, -1.0 / 720.0, 1.0 / 24.0, -0.5, 1.0};
+			const auto q = round_(x * P::broadcast(0.63661977236758134308));
+			auto r = fmadd(q, P::broadcast(-1.5707963267948966), x);
+			r = fmadd(q, P::broadcast(-6.123233995736766e-17), r);
+			const auto r2 = r * r;
+			const auto sin_r = fmadd(r * r2, polynomial(r2, sin_coefficients), r);
+			const auto cos_r = polynomial(r2, cos_coefficients);
+
+			const auto shifted = q + P::broadcast(quarter);
+			const auto quadrant = shifted - P::broadcast(4.0) * floor_(shifted * P::broadcast(0.25));
+			const auto negative = floor_(quadrant * P::broadcast(0.5));
+			const auto odd = quadrant - P::broadcast(2.0) * negative;
+			return select_(odd, cos_r, sin_r) * (P::broadcast(1.0) - P::broadcast(2.0) * negative);
+		}
+
+
+		template <typename P>
+		P cos_approx(const P x)
+		{
+			return sin_approx(x, 1.0);
+		}
+
+
+		// The kernels evaluate P::width candidates per step. They follow the
+		// loops of test_functions.cpp so that the scalar instantiation gives
+		// the same sums in the same order.
+
+		template <typename P>
+		void sphere(const double* values, const size_t count, const size_t dimensions,
+		            const size_t stride, double* costs)
+		{
+			for (size_t i = 0; i < count; i += P::width)
+			{
+				auto sum = P::broadcast(0.0);
+				for (size_t d = 0; d < dimensions; ++d)
+				{
+					const auto x = P::load(values + d * stride + i);
+					sum = fmadd(x, x, sum);
+				}
+				store(costs + i, sum);
+			}
+		}
+
+
+		template <typename P>
+		void ackley(const double* values, const size_t count, const size_t dimensions,
+		            const size_t stride, double* costs)
+		{
+			const auto a = P::broadcast(20.0);
+			const auto b = P::broadcast(0.2);
+			const auto c = P::broadcast(2.0 * 3.14159265358979323846);
+			const auto n = P::broadcast(static_cast<double>(dimensions));
+			const auto e = P::broadcast(2.71828182845904523536);
+			for (size_t i = 0; i < count; i += P::width)
+			{
+				auto sum0 = P::broadcast(0.0);
+				auto sum1 = P::broadcast(0.0);
+				for (size_t d = 0; d < dimensions; ++d)
+				{
+					const auto x = P::load(values + d * stride + i);
+					sum0 = fmadd(x, x, sum0);
+					sum1 = sum1 + cos_(c * x);
+				}
+				const auto term0 = P::broadcast(0.0) - a * exp_(P::broadcast(0.0) - b * sqrt_(sum0 / n));
+				const auto term1 = P::broadcast(0.0) - exp_(sum1 / n);
+				store(costs + i, term0 + term1 + a + e);
+			}
+		}
+
+
+		template <typename P>
+		void rastrigin(const double* values, const size_t count, const size_t dimensions,
+		               const size_t stride, double* costs)
+		{
+			const auto ten = P::broadcast(10.0);
+			const auto c = P::broadcast(2.0 * 3.14159265358979323846);
+			for (size_t i = 0; i < count; i += P::width)
+			{
+				auto sum = P::broadcast(10.0 * dimensions);
+				for (size_t d = 0; d < dimensions; ++d)
+				{
+					const auto x = P::load(values + d * stride + i);
+					sum = sum + (x * x - ten * cos_(c * x));
+				}
+				store(costs + i, sum);
+			}
+		}
+
+
+		template <typename P>
+		void rosenbrock(const double* values, const size_t count, const size_t dimensions,
+		                const size_t stride, double* costs)
+		{
+			const auto hundred = P::broadcast(100.0);
+			const auto one = P::broadcast(1.0);
+			for (size_t i = 0; i < count; i += P::width)
+			{
+				auto sum = P::broadcast(0.0);
+				for (size_t d = 0; d + 1 < dimensions; ++d)
+				{
+					const auto x = P::load(values + d * stride + i);
+					const auto a = P::load(values + (d + 1) * stride + i) - x * x;
+					const auto b = x - one;
+					sum = sum + fmadd(hundred * a, a, b * b);
+				}
+				store(costs + i, sum);
+			}
+		}
+
+
+		template <typename P>
+		void griewank(const double* values, const size_t count, const size_t dimensions,
+		              const size_t stride, double* costs)
+		{
+			const auto scale = P::broadcast(4000.0);
+			for (size_t i = 0; i < count; i += P::width)
+			{
+				auto sum = P::broadcast(0.0);
+				auto product = P::broadcast(1.0);
+				for (size_t d = 0; d < dimensions; ++d)
+				{
+					const auto x = P::load(values + d * stride + i);
+					sum = sum + x * x / scale;
+					product = product * cos_(x / sqrt_(P::broadcast(d + 1.0)));
+				}
+				store(costs + i, sum - product + P::broadcast(1.0));
+			}
+		}
+
+
+		template <typename P>
+		void schwefel(const double* values, const size_t count, const size_t dimensions,
+		              const size_t stride, double* costs)
+		{
+			for (size_t i = 0; i < count; i += P::width)
+			{
+				auto sum = P::broadcast(418.9829 * dimensions);
+				for (size_t d = 0; d < dimensions; ++d)
+				{
+					const auto x = P::load(values + d * stride + i);
+					sum = sum - x * sin_(sqrt_(abs_(x)));
+				}
+				store(costs + i, sum);
+			}
+		}
+
+
+		template <typename P>
+		void sum_squares(const double* values, const size_t count, const size_t dimensions,
+		                 const size_t stride, double* costs)
+		{
+			for (size_t i = 0; i < count; i += P::width)
+			{
+				auto sum = P::broadcast(0.0);
+				for (size_t d = 0; d < dimensions; ++d)
+				{
+					const auto x = P::load(values + d * stride + i);
+					sum = fmadd(P::broadcast(d + 1.0) * x, x, sum);
+				}
+				store(costs + i, sum);
+			}
+		}
+
+
+		template <typename P>
+		void rotated_hyper_ellipsoid(const double* values, const size_t count, const size_t dimensions,
+		                             const size_t stride, double* costs)
+		{
+			for (size_t i = 0; i < count; i += P::width)
+			{
+				auto sum = P::broadcast(0.0);
+				auto prefix = P::broadcast(0.0);
+				for (size_t d = 0; d < dimensions; ++d)
+				{
+					const auto x = P::load(values + d * stride + i);
+					prefix = fmadd(x, x, prefix);
+					sum = sum + prefix;
+				}
+				store(costs + i, sum);
+			}
+		}
+
+
+
+		// two registers of partial sums hide the latency of fmadd; the tail
+		// that fills no register is summed one by one
+		template <typename P>
+		double dot(const double* a, const double* b, const size_t n)
+		{
+			auto s0 = P::broadcast(0.0);
+			auto s1 = P::broadcast(0.0);
+			size_t i = 0;
+			for (; i + 2 * P::width <= n; i += 2 * P::width)
+			{
+				s0 = fmadd(P::loadu(a + i), P::loadu(b + i), s0);
+				s1 = fmadd(P::loadu(a + i + P::width), P::loadu(b + i + P::width), s1);
+			}
+			for (; i + P::width <= n; i += P::width)
+			{
+				s0 = fmadd(P::loadu(a + i), P::loadu(b + i), s0);
+			}
+			auto sum = sum_(s0 + s1);
+			for (; i < n; ++i)
+			{
+				sum += a[i] * b[i];
+			}
+			return sum;
+		}
+
+
+		template <typename P>
+		void squared_distances(const double* values, const size_t count, const size_t dimensions,
+		                       const size_t stride, const double* query, double* out)
+		{
+			for (size_t i = 0; i < count; i += P::width)
+			{
+				auto sum = P::broadcast(0.0);
+				for (size_t d = 0; d < dimensions; ++d)
+				{
+					const auto diff = P::load(values + d * stride + i) - P::broadcast(query[d]);
+					sum = fmadd(diff, diff, sum);
+				}
+				store(out + i, sum);
+			}
+		}
+
+
+		template <typename P>
+		void axpy(const double alpha, const double* x, double* y, const size_t n)
+		{
+			const auto a = P::broadcast(alpha);
+			size_t i = 0;
+			for (; i + P::width <= n; i += P::width)
+			{
+				store(y + i, fmadd(a, P::loadu(x + i), P::loadu(y + i)));
+			}
+			for (; i < n; ++i)
+			{
+				y[i] += alpha * x[i];
+			}
+		}
+
+		// each register is scanned in place and offset by the total so far,
+		// which is read back from the last value stored; out may be x
+		template <typename P>
+		double prefix_sums(const double* x, const size_t n, double* out)
+		{
+			double total = 0.0;
+			size_t i = 0;
+			for (; i + P::width <= n; i += P::width)
+			{
+				store(out + i, scan_(P::loadu(x + i)) + P::broadcast(total));
+				total = out[i + P::width - 1];
+			}
+			for (; i < n; ++i)
+			{
+				total += x[i];
+				out[i] = total;
+			}
+			return total;
+		}
+
+
+		// Fused velocity, position and reflection update of a swarm, one pass
+		// per dimension. Particles marked improved first take their current
+		// position as their best, the personal best update that the previous
+		// evaluation left pending.
+		template <typename P>
+		void move_swarm(const swarm_arguments& a)
+		{
+			const auto c1 = P::broadcast(a.c1);
+			const auto c2 = P::broadcast(a.c2);
+			const auto max_velocity = P::broadcast(a.max_velocity);
+			const auto min_velocity = P::broadcast(-a.max_velocity);
+			const auto zero = P::broadcast(0.0);
+			for (size_t d = 0; d < a.dimensions; ++d)
+			{
+				const auto row = d * a.stride;
+				const auto g = P::broadcast(a.g_best[d]);
+				const auto lower = P::broadcast(a.lower[d]);
+				const auto upper = P::broadcast(a.upper[d]);
+				for (size_t i = 0; i < a.count; i += P::width)
+				{
+					const auto position = P::load(a.position + row + i);
+					const auto b_position = select_(P::load(a.improved + i), position, P::load(a.b_position + row + i));
+					store(a.b_position + row + i, b_position);
+
+					auto v = P::load(a.velocity + row + i)
+						+ c1 * P::load(a.r1 + row + i) * (b_position - position)
+						+ c2 * P::load(a.r2 + row + i) * (g - position);
+					v = max_(min_velocity, min_(max_velocity, v));
+
+					auto p = position + v;
+					const auto over = less_(upper, p);
+					p = select_(over, upper - (p - upper), p);
+					v = select_(over, zero - v, v);
+					const auto under = less_(p, lower);
+					p = select_(under, lower + (lower - p), p);
+					v = select_(under, zero - v, v);
+					store(a.position + row + i, p);
+					store(a.velocity + row + i, v);
+				}
+			}
+		}
+
+
+		template <typename P>
+		void run(const kernel k, const double* values, const size_t count, const size_t dimensions,
+		         const size_t stride, double* costs)
+		{
+			switch (k)
+			{
+			case kernel::sphere:
+				sphere<P>(values, count, dimensions, stride, costs);
+				break;
+			case kernel::ackley:
+				ackley<P>(values, count, dimensions, stride, costs);
+				break;
+			case kernel::rastrigin:
+				rastrigin<P>(values, count, dimensions, stride, costs);
+				break;
+			case kernel::rosenbrock:
+				rosenbrock<P>(values, count, dimensions, stride, costs);
+				break;
+			case kernel::griewank:
+				griewank<P>(values, count, dimensions, stride, costs);
+				break;
+			case kernel::schwefel:
+				schwefel<P>(values, count, dimensions, stride, costs);
+				break;
+			case kernel::sum_squares:
+				sum_squares<P>(values, count, dimensions, stride, costs);
+				break;
+			case kernel::rotated_hyper_ellipsoid:
+				rotated_hyper_ellipsoid<P>(values, count, dimensions, stride, costs);
+				break;
+			}
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,330 @@
+#include "clever/bayesian_network.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+
+namespace clever
+{
+	namespace
+	{
+		// set bits of a & b
+		size_t count_and(const bit_string& a, const bit_string& b)
+		{
+			size_t sum = 0;
+			for (size_t w = 0; w < a.num_words(); ++w)
+			{
+				sum += popcount(a.words()[w] & b.words()[w]);
+			}
+			return sum;
+		}
+
+
+		// set bits of a & b & c
+		size_t count_and(const bit_string& a, const bit_string& b, const bit_string& c)
+		{
+			size_t sum = 0;
+			for (size_t w = 0; w < a.num_words(); ++w)
+			{
+				sum += popcount(a.words()[w] & b.words()[w] & c.words()[w]);
+			}
+			return sum;
+		}
+
+
+		// term of one parent configuration, log(n0! n1! / (n0 + n1 + 1)!)
+		double k2_term(const std::vector<double>& log_factorial, const size_t n0, const size_t n1)
+		{
+			return log_factorial[n0] + log_factorial[n1] - log_factorial[n0 + n1 + 1];
+		}
+
+
+		// ones / samples, except that a configuration whose samples all
+		// agree gets half a sample of each value, so that a bit the selected
+		// samples have lost can still be drawn
+		double frequency(const double ones, const double samples)
+		{
+			if (ones > 0.0 && ones < samples)
+			{
+				return ones / samples;
+			}
+			return (ones + 0.5) / (samples + 1.0);
+		}
+	}
+
+
+	double k2_log_score(const std::vector<size_t>& counts)
+	{
+		double total = 0.0;
+		for (size_t j = 0; j + 1 < counts.size(); j += 2)
+		{
+			const auto n0 = static_cast<double>(counts[j]);
+			const auto n1 = static_cast<double>(counts[j + 1]);
+			total += std::lgamma(n0 + 1.0) + std::lgamma(n1 + 1.0) - std::lgamma(n0 + n1 + 2.0);
+		}
+		return total;
+	}
+
+
+	void bayesian_network::learn(const std::vector<bit_string>& samples, const size_t max_edges,
+	                             const size_t max_parents, thread_pool& pool)
+	{
+		const auto n = samples.empty() ? 0 : samples[0].size();
+		num_samples_ = samples.size();
+		max_parents_ = max_parents;
+		edges_ = 0;
+		parents_.assign(n, std::vector<size_t>());
+		children_.assign(n, std::vector<size_t>());
+
+		columns_.assign(n, bit_string(num_samples_));
+		for (size_t s = 0; s < num_samples_; ++s)
+		{
+			for (size_t i = 0; i < n; ++i)
+			{
+				if (samples[s][i])
+				{
+					columns_[i].set(s, true);
+				}
+			}
+		}
+
+		log_factorial_.resize(num_samples_ + 2);
+		for (size_t i = 0; i < log_factorial_.size(); ++i)
+		{
+			log_factorial_[i] = std::lgamma(static_cast<double>(i) + 1.0);
+		}
+
+		// no parents: a single configuration holding every sample
+		bit_string all(num_samples_);
+		for (size_t s = 0; s < num_samples_; ++s)
+		{
+			all.set(s, true);
+		}
+		configurations_.assign(n, std::vector<bit_string>(1, all));
+		counts_.assign(n, std::vector<size_t>(2));
+		scores_.resize(n);
+		for (size_t i = 0; i < n; ++i)
+		{
+			counts_[i][1] = columns_[i].count();
+			counts_[i][0] = num_samples_ - counts_[i][1];
+			scores_[i] = k2_term(log_factorial_, counts_[i][0], counts_[i][1]);
+		}
+
+		gains_.assign(n * n, -DBL_MAX);
+		best_.assign(n, 0);
+		visited_.assign(n, 0);
+		// one row per node, each row only reads shared state
+		pool.parallel_for(n, [&](const size_t i)
+		{
+			update_gains(i, pool);
+		});
+
+		while (edges_ < max_edges)
+		{
+			double best = 0.0;
+			size_t to = n;
+			for (size_t child = 0; child < n; ++child)
+			{
+				const auto gain = gains_[child * n + best_[child]];
+				if (gain > best)
+				{
+					best = gain;
+					to = child;
+				}
+			}
+			if (to == n)
+			{
+				break;
+			}
+			const auto from = best_[to];
+			if (path_exists(to, from))
+			{
+				// edges are never removed, so this one stays a cycle
+				gains_[to * n + from] = -DBL_MAX;
+				update_best(to);
+				continue;
+			}
+			add_edge(from, to, pool);
+		}
+
+		probabilities_.resize(n);
+		for (size_t i = 0; i < n; ++i)
+		{
+			const auto& counts = counts_[i];
+			double ones = 0.0, total = 0.0;
+			for (size_t c = 0; c < counts.size() / 2; ++c)
+			{
+				ones += counts[2 * c + 1];
+				total += counts[2 * c] + counts[2 * c + 1];
+			}
+			const auto marginal = frequency(ones, total);
+			probabilities_[i].resize(counts.size() / 2);
+			for (size_t c = 0; c < probabilities_[i].size(); ++c)
+			{
+				const double samples = counts[2 * c] + counts[2 * c + 1];
+				probabilities_[i][c] = samples > 0.0 ? frequency(counts[2 * c + 1], samples) : marginal;
+			}
+		}
+		topological_order(order_);
+	}
+
+
+	void bayesian_network::topological_order(std::vector<size_t>& order) const
+	{
+		std::vector<size_t> in(size());
+		order.clear();
+		for (size_t i = 0; i < size(); ++i)
+		{
+			in[i] = parents_[i].size();
+			if (in[i] == 0)
+			{
+				order.push_back(i);
+			}
+		}
+		for (size_t k = 0; k < order.size(); ++k)
+		{
+			for (const auto child : children_[order[k]])
+			{
+				if (--in[child] == 0)
+				{
+					order.push_back(child);
+				}
+			}
+		}
+	}
+
+
+	double bayesian_network::score_with(const size_t node, const size_t parent) const
+	{
+		const auto& column = columns_[node];
+		const auto& with = columns_[parent];
+		const auto& counts = counts_[node];
+		double total = 0.0;
+		for (size_t c = 0; c < configurations_[node].size(); ++c)
+		{
+			const auto& mask = configurations_[node][c];
+			// the configuration splits on the new parent's value
+			const auto on = count_and(mask, with);
+			const auto on1 = count_and(mask, with, column);
+			const auto off1 = counts[2 * c + 1] - on1;
+			const auto off0 = counts[2 * c] + counts[2 * c + 1] - on - off1;
+			total += k2_term(log_factorial_, off0, off1) + k2_term(log_factorial_, on - on1, on1);
+		}
+		return total;
+	}
+
+
+	void bayesian_network::sample(bit_string& bits, random_engine& rng) const
+	{
+		bits.resize(size());
+		for (const auto node : order_)
+		{
+			size_t configuration = 0;
+			for (size_t m = 0; m < parents_[node].size(); ++m)
+			{
+				configuration |= (bits[parents_[node][m]] ? size_t(1) : size_t(0)) << m;
+			}
+			bits.set(node, rng.uniform() < probabilities_[node][configuration]);
+		}
+	}
+
+
+	void bayesian_network::sample(std::vector<bit_string>& samples, const size_t count, const std::uint64_t seed,
+	                              thread_pool& pool) const
+	{
+		samples.resize(count);
+		pool.parallel_for(count, [&](const size_t i)
+		{
+			random_engine rng(seed, i);
+			sample(samples[i], rng);
+		}, 4);
+	}
+
+
+	void bayesian_network::update_gains(const size_t node, thread_pool& pool)
+	{
+		const auto n = size();
+		const auto row = &gains_[node * n];
+		const bool full = parents_[node].size() >= max_parents_;
+		// runs inline when called from a loop over the nodes
+		pool.parallel_for(n, [&](const size_t parent)
+		{
+			const bool allowed = !full && parent != node
+				&& std::find(parents_[node].begin(), parents_[node].end(), parent) == parents_[node].end();
+			row[parent] = allowed ? score_with(node, parent) - scores_[node] : -DBL_MAX;
+		}, 32);
+		update_best(node);
+	}
+
+
+	void bayesian_network::update_best(const size_t node)
+	{
+		const auto row = &gains_[node * size()];
+		best_[node] = static_cast<size_t>(std::max_element(row, row + size()) - row);
+	}
+
+
+	bool bayesian_network::path_exists(const size_t from, const size_t to) const
+	{
+		if (from == to)
+		{
+			return true;
+		}
+		std::fill(visited_.begin(), visited_.end(), 0);
+		stack_.assign(1, from);
+		visited_[from] = 1;
+		while (!stack_.empty())
+		{
+			const auto k = stack_.back();
+			stack_.pop_back();
+			for (const auto child : children_[k])
+			{
+				if (child == to)
+				{
+					return true;
+				}
+				if (!visited_[child])
+				{
+					visited_[child] = 1;
+					stack_.push_back(child);
+				}
+			}
+		}
+		return false;
+	}
+
+
+	void bayesian_network::add_edge(const size_t parent, const size_t child, thread_pool& pool)
+	{
+		scores_[child] += gains_[child * size() + parent];
+		parents_[child].push_back(parent);
+		children_[parent].push_back(child);
+		++edges_;
+
+		// every configuration splits in two, the new parent is the top bit
+		auto& configurations = configurations_[child];
+		const auto old_size = configurations.size();
+		configurations.resize(2 * old_size);
+		const auto& with = columns_[parent];
+		for (size_t c = 0; c < old_size; ++c)
+		{
+			auto& off = configurations[c];
+			auto& on = configurations[old_size + c];
+			on = off;
+			for (size_t w = 0; w < off.num_words(); ++w)
+			{
+				on.words()[w] &= with.words()[w];
+				off.words()[w] &= ~with.words()[w];
+			}
+		}
+		auto& counts = counts_[child];
+		counts.resize(2 * configurations.size());
+		for (size_t c = 0; c < configurations.size(); ++c)
+		{
+			counts[2 * c + 1] = count_and(configurations[c], columns_[child]);
+			counts[2 * c] = configurations[c].count() - counts[2 * c + 1];
+		}
+		update_gains(child, pool);
+	}
+}
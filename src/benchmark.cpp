@@ -0,0 +1,189 @@
+#include "clever/benchmark.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+
+namespace clever
+{
+	namespace
+	{
+		const auto start_time = std::chrono::steady_clock::now();
+
+
+		FILE* open_trace()
+		{
+			const char* path = std::getenv("CLEVER_TRACE");
+			return path == nullptr || *path == '\0' ? nullptr : std::fopen(path, "w");
+		}
+
+
+		// JSON has no literal for infinity or NaN
+		void write_number(std::ostream& out, const double value)
+		{
+			if (std::isfinite(value))
+			{
+				out << value;
+			}
+			else
+			{
+				out << "null";
+			}
+		}
+
+
+		void write_string(std::ostream& out, const std::string& value)
+		{
+			out << '"';
+			for (const auto c : value)
+			{
+				if (c == '"' || c == '\\')
+				{
+					out << '\\';
+				}
+				out << c;
+			}
+			out << '"';
+		}
+	}
+
+
+	double elapsed_seconds()
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+	}
+
+
+	void trace_progress(const size_t evaluations, const double best)
+	{
+		static FILE* const file = open_trace();
+		if (file != nullptr)
+		{
+			// stdio locks the stream, so lines from different threads do not mix
+			std::fprintf(file, "%.6f %zu %.17g\n", elapsed_seconds(), evaluations, best);
+		}
+	}
+
+
+	size_t peak_memory_kb()
+	{
+#if defined(__unix__) || defined(__APPLE__)
+		rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) != 0)
+		{
+			return 0;
+		}
+#ifdef __APPLE__
+		return static_cast<size_t>(usage.ru_maxrss) / 1024;
+#else
+		return static_cast<size_t>(usage.ru_maxrss);
+#endif
+#else
+		return 0;
+#endif
+	}
+
+
+	void read_trace(std::istream& in, std::vector<trace_point>& curve)
+	{
+		curve.clear();
+		trace_point point;
+		while (in >> point.seconds >> point.evaluations >> point.best)
+		{
+			curve.push_back(point);
+		}
+	}
+
+
+	double time_to_target(const std::vector<trace_point>& curve, const double target, const bool minimize)
+	{
+		for (const auto& point : curve)
+		{
+			if (minimize ? point.best <= target : point.best >= target)
+			{
+				return point.seconds;
+			}
+		}
+		return -1.0;
+	}
+
+
+	double evaluations_per_second(const benchmark_run& run)
+	{
+		return run.seconds > 0.0 ? run.evaluations / run.seconds : 0.0;
+	}
+
+
+	void write_csv(std::ostream& out, const std::vector<benchmark_run>& runs)
+	{
+		out << "algorithm,seed,completed,seconds,evaluations,evaluations_per_second,best,time_to_target,"
+			"peak_memory_kb\n";
+		for (const auto& run : runs)
+		{
+			out << run.algorithm << ',' << run.seed << ',' << (run.completed ? 1 : 0) << ',' << run.seconds << ','
+				<< run.evaluations << ',' << evaluations_per_second(run) << ',' << run.best << ','
+				<< run.time_to_target << ',' << run.peak_memory_kb << '\n';
+		}
+	}
+
+
+	void write_curves_csv(std::ostream& out, const std::vector<benchmark_run>& runs)
+	{
+		out << "algorithm,seed,seconds,evaluations,best\n";
+		for (const auto& run : runs)
+		{
+			for (const auto& point : run.curve)
+			{
+				out << run.algorithm << ',' << run.seed << ',' << point.seconds << ',' << point.evaluations << ','
+					<< point.best << '\n';
+			}
+		}
+	}
+
+
+	void write_json(std::ostream& out, const std::vector<benchmark_run>& runs)
+	{
+		out << "[\n";
+		for (size_t i = 0; i < runs.size(); ++i)
+		{
+			const auto& run = runs[i];
+			out << "  {\"algorithm\": ";
+			write_string(out, run.algorithm);
+			out << ", \"seed\": " << run.seed
+				<< ", \"completed\": " << (run.completed ? "true" : "false")
+				<< ", \"seconds\": ";
+			write_number(out, run.seconds);
+			out << ", \"evaluations\": " << run.evaluations << ", \"evaluations_per_second\": ";
+			write_number(out, evaluations_per_second(run));
+			out << ", \"best\": ";
+			write_number(out, run.best);
+			out << ", \"time_to_target\": ";
+			if (run.time_to_target < 0.0)
+			{
+				out << "null";
+			}
+			else
+			{
+				write_number(out, run.time_to_target);
+			}
+			out << ", \"peak_memory_kb\": " << run.peak_memory_kb << ", \"curve\": [";
+			for (size_t j = 0; j < run.curve.size(); ++j)
+			{
+				const auto& point = run.curve[j];
+				out << (j == 0 ? "" : ", ") << '[';
+				write_number(out, point.seconds);
+				out << ", " << point.evaluations << ", ";
+				write_number(out, point.best);
+				out << ']';
+			}
+			out << "]}" << (i + 1 == runs.size() ? "\n" : ",\n");
+		}
+		out << "]\n";
+	}
+}
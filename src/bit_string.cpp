@@ -0,0 +1,201 @@
+#include "clever/bit_string.h"
+
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+
+
+namespace clever
+{
+	namespace
+	{
+		// mask of the low n bits of a word, n in [0, 64]
+		bit_string::word_type low_mask(const size_t n)
+		{
+			return n >= bit_string::word_bits ? ~bit_string::word_type(0) : (bit_string::word_type(1) << n) - 1;
+		}
+	}
+
+
+	bit_string::bit_string(const size_t size)
+	{
+		resize(size);
+	}
+
+
+	void bit_string::resize(const size_t size)
+	{
+		size_ = size;
+		words_.resize((size + word_bits - 1) / word_bits, 0);
+		clear_tail();
+	}
+
+
+	void bit_string::reset()
+	{
+		std::fill(words_.begin(), words_.end(), word_type(0));
+	}
+
+
+	size_t bit_string::count() const
+	{
+		size_t sum = 0;
+		for (const auto word : words_)
+		{
+			sum += popcount(word);
+		}
+		return sum;
+	}
+
+
+	void bit_string::clear_tail()
+	{
+		const auto used = size_ % word_bits;
+		if (used != 0)
+		{
+			words_.back() &= low_mask(used);
+		}
+	}
+
+
+	std::string bit_string::to_string() const
+	{
+		std::string text(size_, '0');
+		for (size_t i = 0; i < size_; ++i)
+		{
+			if ((*this)[i])
+			{
+				text[i] = '1';
+			}
+		}
+		return text;
+	}
+
+
+	std::ostream& operator<<(std::ostream& out, const bit_string& bits)
+	{
+		return out << bits.to_string();
+	}
+
+
+	size_t popcount(bit_string::word_type word)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return static_cast<size_t>(__builtin_popcountll(word));
+#else
+		word = word - ((word >> 1) & 0x5555555555555555ULL);
+		word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+		word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+		return static_cast<size_t>((word * 0x0101010101010101ULL) >> 56);
+#endif
+	}
+
+
+	void random_bit_string(bit_string& bits, const size_t size, random_engine& rng)
+	{
+		bits.resize(size);
+		auto* words = bits.words();
+		for (size_t i = 0; i < bits.num_words(); ++i)
+		{
+			words[i] = rng();
+		}
+		bits.clear_tail();
+	}
+
+
+	void sample_bit_string(bit_string& bits, const std::vector<double>& probabilities, random_engine& rng)
+	{
+		bits.resize(probabilities.size());
+		auto* words = bits.words();
+		for (size_t w = 0; w < bits.num_words(); ++w)
+		{
+			const auto begin = w * bit_string::word_bits;
+			const auto end = std::min(begin + bit_string::word_bits, probabilities.size());
+			bit_string::word_type word = 0;
+			for (size_t i = begin; i < end; ++i)
+			{
+				word |= bit_string::word_type(rng.uniform() < probabilities[i]) << (i - begin);
+			}
+			words[w] = word;
+		}
+	}
+
+
+	void point_mutation(bit_string& bits, const double rate, random_engine& rng)
+	{
+		if (rate <= 0.0 || bits.empty())
+		{
+			return;
+		}
+		if (rate >= 1.0)
+		{
+			auto* words = bits.words();
+			for (size_t w = 0; w < bits.num_words(); ++w)
+			{
+				words[w] = ~words[w];
+			}
+			bits.clear_tail();
+			return;
+		}
+
+		// number of untouched bits before the next flip ~ Geometric(rate)
+		const auto scale = 1.0 / std::log1p(-rate);
+		const auto n = static_cast<double>(bits.size());
+		auto i = std::floor(std::log(1.0 - rng.uniform()) * scale);
+		while (i < n)
+		{
+			bits.flip(static_cast<size_t>(i));
+			i += 1.0 + std::floor(std::log(1.0 - rng.uniform()) * scale);
+		}
+	}
+
+
+	void one_point_crossover(bit_string& child, const bit_string& parent1, const bit_string& parent2,
+	                         const size_t point)
+	{
+		child.resize(parent1.size());
+		const auto* p1 = parent1.words();
+		const auto* p2 = parent2.words();
+		auto* c = child.words();
+		const auto split = point / bit_string::word_bits;
+		for (size_t w = 0; w < child.num_words(); ++w)
+		{
+			if (w < split)
+			{
+				c[w] = p1[w];
+			}
+			else if (w > split)
+			{
+				c[w] = p2[w];
+			}
+			else
+			{
+				const auto mask = low_mask(point % bit_string::word_bits);
+				c[w] = (p1[w] & mask) | (p2[w] & ~mask);
+			}
+		}
+		child.clear_tail();
+	}
+
+
+	void uniform_crossover(bit_string& child, const bit_string& parent1, const bit_string& parent2,
+	                       random_engine& rng)
+	{
+		child.resize(parent1.size());
+		const auto* p1 = parent1.words();
+		const auto* p2 = parent2.words();
+		auto* c = child.words();
+		for (size_t w = 0; w < child.num_words(); ++w)
+		{
+			const auto mask = rng();
+			c[w] = (p1[w] & mask) | (p2[w] & ~mask);
+		}
+		child.clear_tail();
+	}
+
+
+	double onemax(const bit_string& bits)
+	{
+		return static_cast<double>(bits.count());
+	}
+}
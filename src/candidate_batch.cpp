@@ -0,0 +1,106 @@
+#include "clever/candidate_batch.h"
+
+#include <algorithm>
+
+
+namespace clever
+{
+	candidate_batch::candidate_batch(const size_t size, const size_t dimensions)
+	{
+		resize(size, dimensions);
+	}
+
+
+	void candidate_batch::resize(const size_t size, const size_t dimensions)
+	{
+		size_ = size;
+		dimensions_ = dimensions;
+		stride_ = (size + lanes - 1) / lanes * lanes;
+		values_.assign(stride_ * dimensions_, 0.0);
+	}
+
+
+	void candidate_batch::set(const size_t i, const std::vector<double>& vector)
+	{
+		for (size_t d = 0; d < dimensions_; ++d)
+		{
+			values_[d * stride_ + i] = vector[d];
+		}
+	}
+
+
+	void candidate_batch::get(const size_t i, std::vector<double>& vector) const
+	{
+		vector.resize(dimensions_);
+		for (size_t d = 0; d < dimensions_; ++d)
+		{
+			vector[d] = values_[d * stride_ + i];
+		}
+	}
+
+
+	void candidate_batch::copy(const size_t i, const candidate_batch& from, const size_t j)
+	{
+		for (size_t d = 0; d < dimensions_; ++d)
+		{
+			values_[d * stride_ + i] = from(j, d);
+		}
+	}
+
+
+	void candidate_batch::gather(const candidate_batch& from, const std::vector<size_t>& indices)
+	{
+		resize(indices.size(), from.dimensions());
+		for (size_t d = 0; d < dimensions_; ++d)
+		{
+			const auto source = from.dimension(d);
+			const auto target = dimension(d);
+			for (size_t i = 0; i < size_; ++i)
+			{
+				target[i] = source[indices[i]];
+			}
+		}
+	}
+
+
+	void candidate_batch::reserve(const size_t capacity)
+	{
+		if (capacity <= stride_)
+		{
+			return;
+		}
+		const auto stride = (capacity + lanes - 1) / lanes * lanes;
+		aligned_vector<double> values(stride * dimensions_, 0.0);
+		for (size_t d = 0; d < dimensions_; ++d)
+		{
+			std::copy(dimension(d), dimension(d) + size_, values.data() + d * stride);
+		}
+		values_.swap(values);
+		stride_ = stride;
+	}
+
+
+	void candidate_batch::push_back(const std::vector<double>& vector)
+	{
+		if (size_ == 0 && dimensions_ != vector.size())
+		{
+			resize(0, vector.size());
+		}
+		if (size_ == stride_)
+		{
+			reserve(stride_ == 0 ? size_t(lanes) : 2 * stride_);
+		}
+		set(size_++, vector);
+	}
+
+
+	void candidate_batch::concatenate(const candidate_batch& a, const candidate_batch& b)
+	{
+		resize(a.size() + b.size(), a.dimensions());
+		for (size_t d = 0; d < dimensions_; ++d)
+		{
+			std::copy(a.dimension(d), a.dimension(d) + a.size(), dimension(d));
+			std::copy(b.dimension(d), b.dimension(d) + b.size(), dimension(d) + a.size());
+		}
+	}
+}
@@ -0,0 +1,113 @@
+#include "clever/dataset.h"
+
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CLEVER_DATASET_MMAP
+#endif
+
+
+namespace clever
+{
+	bool mapped_dataset::open(const std::string& path, const size_t columns)
+	{
+		close();
+		if (columns == 0)
+		{
+			return false;
+		}
+		const auto row_bytes = columns * sizeof(double);
+#ifdef CLEVER_DATASET_MMAP
+		const int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			return false;
+		}
+		struct stat info;
+		if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) % row_bytes != 0)
+		{
+			::close(fd);
+			return false;
+		}
+		const auto bytes = static_cast<size_t>(info.st_size);
+		void* data = nullptr;
+		if (bytes > 0)
+		{
+			data = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+		}
+		// the mapping outlives the descriptor
+		::close(fd);
+		if (data == MAP_FAILED)
+		{
+			return false;
+		}
+		if (data != nullptr)
+		{
+			// rows are mostly read front to back
+			madvise(data, bytes, MADV_SEQUENTIAL);
+			data_ = static_cast<const double*>(data);
+			mapped_ = bytes;
+			rows_ = bytes / row_bytes;
+			columns_ = columns;
+			return true;
+		}
+#else
+		std::ifstream in(path, std::ios::binary | std::ios::ate);
+		if (!in)
+		{
+			return false;
+		}
+		const auto bytes = static_cast<size_t>(in.tellg());
+		if (bytes % row_bytes != 0)
+		{
+			return false;
+		}
+		buffer_.resize(bytes / sizeof(double));
+		in.seekg(0);
+		if (!in.read(reinterpret_cast<char*>(buffer_.data()), static_cast<std::streamsize>(bytes)))
+		{
+			buffer_.clear();
+			return false;
+		}
+#endif
+		// an empty file is an empty table; the buffer keeps data_ non-null
+		buffer_.reserve(1);
+		data_ = buffer_.data();
+		rows_ = buffer_.size() / columns;
+		columns_ = columns;
+		return true;
+	}
+
+
+	void mapped_dataset::close()
+	{
+#ifdef CLEVER_DATASET_MMAP
+		if (mapped_ != 0)
+		{
+			munmap(const_cast<double*>(data_), mapped_);
+		}
+#endif
+		data_ = nullptr;
+		rows_ = 0;
+		columns_ = 0;
+		mapped_ = 0;
+		buffer_.clear();
+		buffer_.shrink_to_fit();
+	}
+
+
+	bool save_dataset(const std::string& path, const dataset_view& data)
+	{
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		for (size_t i = 0; i < data.rows() && out; ++i)
+		{
+			out.write(reinterpret_cast<const char*>(data.row(i)),
+			          static_cast<std::streamsize>(data.columns() * sizeof(double)));
+		}
+		return static_cast<bool>(out);
+	}
+}
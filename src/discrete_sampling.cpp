@@ -0,0 +1,168 @@
+#include "clever/discrete_sampling.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "clever/vector_math.h"
+
+
+namespace clever
+{
+	void alias_table::build(const std::vector<double>& weights)
+	{
+		const auto n = weights.size();
+		probability_.assign(n, 1.0);
+		alias_.resize(n);
+		double sum = 0.0;
+		for (const auto w : weights)
+		{
+			sum += w;
+		}
+		if (n == 0 || sum <= 0.0)
+		{
+			for (size_t i = 0; i < n; ++i)
+			{
+				alias_[i] = i;
+			}
+			return;
+		}
+
+		// Vose's variant: columns below the mean are topped up from columns
+		// above it, each small column taking one alias
+		std::vector<size_t> small, large;
+		for (size_t i = 0; i < n; ++i)
+		{
+			probability_[i] = weights[i] * static_cast<double>(n) / sum;
+			alias_[i] = i;
+			(probability_[i] < 1.0 ? small : large).push_back(i);
+		}
+		while (!small.empty() && !large.empty())
+		{
+			const auto s = small.back();
+			small.pop_back();
+			const auto l = large.back();
+			alias_[s] = l;
+			probability_[l] -= 1.0 - probability_[s];
+			if (probability_[l] < 1.0)
+			{
+				large.pop_back();
+				small.push_back(l);
+			}
+		}
+		// what is left is full up to rounding
+		for (const auto i : small)
+		{
+			probability_[i] = 1.0;
+		}
+		for (const auto i : large)
+		{
+			probability_[i] = 1.0;
+		}
+	}
+
+
+	void power_law_weights(std::vector<double>& weights, const size_t n, const double tau)
+	{
+		weights.resize(n);
+		for (size_t k = 0; k < n; ++k)
+		{
+			weights[k] = std::pow(k + 1.0, -tau);
+		}
+	}
+
+
+	size_t sample_cumulative(const double* cumulative, const size_t n, random_engine& rng)
+	{
+		if (n == 0 || !(cumulative[n - 1] > 0.0))
+		{
+			return n;
+		}
+		const auto total = cumulative[n - 1];
+		const auto* end = cumulative + n;
+		auto found = std::upper_bound(cumulative, end, rng.uniform() * total);
+		// u * total can round up to total, which stands for the last
+		// positive weight
+		if (found == end)
+		{
+			found = std::lower_bound(cumulative, end, total);
+		}
+		return static_cast<size_t>(found - cumulative);
+	}
+
+
+	size_t sample_once(double* weights, const size_t n, random_engine& rng)
+	{
+		prefix_sums(weights, n, weights);
+		return sample_cumulative(weights, n, rng);
+	}
+
+
+	void fenwick_tree::resize(const size_t size)
+	{
+		weights_.assign(size, 0.0);
+		tree_.assign(size, 0.0);
+	}
+
+
+	void fenwick_tree::assign(const std::vector<double>& weights)
+	{
+		weights_ = weights;
+		tree_ = weights;
+		for (size_t k = 1; k <= tree_.size(); ++k)
+		{
+			const auto parent = k + (k & (~k + 1));
+			if (parent <= tree_.size())
+			{
+				tree_[parent - 1] += tree_[k - 1];
+			}
+		}
+	}
+
+
+	void fenwick_tree::add(const size_t i, const double delta)
+	{
+		weights_[i] += delta;
+		for (auto k = i + 1; k <= tree_.size(); k += k & (~k + 1))
+		{
+			tree_[k - 1] += delta;
+		}
+	}
+
+
+	double fenwick_tree::prefix(const size_t count) const
+	{
+		double sum = 0.0;
+		for (auto k = count; k > 0; k -= k & (~k + 1))
+		{
+			sum += tree_[k - 1];
+		}
+		return sum;
+	}
+
+
+	size_t fenwick_tree::find(double target) const
+	{
+		// descends from the highest power of two, skipping every subtree
+		// whose sum target passes
+		size_t step = 1;
+		while (step * 2 <= tree_.size())
+		{
+			step *= 2;
+		}
+		size_t k = 0;
+		for (; step > 0; step /= 2)
+		{
+			if (k + step <= tree_.size() && tree_[k + step - 1] <= target)
+			{
+				k += step;
+				target -= tree_[k - 1];
+			}
+		}
+		// rounding can carry target past the last weight, or onto a zero
+		while (k > 0 && (k >= weights_.size() || weights_[k] <= 0.0))
+		{
+			--k;
+		}
+		return k;
+	}
+}
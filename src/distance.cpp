@@ -0,0 +1,117 @@
+#include "clever/distance.h"
+
+#include <algorithm>
+
+#include "clever/kd_tree.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CLEVER_DISTANCE_SSE2
+#endif
+
+
+namespace clever
+{
+	distance_provider::distance_provider(const city_list& cities, const distance_storage storage)
+		: size_(cities.size()), storage_(storage)
+	{
+		const auto dims = cities.empty() ? 0 : cities[0].size();
+		coordinates_.assign(dims, std::vector<double>(size_));
+		for (size_t i = 0; i < size_; ++i)
+		{
+			for (size_t d = 0; d < dims; ++d)
+			{
+				coordinates_[d][i] = cities[i][d];
+			}
+		}
+
+		if (storage_ == distance_storage::automatic)
+		{
+			storage_ = size_ <= dense_limit ? distance_storage::dense : distance_storage::on_the_fly;
+		}
+		if (storage_ == distance_storage::dense)
+		{
+			dense_.resize(size_ * size_);
+			for (size_t i = 0; i < size_; ++i)
+			{
+				compute_row(i, &dense_[i * size_]);
+			}
+		}
+		else if (storage_ == distance_storage::dense_float)
+		{
+			dense_float_.resize(size_ * size_);
+			std::vector<double> row(size_);
+			for (size_t i = 0; i < size_; ++i)
+			{
+				compute_row(i, row.data());
+				std::copy(row.begin(), row.end(), dense_float_.begin() + i * size_);
+			}
+		}
+	}
+
+
+	void distance_provider::distances_from(const size_t i, double* out) const
+	{
+		switch (storage_)
+		{
+		case distance_storage::dense:
+			std::copy(dense_.begin() + i * size_, dense_.begin() + (i + 1) * size_, out);
+			break;
+		case distance_storage::dense_float:
+			std::copy(dense_float_.begin() + i * size_, dense_float_.begin() + (i + 1) * size_, out);
+			break;
+		default:
+			compute_row(i, out);
+			break;
+		}
+	}
+
+
+	void distance_provider::compute_row(const size_t i, double* out) const
+	{
+		size_t j = 0;
+#ifdef CLEVER_DISTANCE_SSE2
+		for (; j + 2 <= size_; j += 2)
+		{
+			auto sum = _mm_setzero_pd();
+			for (const auto& axis : coordinates_)
+			{
+				const auto diff = _mm_sub_pd(_mm_loadu_pd(&axis[j]), _mm_set1_pd(axis[i]));
+				sum = _mm_add_pd(sum, _mm_mul_pd(diff, diff));
+			}
+			_mm_storeu_pd(out + j, _mm_sqrt_pd(sum));
+		}
+#endif
+		for (; j < size_; ++j)
+		{
+			out[j] = compute(i, j);
+		}
+	}
+
+
+	void distance_provider::build_neighbor_lists(const size_t k)
+	{
+		k_ = size_ == 0 ? 0 : std::min(k, size_ - 1);
+		neighbors_.resize(size_ * k_);
+		if (k_ == 0)
+		{
+			return;
+		}
+
+		std::vector<std::vector<double>> points(size_, std::vector<double>(coordinates_.size()));
+		for (size_t i = 0; i < size_; ++i)
+		{
+			for (size_t d = 0; d < coordinates_.size(); ++d)
+			{
+				points[i][d] = coordinates_[d][i];
+			}
+		}
+		const kd_tree tree(points);
+		std::vector<size_t> nearest;
+		for (size_t i = 0; i < size_; ++i)
+		{
+			tree.nearest(points[i], k_, nearest, i);
+			std::copy(nearest.begin(), nearest.end(), neighbors_.begin() + i * k_);
+		}
+	}
+}
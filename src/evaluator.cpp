@@ -0,0 +1,66 @@
+#include "clever/evaluator.h"
+
+#include <utility>
+
+
+namespace clever
+{
+	evaluator::evaluator(objective_function function)
+		: function_(std::move(function)), evaluations_(0)
+	{
+	}
+
+
+	evaluator::evaluator(objective_function function, batch_objective_function batch)
+		: function_(std::move(function)), batch_(std::move(batch)), evaluations_(0)
+	{
+	}
+
+
+	double evaluator::operator()(const std::vector<double>& vector) const
+	{
+		evaluations_.fetch_add(1, std::memory_order_relaxed);
+		return function_(vector);
+	}
+
+
+	void evaluator::evaluate_batch(const std::vector<std::vector<double>>& vectors, std::vector<double>& costs,
+	                               thread_pool& pool) const
+	{
+		costs.resize(vectors.size());
+		pool.parallel_for(vectors.size(), [&](const size_t i)
+		{
+			costs[i] = (*this)(vectors[i]);
+		});
+	}
+
+
+	void evaluator::evaluate_batch(const candidate_batch& batch, std::vector<double>& costs, thread_pool& pool) const
+	{
+		if (batch_)
+		{
+			evaluations_.fetch_add(batch.size(), std::memory_order_relaxed);
+			batch_(batch, costs);
+			return;
+		}
+		costs.resize(batch.size());
+		pool.parallel_for(batch.size(), [&](const size_t i)
+		{
+			std::vector<double> vector;
+			batch.get(i, vector);
+			costs[i] = (*this)(vector);
+		});
+	}
+
+
+	size_t evaluator::evaluations() const
+	{
+		return evaluations_.load(std::memory_order_relaxed);
+	}
+
+
+	void evaluator::reset_evaluations()
+	{
+		evaluations_.store(0, std::memory_order_relaxed);
+	}
+}
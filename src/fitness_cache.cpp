@@ -0,0 +1,167 @@
+#include "clever/fitness_cache.h"
+
+#include <cstring>
+
+
+namespace clever
+{
+	namespace
+	{
+		std::uint64_t mix(std::uint64_t h)
+		{
+			// the splitmix64 finalizer
+			h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+			return h ^ (h >> 31);
+		}
+
+
+		std::uint64_t combine(const std::uint64_t h, const std::uint64_t word)
+		{
+			return (h ^ mix(word)) * 0x9e3779b97f4a7c15ULL;
+		}
+	}
+
+
+	std::uint64_t hash_genome(const bit_string& bits)
+	{
+		auto h = mix(bits.size());
+		for (size_t i = 0; i < bits.num_words(); ++i)
+		{
+			h = combine(h, bits.words()[i]);
+		}
+		return mix(h);
+	}
+
+
+	std::uint64_t hash_genome(const std::string& bits)
+	{
+		auto h = mix(bits.size());
+		size_t i = 0;
+		for (; i + sizeof(std::uint64_t) <= bits.size(); i += sizeof(std::uint64_t))
+		{
+			std::uint64_t word;
+			std::memcpy(&word, bits.data() + i, sizeof(word));
+			h = combine(h, word);
+		}
+		if (i < bits.size())
+		{
+			std::uint64_t word = 0;
+			std::memcpy(&word, bits.data() + i, bits.size() - i);
+			h = combine(h, word);
+		}
+		return mix(h);
+	}
+
+
+	template <typename Genome>
+	basic_fitness_cache<Genome>::basic_fitness_cache(const size_t capacity, const size_t num_shards)
+		: capacity_(capacity), hits_(0), misses_(0)
+	{
+		auto n = num_shards == 0 ? 1 : num_shards;
+		n = capacity != 0 && capacity < n ? capacity : n;
+		shard_capacity_ = (capacity + n - 1) / n;
+		for (size_t i = 0; i < n; ++i)
+		{
+			shards_.emplace_back(new shard);
+		}
+	}
+
+
+	template <typename Genome>
+	size_t basic_fitness_cache<Genome>::size() const
+	{
+		size_t n = 0;
+		for (const auto& s : shards_)
+		{
+			std::lock_guard<std::mutex> lock(s->mutex);
+			n += s->entries.size();
+		}
+		return n;
+	}
+
+
+	template <typename Genome>
+	bool basic_fitness_cache<Genome>::find(const Genome& genome, double& fitness)
+	{
+		const auto hash = hash_genome(genome);
+		auto& s = shard_of(hash);
+		{
+			std::lock_guard<std::mutex> lock(s.mutex);
+			const auto it = s.index.find(hash);
+			if (it != s.index.end() && s.entries[it->second].genome == genome)
+			{
+				auto& e = s.entries[it->second];
+				e.referenced = true;
+				fitness = e.fitness;
+				hits_.fetch_add(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+		misses_.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+
+	template <typename Genome>
+	void basic_fitness_cache<Genome>::insert(const Genome& genome, const double fitness)
+	{
+		if (shard_capacity_ == 0)
+		{
+			return;
+		}
+		const auto hash = hash_genome(genome);
+		auto& s = shard_of(hash);
+		std::lock_guard<std::mutex> lock(s.mutex);
+		size_t slot;
+		const auto it = s.index.find(hash);
+		if (it != s.index.end())
+		{
+			// the same genome, or one whose hash collides: either way the
+			// newer one takes the slot
+			slot = it->second;
+		}
+		else if (s.entries.size() < shard_capacity_)
+		{
+			slot = s.entries.size();
+			s.entries.emplace_back();
+			s.index[hash] = slot;
+		}
+		else
+		{
+			while (s.entries[s.hand].referenced)
+			{
+				s.entries[s.hand].referenced = false;
+				s.hand = (s.hand + 1) % s.entries.size();
+			}
+			slot = s.hand;
+			s.hand = (s.hand + 1) % s.entries.size();
+			s.index.erase(s.entries[slot].hash);
+			s.index[hash] = slot;
+		}
+		auto& e = s.entries[slot];
+		e.genome = genome;
+		e.hash = hash;
+		e.fitness = fitness;
+		e.referenced = false;
+	}
+
+
+	template <typename Genome>
+	void basic_fitness_cache<Genome>::clear()
+	{
+		for (auto& s : shards_)
+		{
+			std::lock_guard<std::mutex> lock(s->mutex);
+			s->index.clear();
+			s->entries.clear();
+			s->hand = 0;
+		}
+		hits_.store(0, std::memory_order_relaxed);
+		misses_.store(0, std::memory_order_relaxed);
+	}
+
+
+	template class basic_fitness_cache<bit_string>;
+	template class basic_fitness_cache<std::string>;
+}
@@ -0,0 +1,228 @@
+#include "clever/kd_tree.h"
+
+#include <algorithm>
+
+
+namespace clever
+{
+	kd_tree::kd_tree(const std::vector<std::vector<double>>& points)
+	{
+		build(points);
+	}
+
+
+	kd_tree::kd_tree(const double* points, const size_t count, const size_t dimensions)
+	{
+		build(points, count, dimensions);
+	}
+
+
+	void kd_tree::build(const std::vector<std::vector<double>>& points)
+	{
+		dims_ = points.empty() ? 0 : points[0].size();
+		coordinates_.resize(points.size() * dims_);
+		for (size_t i = 0; i < points.size(); ++i)
+		{
+			std::copy(points[i].begin(), points[i].end(), coordinates_.begin() + i * dims_);
+		}
+		build_nodes();
+	}
+
+
+	void kd_tree::build(const double* points, const size_t count, const size_t dimensions)
+	{
+		dims_ = dimensions;
+		coordinates_.assign(points, points + count * dimensions);
+		build_nodes();
+	}
+
+
+	void kd_tree::build_nodes()
+	{
+		const auto count = dims_ == 0 ? 0 : coordinates_.size() / dims_;
+		order_.resize(count);
+		for (size_t i = 0; i < order_.size(); ++i)
+		{
+			order_[i] = i;
+		}
+		axis_.assign(count, 0);
+		build(0, order_.size());
+	}
+
+
+	void kd_tree::build(const size_t lo, const size_t hi)
+	{
+		if (hi - lo <= 1)
+		{
+			return;
+		}
+
+		// split on the axis with the widest spread
+		size_t axis = 0;
+		double widest = -1.0;
+		for (size_t d = 0; d < dims_; ++d)
+		{
+			auto min = point(order_[lo])[d];
+			auto max = min;
+			for (size_t i = lo + 1; i < hi; ++i)
+			{
+				const auto v = point(order_[i])[d];
+				min = std::min(min, v);
+				max = std::max(max, v);
+			}
+			if (max - min > widest)
+			{
+				widest = max - min;
+				axis = d;
+			}
+		}
+
+		const auto mid = lo + (hi - lo) / 2;
+		std::nth_element(order_.begin() + lo, order_.begin() + mid, order_.begin() + hi,
+		                 [&](const size_t a, const size_t b) { return point(a)[axis] < point(b)[axis]; });
+		axis_[mid] = static_cast<std::uint32_t>(axis);
+		build(lo, mid);
+		build(mid + 1, hi);
+	}
+
+
+	double kd_tree::squared_distance(const size_t i, const double* query) const
+	{
+		const auto* p = point(i);
+		double sum = 0.0;
+		for (size_t d = 0; d < dims_; ++d)
+		{
+			sum += (p[d] - query[d]) * (p[d] - query[d]);
+		}
+		return sum;
+	}
+
+
+	void kd_tree::nearest(const double* query, const size_t k, std::vector<size_t>& indices, const size_t exclude) const
+	{
+		indices.clear();
+		if (k == 0 || order_.empty())
+		{
+			return;
+		}
+
+		// max-heap on distance holding the best k found so far
+		std::vector<heap_entry> heap;
+		heap.reserve(k + 1);
+		search(0, order_.size(), query, k, exclude, heap);
+
+		std::sort_heap(heap.begin(), heap.end(), [](const heap_entry& a, const heap_entry& b)
+		{
+			return a.distance < b.distance;
+		});
+		for (const auto& entry : heap)
+		{
+			indices.push_back(entry.index);
+		}
+	}
+
+
+	void kd_tree::search(const size_t lo, const size_t hi, const double* query, const size_t k, const size_t exclude,
+	                     std::vector<heap_entry>& heap) const
+	{
+		if (lo >= hi)
+		{
+			return;
+		}
+		const auto less = [](const heap_entry& a, const heap_entry& b) { return a.distance < b.distance; };
+
+		const auto mid = lo + (hi - lo) / 2;
+		const auto index = order_[mid];
+		if (index != exclude)
+		{
+			const auto d = squared_distance(index, query);
+			if (heap.size() < k)
+			{
+				heap.push_back({d, index});
+				std::push_heap(heap.begin(), heap.end(), less);
+			}
+			else if (d < heap.front().distance)
+			{
+				std::pop_heap(heap.begin(), heap.end(), less);
+				heap.back() = {d, index};
+				std::push_heap(heap.begin(), heap.end(), less);
+			}
+		}
+
+		const auto axis = axis_[mid];
+		const auto diff = query[axis] - point(index)[axis];
+		const auto near_lo = diff < 0.0 ? lo : mid + 1;
+		const auto near_hi = diff < 0.0 ? mid : hi;
+		const auto far_lo = diff < 0.0 ? mid + 1 : lo;
+		const auto far_hi = diff < 0.0 ? hi : mid;
+
+		search(near_lo, near_hi, query, k, exclude, heap);
+		if (heap.size() < k || diff * diff < heap.front().distance)
+		{
+			search(far_lo, far_hi, query, k, exclude, heap);
+		}
+	}
+
+
+	bool kd_tree::any_within(const double* query, const double radius, const size_t exclude) const
+	{
+		return any_within(0, order_.size(), query, radius * radius, exclude);
+	}
+
+
+	void kd_tree::within(const double* query, const double radius, std::vector<size_t>& indices) const
+	{
+		indices.clear();
+		within(0, order_.size(), query, radius * radius, indices);
+	}
+
+
+	bool kd_tree::any_within(const size_t lo, const size_t hi, const double* query, const double squared_radius,
+	                         const size_t exclude) const
+	{
+		if (lo >= hi)
+		{
+			return false;
+		}
+		const auto mid = lo + (hi - lo) / 2;
+		const auto index = order_[mid];
+		if (index != exclude && squared_distance(index, query) < squared_radius)
+		{
+			return true;
+		}
+		const auto diff = query[axis_[mid]] - point(index)[axis_[mid]];
+		// the near side first, the far side only if the ball crosses the split
+		if (diff < 0.0)
+		{
+			return any_within(lo, mid, query, squared_radius, exclude)
+				|| (diff * diff < squared_radius && any_within(mid + 1, hi, query, squared_radius, exclude));
+		}
+		return any_within(mid + 1, hi, query, squared_radius, exclude)
+			|| (diff * diff < squared_radius && any_within(lo, mid, query, squared_radius, exclude));
+	}
+
+
+	void kd_tree::within(const size_t lo, const size_t hi, const double* query, const double squared_radius,
+	                     std::vector<size_t>& indices) const
+	{
+		if (lo >= hi)
+		{
+			return;
+		}
+		const auto mid = lo + (hi - lo) / 2;
+		const auto index = order_[mid];
+		const auto diff = query[axis_[mid]] - point(index)[axis_[mid]];
+		if (diff < 0.0 || diff * diff < squared_radius)
+		{
+			within(lo, mid, query, squared_radius, indices);
+		}
+		if (squared_distance(index, query) < squared_radius)
+		{
+			indices.push_back(index);
+		}
+		if (diff >= 0.0 || diff * diff < squared_radius)
+		{
+			within(mid + 1, hi, query, squared_radius, indices);
+		}
+	}
+}
@@ -0,0 +1,37 @@
+#include "clever/migration.h"
+
+
+namespace clever
+{
+	void migration_targets(std::vector<size_t>& targets, const migration_topology topology, const size_t island,
+	                       const size_t num_islands, random_engine& rng)
+	{
+		targets.clear();
+		if (num_islands < 2)
+		{
+			return;
+		}
+		switch (topology)
+		{
+		case migration_topology::ring:
+			targets.push_back((island + 1) % num_islands);
+			break;
+		case migration_topology::fully_connected:
+			for (size_t i = 0; i < num_islands; ++i)
+			{
+				if (i != island)
+				{
+					targets.push_back(i);
+				}
+			}
+			break;
+		case migration_topology::random:
+		{
+			// uniform over the other islands
+			const auto other = random_index(num_islands - 1, rng);
+			targets.push_back(other < island ? other : other + 1);
+			break;
+		}
+		}
+	}
+}
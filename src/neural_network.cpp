@@ -0,0 +1,174 @@
+#include "clever/neural_network.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace clever
+{
+	namespace
+	{
+		// columns of a batch whose gradient one task computes
+		const size_t run_columns = 128;
+
+
+		// sigmoid(weights * input + bias), one column per sample
+		template <typename Input>
+		void activate(const Eigen::MatrixXd& weights, const Eigen::VectorXd& bias, const Input& input,
+		              Eigen::MatrixXd& output)
+		{
+			output.noalias() = weights * input;
+			output.colwise() += bias;
+			output = (1.0 + (-output.array()).exp()).inverse().matrix();
+		}
+
+
+		// delta * sigmoid'(output), with the derivative written in the output
+		void scale_by_derivative(Eigen::MatrixXd& delta, const Eigen::MatrixXd& output)
+		{
+			delta.array() *= output.array() * (1.0 - output.array());
+		}
+	}
+
+
+	neural_network::neural_network(const std::vector<size_t>& sizes, random_engine& rng)
+	{
+		for (size_t l = 0; l + 1 < sizes.size(); ++l)
+		{
+			const auto range = 1.0 / std::sqrt(static_cast<double>(sizes[l]));
+			Eigen::MatrixXd weights(sizes[l + 1], sizes[l]);
+			Eigen::VectorXd bias(sizes[l + 1]);
+			for (Eigen::Index j = 0; j < weights.cols(); ++j)
+			{
+				for (Eigen::Index i = 0; i < weights.rows(); ++i)
+				{
+					weights(i, j) = rng.uniform(-range, range);
+				}
+			}
+			for (Eigen::Index i = 0; i < bias.size(); ++i)
+			{
+				bias(i) = rng.uniform(-range, range);
+			}
+			weights_.push_back(weights);
+			biases_.push_back(bias);
+		}
+		zero_like(last_step_);
+	}
+
+
+	void neural_network::forward(const Eigen::Ref<const Eigen::MatrixXd>& input, Eigen::MatrixXd& output) const
+	{
+		if (weights_.empty())
+		{
+			output = input;
+			return;
+		}
+		activate(weights_[0], biases_[0], input, output);
+		Eigen::MatrixXd next;
+		for (size_t l = 1; l < layers(); ++l)
+		{
+			activate(weights_[l], biases_[l], output, next);
+			output.swap(next);
+		}
+	}
+
+
+	double neural_network::gradient(const Eigen::Ref<const Eigen::MatrixXd>& input,
+	                                const Eigen::Ref<const Eigen::MatrixXd>& target, network_gradient& grad) const
+	{
+		const auto num_layers = layers();
+		grad.weights.resize(num_layers);
+		grad.biases.resize(num_layers);
+		if (num_layers == 0)
+		{
+			return 0.0;
+		}
+
+		std::vector<Eigen::MatrixXd> outputs(num_layers);
+		activate(weights_[0], biases_[0], input, outputs[0]);
+		for (size_t l = 1; l < num_layers; ++l)
+		{
+			activate(weights_[l], biases_[l], outputs[l - 1], outputs[l]);
+		}
+
+		Eigen::MatrixXd delta = target - outputs.back();
+		const auto error = delta.squaredNorm();
+		scale_by_derivative(delta, outputs.back());
+		Eigen::MatrixXd previous;
+		for (size_t l = num_layers; l-- > 0;)
+		{
+			if (l == 0)
+			{
+				grad.weights[0].noalias() = delta * input.transpose();
+			}
+			else
+			{
+				grad.weights[l].noalias() = delta * outputs[l - 1].transpose();
+			}
+			grad.biases[l] = delta.rowwise().sum();
+			if (l > 0)
+			{
+				previous.noalias() = weights_[l].transpose() * delta;
+				scale_by_derivative(previous, outputs[l - 1]);
+				delta.swap(previous);
+			}
+		}
+		return error;
+	}
+
+
+	double neural_network::train_epoch(const Eigen::MatrixXd& inputs, const Eigen::MatrixXd& targets,
+	                                   const size_t batch_size, const double learning_rate, const double momentum,
+	                                   thread_pool& pool)
+	{
+		const auto n = static_cast<size_t>(inputs.cols());
+		const auto size = batch_size == 0 ? n : batch_size;
+		std::vector<network_gradient> parts;
+		std::vector<double> errors;
+		double total = 0.0;
+		for (size_t start = 0; start < n; start += size)
+		{
+			const auto columns = std::min(size, n - start);
+			const auto runs = (columns + run_columns - 1) / run_columns;
+			parts.resize(std::max(parts.size(), runs));
+			errors.assign(runs, 0.0);
+			pool.parallel_for(runs, [&](const size_t r)
+			{
+				const auto first = start + r * run_columns;
+				const auto count = std::min(run_columns, start + columns - first);
+				errors[r] = gradient(inputs.middleCols(first, count), targets.middleCols(first, count), parts[r]);
+			});
+
+			const auto rate = learning_rate / static_cast<double>(columns);
+			for (size_t l = 0; l < layers(); ++l)
+			{
+				last_step_.weights[l] *= momentum;
+				last_step_.biases[l] *= momentum;
+				for (size_t r = 0; r < runs; ++r)
+				{
+					last_step_.weights[l] += rate * parts[r].weights[l];
+					last_step_.biases[l] += rate * parts[r].biases[l];
+				}
+				weights_[l] += last_step_.weights[l];
+				biases_[l] += last_step_.biases[l];
+			}
+			for (const auto e : errors)
+			{
+				total += e;
+			}
+		}
+		return n == 0 ? 0.0 : total / static_cast<double>(n * outputs());
+	}
+
+
+	void neural_network::zero_like(network_gradient& grad) const
+	{
+		grad.weights.resize(layers());
+		grad.biases.resize(layers());
+		for (size_t l = 0; l < layers(); ++l)
+		{
+			grad.weights[l].setZero(weights_[l].rows(), weights_[l].cols());
+			grad.biases[l].setZero(biases_[l].size());
+		}
+	}
+}
@@ -0,0 +1,149 @@
+#include "clever/perceptron.h"
+
+#include <algorithm>
+
+#include "clever/vector_math.h"
+
+
+namespace clever
+{
+	namespace
+	{
+		// rows one task of a parallel loop takes
+		const size_t run_rows = 256;
+	}
+
+
+	perceptron::perceptron(const size_t num_inputs, random_engine& rng)
+		: weights_(num_inputs + 1), weighted_(num_inputs + 1, 0.0)
+	{
+		rng.fill_uniform(weights_.data(), weights_.size(), -1.0, 1.0);
+	}
+
+
+	double perceptron::activate(const double* input) const
+	{
+		return dot(weights_.data(), input, inputs()) + weights_.back();
+	}
+
+
+	size_t perceptron::train_epoch(const dataset_view& data, const double l_rate, const size_t batch_size,
+	                               thread_pool& pool)
+	{
+		const auto n = inputs();
+		size_t errors = 0;
+		if (batch_size <= 1)
+		{
+			for (size_t i = 0; i < data.rows(); ++i)
+			{
+				const auto row = data.row(i);
+				const auto error = row[n] - output(row);
+				if (error != 0.0)
+				{
+					++errors;
+					add_row(row, l_rate * error, weights_);
+					add_row(row, steps_ * l_rate * error, weighted_);
+				}
+				steps_ += 1.0;
+			}
+			return errors;
+		}
+
+		std::vector<std::vector<double>> steps;
+		std::vector<size_t> run_errors;
+		for (size_t start = 0; start < data.rows(); start += batch_size)
+		{
+			const auto rows = std::min(batch_size, data.rows() - start);
+			const auto runs = (rows + run_rows - 1) / run_rows;
+			steps.resize(std::max(steps.size(), runs));
+			run_errors.assign(runs, 0);
+			pool.parallel_for(runs, [&](const size_t r)
+			{
+				auto& step = steps[r];
+				step.assign(n + 1, 0.0);
+				const auto first = start + r * run_rows;
+				const auto last = std::min(first + run_rows, start + rows);
+				for (size_t i = first; i < last; ++i)
+				{
+					const auto row = data.row(i);
+					const auto error = row[n] - output(row);
+					if (error != 0.0)
+					{
+						++run_errors[r];
+						add_row(row, l_rate * error, step);
+					}
+				}
+			});
+			// summed in run order whatever the thread count
+			auto& step = steps[0];
+			errors += run_errors[0];
+			for (size_t r = 1; r < runs; ++r)
+			{
+				errors += run_errors[r];
+				axpy(1.0, steps[r].data(), step.data(), n + 1);
+			}
+			axpy(1.0, step.data(), weights_.data(), n + 1);
+			axpy(steps_, step.data(), weighted_.data(), n + 1);
+			steps_ += 1.0;
+		}
+		return errors;
+	}
+
+
+	void perceptron::averaged(std::vector<double>& weights) const
+	{
+		weights.resize(weights_.size());
+		for (size_t i = 0; i < weights_.size(); ++i)
+		{
+			weights[i] = weights_[i] - weighted_[i] / steps_;
+		}
+	}
+
+
+	void perceptron::use_averaged()
+	{
+		averaged(weights_);
+		std::fill(weighted_.begin(), weighted_.end(), 0.0);
+		steps_ = 1.0;
+	}
+
+
+	void perceptron::classify(const dataset_view& data, std::vector<double>& outputs, thread_pool& pool) const
+	{
+		outputs.resize(data.rows());
+		pool.parallel_for(data.rows(), [&](const size_t i)
+		{
+			outputs[i] = output(data.row(i));
+		}, run_rows);
+	}
+
+
+	size_t perceptron::test(const dataset_view& data, thread_pool& pool) const
+	{
+		const auto n = inputs();
+		const auto runs = (data.rows() + run_rows - 1) / run_rows;
+		std::vector<size_t> correct(runs, 0);
+		pool.parallel_for(runs, [&](const size_t r)
+		{
+			const auto last = std::min((r + 1) * run_rows, data.rows());
+			for (size_t i = r * run_rows; i < last; ++i)
+			{
+				const auto row = data.row(i);
+				correct[r] += output(row) == row[n] ? 1 : 0;
+			}
+		});
+		size_t total = 0;
+		for (const auto c : correct)
+		{
+			total += c;
+		}
+		return total;
+	}
+
+
+	void perceptron::add_row(const double* row, const double scale, std::vector<double>& weights) const
+	{
+		axpy(scale, row, weights.data(), inputs());
+		weights.back() += scale;
+	}
+}
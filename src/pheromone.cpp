@@ -0,0 +1,191 @@
+#include "clever/pheromone.h"
+
+#if !defined(__GNUC__)
+#include <mutex>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CLEVER_PHEROMONE_SSE2
+#endif
+
+
+namespace clever
+{
+	namespace
+	{
+		// values is cache-line aligned, so the packed loop uses aligned loads
+		void scale(double* values, const size_t count, const double factor)
+		{
+			size_t i = 0;
+#ifdef CLEVER_PHEROMONE_SSE2
+			const auto f = _mm_set1_pd(factor);
+			for (; i + 4 <= count; i += 4)
+			{
+				_mm_store_pd(values + i, _mm_mul_pd(_mm_load_pd(values + i), f));
+				_mm_store_pd(values + i + 2, _mm_mul_pd(_mm_load_pd(values + i + 2), f));
+			}
+#endif
+			for (; i < count; ++i)
+			{
+				values[i] *= factor;
+			}
+		}
+
+
+		void scale(float* values, const size_t count, const double factor)
+		{
+			size_t i = 0;
+#ifdef CLEVER_PHEROMONE_SSE2
+			const auto f = _mm_set1_ps(static_cast<float>(factor));
+			for (; i + 8 <= count; i += 8)
+			{
+				_mm_store_ps(values + i, _mm_mul_ps(_mm_load_ps(values + i), f));
+				_mm_store_ps(values + i + 4, _mm_mul_ps(_mm_load_ps(values + i + 4), f));
+			}
+#endif
+			for (; i < count; ++i)
+			{
+				values[i] = static_cast<float>(values[i] * factor);
+			}
+		}
+
+
+#if !defined(__GNUC__)
+		// without the GCC atomic builtins edges are guarded by striped locks
+		std::mutex& edge_lock(const void* cell)
+		{
+			static std::mutex locks[64];
+			return locks[(reinterpret_cast<size_t>(cell) / sizeof(double)) % 64];
+		}
+#endif
+	}
+
+
+	template <typename T>
+	basic_pheromone_matrix<T>::basic_pheromone_matrix(const size_t size, const T initial, const pheromone_layout layout)
+	{
+		reset(size, initial, layout);
+	}
+
+
+	template <typename T>
+	void basic_pheromone_matrix<T>::reset(const size_t size, const T initial, const pheromone_layout layout)
+	{
+		size_ = size;
+		layout_ = layout;
+		if (layout_ == pheromone_layout::full)
+		{
+			const auto per_line = cache_line_size / sizeof(T);
+			stride_ = (size_ + per_line - 1) / per_line * per_line;
+			values_.assign(size_ * stride_, initial);
+		}
+		else
+		{
+			stride_ = 0;
+			values_.assign(size_ * (size_ + 1) / 2, initial);
+		}
+	}
+
+
+	template <typename T>
+	void basic_pheromone_matrix<T>::fill(const T value)
+	{
+		std::fill(values_.begin(), values_.end(), value);
+	}
+
+
+	template <typename T>
+	void basic_pheromone_matrix<T>::evaporate(const double rate)
+	{
+		// row padding is scaled too, which keeps the loop a single sweep
+		scale(values_.data(), values_.size(), 1.0 - rate);
+	}
+
+
+	template <typename T>
+	void basic_pheromone_matrix<T>::deposit(const std::vector<size_t>& tour, const double amount)
+	{
+		update(tour, 1.0, amount);
+	}
+
+
+	template <typename T>
+	void basic_pheromone_matrix<T>::update(const std::vector<size_t>& tour, const double keep, const double add)
+	{
+		for (size_t i = 0; i < tour.size(); ++i)
+		{
+			const auto next = i == tour.size() - 1 ? tour[0] : tour[i + 1];
+			update(tour[i], next, keep, add);
+		}
+	}
+
+
+	template <typename T>
+	T basic_pheromone_matrix<T>::load(const size_t i, const size_t j) const
+	{
+		const auto* cell = &values_[index(std::min(i, j), std::max(i, j))];
+#if defined(__GNUC__)
+		T value;
+		__atomic_load(cell, &value, __ATOMIC_RELAXED);
+		return value;
+#else
+		std::lock_guard<std::mutex> lock(edge_lock(cell));
+		return *cell;
+#endif
+	}
+
+
+	template <typename T>
+	void basic_pheromone_matrix<T>::update_atomic(const size_t i, const size_t j, const double keep, const double add)
+	{
+		const auto lo = std::min(i, j);
+		const auto hi = std::max(i, j);
+		auto* cell = &values_[index(lo, hi)];
+#if defined(__GNUC__)
+		T expected;
+		__atomic_load(cell, &expected, __ATOMIC_RELAXED);
+		T desired;
+		do
+		{
+			desired = static_cast<T>(keep * expected + add);
+		}
+		while (!__atomic_compare_exchange(cell, &expected, &desired, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+#else
+		std::lock_guard<std::mutex> lock(edge_lock(cell));
+		*cell = static_cast<T>(keep * *cell + add);
+#endif
+	}
+
+
+	template <typename T>
+	void basic_pheromone_matrix<T>::update_atomic(const std::vector<size_t>& tour, const double keep, const double add)
+	{
+		for (size_t i = 0; i < tour.size(); ++i)
+		{
+			const auto next = i == tour.size() - 1 ? tour[0] : tour[i + 1];
+			update_atomic(tour[i], next, keep, add);
+		}
+	}
+
+
+	template <typename T>
+	void basic_pheromone_matrix<T>::sync_mirror()
+	{
+		if (layout_ != pheromone_layout::full)
+		{
+			return;
+		}
+		for (size_t i = 1; i < size_; ++i)
+		{
+			for (size_t j = 0; j < i; ++j)
+			{
+				values_[index(i, j)] = values_[index(j, i)];
+			}
+		}
+	}
+
+
+	template class basic_pheromone_matrix<double>;
+	template class basic_pheromone_matrix<float>;
+}
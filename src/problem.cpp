@@ -0,0 +1,92 @@
+#include "clever/problem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+
+namespace clever
+{
+	void make_bounds(search_bounds& bounds, const size_t problem_size, const double min, const double max)
+	{
+		bounds.assign(problem_size, std::vector<double>{min, max});
+	}
+
+
+	double rand_in_bounds(const double min, const double max, random_engine& rng)
+	{
+		return rng.uniform(min, max);
+	}
+
+
+	void random_vector(std::vector<double>& vector, const search_bounds& minmax, random_engine& rng)
+	{
+		vector.resize(minmax.size());
+		for (size_t i = 0; i < minmax.size(); ++i)
+		{
+			vector[i] = rand_in_bounds(minmax[i][0], minmax[i][1], rng);
+		}
+	}
+
+
+	double euclidean_distance(const std::vector<double>& x, const std::vector<double>& y)
+	{
+		double sum = 0.0;
+		for (size_t i = 0; i < x.size(); ++i)
+		{
+			sum += (x[i] - y[i]) * (x[i] - y[i]);
+		}
+		return std::sqrt(sum);
+	}
+
+
+	void clamp_to_bounds(std::vector<double>& vector, const search_bounds& minmax)
+	{
+		for (size_t i = 0; i < vector.size(); ++i)
+		{
+			if (vector[i] < minmax[i][0])
+			{
+				vector[i] = minmax[i][0];
+			}
+			if (vector[i] > minmax[i][1])
+			{
+				vector[i] = minmax[i][1];
+			}
+		}
+	}
+
+
+	void random_batch(candidate_batch& batch, const search_bounds& minmax, random_engine& rng)
+	{
+		for (size_t d = 0; d < batch.dimensions(); ++d)
+		{
+			rng.fill_uniform(batch.dimension(d), batch.size(), minmax[d][0], minmax[d][1]);
+		}
+	}
+
+
+	void clamp_to_bounds(candidate_batch& batch, const search_bounds& minmax)
+	{
+		for (size_t d = 0; d < batch.dimensions(); ++d)
+		{
+			const auto min = minmax[d][0];
+			const auto max = minmax[d][1];
+			auto row = batch.dimension(d);
+			for (size_t i = 0; i < batch.size(); ++i)
+			{
+				row[i] = std::min(std::max(row[i], min), max);
+			}
+		}
+	}
+
+
+	void order_by_cost(std::vector<size_t>& order, const std::vector<double>& costs)
+	{
+		order.resize(costs.size());
+		std::iota(order.begin(), order.end(), size_t(0));
+		std::stable_sort(order.begin(), order.end(), [&](const size_t a, const size_t b)
+		{
+			return costs[a] < costs[b];
+		});
+	}
+}
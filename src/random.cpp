@@ -0,0 +1,244 @@
+#include "clever/random.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <thread>
+
+
+namespace clever
+{
+	namespace
+	{
+		std::uint64_t splitmix64(std::uint64_t& x)
+		{
+			auto z = (x += 0x9e3779b97f4a7c15ULL);
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+			return z ^ (z >> 31);
+		}
+
+
+		std::uint64_t device_seed()
+		{
+			std::random_device rd;
+			return (static_cast<std::uint64_t>(rd()) << 32) ^ rd();
+		}
+
+
+		std::uint64_t family_seed()
+		{
+			static const std::uint64_t seed = []()
+			{
+				const char* value = std::getenv("CLEVER_SEED");
+				return value != nullptr ? static_cast<std::uint64_t>(std::strtoull(value, nullptr, 10)) : device_seed();
+			}();
+			return seed;
+		}
+
+
+		// the thread that loads the library, normally the one running main,
+		// takes stream 0; other threads are numbered in the order they first
+		// draw
+		const std::thread::id main_thread = std::this_thread::get_id();
+		std::atomic<std::uint64_t> next_thread_stream(1);
+
+
+		std::uint64_t thread_stream()
+		{
+			return std::this_thread::get_id() == main_thread ? 0 : next_thread_stream.fetch_add(1);
+		}
+	}
+
+
+	random_engine::random_engine()
+	{
+		seed(device_seed());
+	}
+
+
+	random_engine::random_engine(const std::uint64_t seed)
+	{
+		this->seed(seed);
+	}
+
+
+	random_engine::random_engine(const std::uint64_t seed, std::uint64_t stream)
+	{
+		this->seed(seed ^ splitmix64(stream));
+	}
+
+
+	void random_engine::seed(std::uint64_t seed)
+	{
+		for (auto& word : state_)
+		{
+			word = splitmix64(seed);
+		}
+		has_spare_ = false;
+	}
+
+
+	void random_engine::jump()
+	{
+		static const std::uint64_t polynomial[] = {
+			0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+		};
+
+		std::uint64_t s[4] = {0, 0, 0, 0};
+		for (const auto word : polynomial)
+		{
+			for (int b = 0; b < 64; ++b)
+			{
+				if (word & (std::uint64_t(1) << b))
+				{
+					for (int i = 0; i < 4; ++i)
+					{
+						s[i] ^= state_[i];
+					}
+				}
+				next();
+			}
+		}
+		for (int i = 0; i < 4; ++i)
+		{
+			state_[i] = s[i];
+		}
+		has_spare_ = false;
+	}
+
+
+	size_t random_engine::index(const size_t n)
+	{
+		if (n <= 1)
+		{
+			return 0;
+		}
+		const auto i = static_cast<size_t>(uniform() * n);
+		return i < n ? i : n - 1;
+	}
+
+
+	void random_engine::polar_pair(double& z0, double& z1)
+	{
+		double u1, u2, w;
+		do
+		{
+			u1 = 2.0 * uniform() - 1.0;
+			u2 = 2.0 * uniform() - 1.0;
+			w = u1 * u1 + u2 * u2;
+		}
+		while (w >= 1.0 || w == 0.0);
+		w = std::sqrt((-2.0 * std::log(w)) / w);
+
+		z0 = u2 * w;
+		z1 = u1 * w;
+	}
+
+
+	double random_engine::gaussian(const double mean, const double stdev)
+	{
+		if (has_spare_)
+		{
+			has_spare_ = false;
+			return mean + spare_ * stdev;
+		}
+		double z;
+		polar_pair(z, spare_);
+		has_spare_ = true;
+		return mean + z * stdev;
+	}
+
+
+	void random_engine::fill_uniform(double* values, const size_t n)
+	{
+		for (size_t i = 0; i < n; ++i)
+		{
+			values[i] = uniform();
+		}
+	}
+
+
+	void random_engine::fill_uniform(double* values, const size_t n, const double min, const double max)
+	{
+		const auto range = max - min;
+		for (size_t i = 0; i < n; ++i)
+		{
+			values[i] = min + range * uniform();
+		}
+	}
+
+
+	void random_engine::fill_gaussian(double* values, const size_t n, const double mean, const double stdev)
+	{
+		size_t i = 0;
+		if (has_spare_ && n > 0)
+		{
+			has_spare_ = false;
+			values[i++] = mean + spare_ * stdev;
+		}
+		for (; i + 1 < n; i += 2)
+		{
+			double z0, z1;
+			polar_pair(z0, z1);
+			values[i] = mean + z0 * stdev;
+			values[i + 1] = mean + z1 * stdev;
+		}
+		if (i < n)
+		{
+			values[i] = gaussian(mean, stdev);
+		}
+	}
+
+
+	std::vector<random_engine> make_streams(const std::uint64_t seed, const size_t count)
+	{
+		std::vector<random_engine> streams;
+		streams.reserve(count);
+		random_engine engine(seed);
+		for (size_t i = 0; i < count; ++i)
+		{
+			streams.push_back(engine);
+			engine.jump();
+		}
+		return streams;
+	}
+
+
+	random_engine& default_engine()
+	{
+		thread_local random_engine engine(family_seed(), thread_stream());
+		return engine;
+	}
+
+
+	void seed_default_engine(const std::uint64_t seed)
+	{
+		default_engine().seed(seed);
+	}
+
+
+	double random_uniform(random_engine& rng)
+	{
+		return rng.uniform();
+	}
+
+
+	double random_uniform(const double min, const double max, random_engine& rng)
+	{
+		return rng.uniform(min, max);
+	}
+
+
+	size_t random_index(const size_t n, random_engine& rng)
+	{
+		return rng.index(n);
+	}
+
+
+	double random_gaussian(const double mean, const double stdev, random_engine& rng)
+	{
+		return rng.gaussian(mean, stdev);
+	}
+}
@@ -0,0 +1,104 @@
+#include "clever/swarm.h"
+
+#include <algorithm>
+#include <cfloat>
+
+#include "clever/batch_functions.h"
+#include "batch_kernels.h"
+
+
+namespace clever
+{
+	void create_swarm(swarm_state& swarm, const size_t size, const search_bounds& search_space,
+	                  const search_bounds& velocity_space, random_engine& rng)
+	{
+		swarm.position.resize(size, search_space.size());
+		swarm.velocity.resize(size, search_space.size());
+		random_batch(swarm.position, search_space, rng);
+		random_batch(swarm.velocity, velocity_space, rng);
+		swarm.b_position = swarm.position;
+		swarm.cost.assign(size, DBL_MAX);
+		swarm.b_cost.assign(size, DBL_MAX);
+		swarm.improved.assign(swarm.position.stride(), 0.0);
+		swarm.r1.resize(swarm.position.stride() * search_space.size());
+		swarm.r2.resize(swarm.position.stride() * search_space.size());
+		swarm.lower.resize(search_space.size());
+		swarm.upper.resize(search_space.size());
+		for (size_t d = 0; d < search_space.size(); ++d)
+		{
+			swarm.lower[d] = search_space[d][0];
+			swarm.upper[d] = search_space[d][1];
+		}
+	}
+
+
+	size_t update_personal_best(swarm_state& swarm)
+	{
+		size_t best = 0;
+		for (size_t i = 0; i < swarm.cost.size(); ++i)
+		{
+			const auto improved = swarm.cost[i] < swarm.b_cost[i];
+			swarm.improved[i] = improved ? 1.0 : 0.0;
+			swarm.b_cost[i] = improved ? swarm.cost[i] : swarm.b_cost[i];
+			best = swarm.cost[i] < swarm.cost[best] ? i : best;
+		}
+		return best;
+	}
+
+
+	void move_swarm(swarm_state& swarm, const std::vector<double>& g_best, const double max_velocity,
+	                const double c1, const double c2, random_engine& rng)
+	{
+		// the same draws at every simd_level, padding included
+		rng.fill_uniform(swarm.r1.data(), swarm.r1.size());
+		rng.fill_uniform(swarm.r2.data(), swarm.r2.size());
+
+		batch::swarm_arguments a;
+		a.position = swarm.position.dimension(0);
+		a.velocity = swarm.velocity.dimension(0);
+		a.b_position = swarm.b_position.dimension(0);
+		a.improved = swarm.improved.data();
+		a.r1 = swarm.r1.data();
+		a.r2 = swarm.r2.data();
+		a.g_best = g_best.data();
+		a.lower = swarm.lower.data();
+		a.upper = swarm.upper.data();
+		a.count = swarm.position.stride();
+		a.dimensions = swarm.position.dimensions();
+		a.stride = swarm.position.stride();
+		a.max_velocity = max_velocity;
+		a.c1 = c1;
+		a.c2 = c2;
+		switch (active_simd_level())
+		{
+#ifdef CLEVER_BATCH_X86
+		case simd_level::avx512:
+			batch::move_swarm_avx512(a);
+			break;
+		case simd_level::avx2:
+			batch::move_swarm_avx2(a);
+			break;
+#endif
+		default:
+			a.count = swarm.position.size();
+			batch::move_swarm_scalar(a);
+			break;
+		}
+		std::fill(swarm.improved.begin(), swarm.improved.end(), 0.0);
+	}
+
+
+	void commit_personal_best(swarm_state& swarm)
+	{
+		for (size_t d = 0; d < swarm.position.dimensions(); ++d)
+		{
+			const auto position = swarm.position.dimension(d);
+			const auto b_position = swarm.b_position.dimension(d);
+			for (size_t i = 0; i < swarm.position.size(); ++i)
+			{
+				b_position[i] = swarm.improved[i] != 0.0 ? position[i] : b_position[i];
+			}
+		}
+		std::fill(swarm.improved.begin(), swarm.improved.end(), 0.0);
+	}
+}
@@ -0,0 +1,131 @@
+#include "clever/ternary.h"
+
+
+namespace clever
+{
+	void make_condition(ternary_condition& condition, const std::string& text)
+	{
+		condition.care = bit_string(text.size());
+		condition.value = bit_string(text.size());
+		for (size_t i = 0; i < text.size(); ++i)
+		{
+			set_symbol(condition, i, text[i]);
+		}
+	}
+
+
+	std::string to_string(const ternary_condition& condition)
+	{
+		std::string text(condition.size(), '#');
+		for (size_t i = 0; i < condition.size(); ++i)
+		{
+			text[i] = symbol(condition, i);
+		}
+		return text;
+	}
+
+
+	char symbol(const ternary_condition& condition, const size_t i)
+	{
+		if (!condition.care[i])
+		{
+			return '#';
+		}
+		return condition.value[i] ? '1' : '0';
+	}
+
+
+	void set_symbol(ternary_condition& condition, const size_t i, const char symbol)
+	{
+		condition.care.set(i, symbol != '#');
+		condition.value.set(i, symbol == '1');
+	}
+
+
+	bool matches(const ternary_condition& condition, const bit_string& input)
+	{
+		const auto care = condition.care.words();
+		const auto value = condition.value.words();
+		const auto bits = input.words();
+		for (size_t w = 0; w < input.num_words(); ++w)
+		{
+			if ((care[w] & (bits[w] ^ value[w])) != 0)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+
+	bool subsumes(const ternary_condition& general, const ternary_condition& specific)
+	{
+		for (size_t w = 0; w < general.care.num_words(); ++w)
+		{
+			const auto care = general.care.words()[w];
+			// general may only care where specific does, and must agree there
+			if ((care & ~specific.care.words()[w]) != 0
+				|| (care & (general.value.words()[w] ^ specific.value.words()[w])) != 0)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+
+	match_index::match_index(const size_t length)
+		: length_(length), columns_(2 * length)
+	{
+	}
+
+
+	void match_index::insert(const size_t slot, const ternary_condition& condition)
+	{
+		if (slot >= used_.size())
+		{
+			used_.resize(slot + 1);
+			for (auto& column : columns_)
+			{
+				column.resize(slot + 1);
+			}
+		}
+		used_.set(slot, true);
+		for (size_t i = 0; i < length_; ++i)
+		{
+			const bool care = condition.care[i];
+			const bool value = condition.value[i];
+			columns_[2 * i].set(slot, !care || !value);
+			columns_[2 * i + 1].set(slot, !care || value);
+		}
+	}
+
+
+	void match_index::erase(const size_t slot)
+	{
+		used_.set(slot, false);
+	}
+
+
+	void match_index::match(const bit_string& input, std::vector<size_t>& slots) const
+	{
+		slots.clear();
+		std::vector<bit_string::word_type> found(used_.words(), used_.words() + used_.num_words());
+		for (size_t i = 0; i < length_; ++i)
+		{
+			const auto column = columns_[2 * i + (input[i] ? 1 : 0)].words();
+			for (size_t w = 0; w < found.size(); ++w)
+			{
+				found[w] &= column[w];
+			}
+		}
+		for (size_t w = 0; w < found.size(); ++w)
+		{
+			for (auto word = found[w]; word != 0; word &= word - 1)
+			{
+				// index of the lowest set bit
+				slots.push_back(w * bit_string::word_bits + popcount((word & (~word + 1)) - 1));
+			}
+		}
+	}
+}
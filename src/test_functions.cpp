@@ -0,0 +1,312 @@
+#define _USE_MATH_DEFINES
+
+#include "clever/test_functions.h"
+#include <cmath>
+
+
+namespace clever
+{
+	double sphere_function(const std::vector<double>& x)
+	{
+		double sum = 0.0;
+		for (const double xi : x)
+		{
+			sum += xi * xi;
+		}
+		return sum;
+	}
+
+
+	double ackley_function(const std::vector<double>& x)
+	{
+		const double a = 20;
+		const double b = 0.2;
+		const double c = 2.0 * M_PI;
+
+		double sum0 = 0.0;
+		double sum1 = 0.0;
+		for (const double xi : x)
+		{
+			sum0 += xi * xi;
+			sum1 += cos(c * xi);
+		}
+		sum0 /= x.size();
+		sum1 /= x.size();
+		const double term0 = -a * exp(-b * sqrt(sum0));
+		const double term1 = -exp(sum1);
+
+		const double y = term0 + term1 + a + exp(1);
+
+		return y;
+	}
+
+
+	double rastrigin_function(const std::vector<double>& x)
+	{
+		double sum = 10.0 * x.size();
+		for (const double xi : x)
+		{
+			sum += xi * xi - 10.0 * cos(2.0 * M_PI * xi);
+		}
+		return sum;
+	}
+
+
+	double rosenbrock_function(const std::vector<double>& x)
+	{
+		double sum = 0.0;
+		for (size_t i = 0; i + 1 < x.size(); ++i)
+		{
+			const double a = x[i + 1] - x[i] * x[i];
+			const double b = x[i] - 1.0;
+			sum += 100.0 * a * a + b * b;
+		}
+		return sum;
+	}
+
+
+	double griewank_function(const std::vector<double>& x)
+	{
+		double sum = 0.0;
+		double product = 1.0;
+		for (size_t i = 0; i < x.size(); ++i)
+		{
+			sum += x[i] * x[i] / 4000.0;
+			product *= cos(x[i] / sqrt(i + 1.0));
+		}
+		return sum - product + 1.0;
+	}
+
+
+	double schwefel_function(const std::vector<double>& x)
+	{
+		double sum = 418.9829 * x.size();
+		for (const double xi : x)
+		{
+			sum -= xi * sin(sqrt(fabs(xi)));
+		}
+		return sum;
+	}
+
+
+	double sum_of_different_powers_function(const std::vector<double>& x)
+	{
+		double sum = 0.0;
+		for (size_t i = 0; i < x.size(); ++i)
+		{
+			sum += pow(fabs(x[i]), i + 2.0);
+		}
+		return sum;
+	}
+
+
+	double sum_squares_function(const std::vector<double>& x)
+	{
+		double sum = 0.0;
+		for (size_t i = 0; i < x.size(); ++i)
+		{
+			sum += (i + 1.0) * x[i] * x[i];
+		}
+		return sum;
+	}
+
+
+	double rotated_hyper_ellipsoid_function(const std::vector<double>& x)
+	{
+		double sum = 0.0;
+		double prefix = 0.0;
+		for (const double xi : x)
+		{
+			prefix += xi * xi;
+			sum += prefix;
+		}
+		return sum;
+	}
+
+
+	double dixon_price_function(const std::vector<double>& x)
+	{
+		if (x.empty())
+		{
+			return 0.0;
+		}
+		double sum = (x[0] - 1.0) * (x[0] - 1.0);
+		for (size_t i = 1; i < x.size(); ++i)
+		{
+			const double a = 2.0 * x[i] * x[i] - x[i - 1];
+			sum += (i + 1.0) * a * a;
+		}
+		return sum;
+	}
+
+
+	double levy_function(const std::vector<double>& x)
+	{
+		if (x.empty())
+		{
+			return 0.0;
+		}
+		const auto w = [&](const size_t i) { return 1.0 + (x[i] - 1.0) / 4.0; };
+		const auto first = sin(M_PI * w(0));
+		double sum = first * first;
+		for (size_t i = 0; i + 1 < x.size(); ++i)
+		{
+			const auto s = sin(M_PI * w(i) + 1.0);
+			sum += (w(i) - 1.0) * (w(i) - 1.0) * (1.0 + 10.0 * s * s);
+		}
+		const auto last = w(x.size() - 1);
+		const auto s = sin(2.0 * M_PI * last);
+		return sum + (last - 1.0) * (last - 1.0) * (1.0 + s * s);
+	}
+
+
+	double beale_function(const std::vector<double>& x)
+	{
+		const double a = 1.5 - x[0] + x[0] * x[1];
+		const double b = 2.25 - x[0] + x[0] * x[1] * x[1];
+		const double c = 2.625 - x[0] + x[0] * x[1] * x[1] * x[1];
+		return a * a + b * b + c * c;
+	}
+
+
+	double booth_function(const std::vector<double>& x)
+	{
+		const double a = x[0] + 2.0 * x[1] - 7.0;
+		const double b = 2.0 * x[0] + x[1] - 5.0;
+		return a * a + b * b;
+	}
+
+
+	double branin_function(const std::vector<double>& x)
+	{
+		const double b = 5.1 / (4.0 * M_PI * M_PI);
+		const double c = 5.0 / M_PI;
+		const double t = 1.0 / (8.0 * M_PI);
+		const double a = x[1] - b * x[0] * x[0] + c * x[0] - 6.0;
+		return a * a + 10.0 * (1.0 - t) * cos(x[0]) + 10.0;
+	}
+
+
+	double bukin_function(const std::vector<double>& x)
+	{
+		return 100.0 * sqrt(fabs(x[1] - 0.01 * x[0] * x[0])) + 0.01 * fabs(x[0] + 10.0);
+	}
+
+
+	double holder_table_function(const std::vector<double>& x)
+	{
+		const double r = sqrt(x[0] * x[0] + x[1] * x[1]);
+		return -fabs(sin(x[0]) * cos(x[1]) * exp(fabs(1.0 - r / M_PI)));
+	}
+
+
+	double cross_in_tray_function(const std::vector<double>& x)
+	{
+		const double r = sqrt(x[0] * x[0] + x[1] * x[1]);
+		const double a = fabs(sin(x[0]) * sin(x[1]) * exp(fabs(100.0 - r / M_PI)));
+		return -0.0001 * pow(a + 1.0, 0.1);
+	}
+
+
+	double matyas_function(const std::vector<double>& x)
+	{
+		return 0.26 * (x[0] * x[0] + x[1] * x[1]) - 0.48 * x[0] * x[1];
+	}
+
+
+	double easom_function(const std::vector<double>& x)
+	{
+		const double a = x[0] - M_PI;
+		const double b = x[1] - M_PI;
+		return -cos(x[0]) * cos(x[1]) * exp(-a * a - b * b);
+	}
+
+
+	double drop_wave_function(const std::vector<double>& x)
+	{
+		const double r2 = x[0] * x[0] + x[1] * x[1];
+		return -(1.0 + cos(12.0 * sqrt(r2))) / (0.5 * r2 + 2.0);
+	}
+
+
+	double eggholder_function(const std::vector<double>& x)
+	{
+		const double a = x[1] + 47.0;
+		return -a * sin(sqrt(fabs(a + x[0] / 2.0))) - x[0] * sin(sqrt(fabs(x[0] - a)));
+	}
+
+
+	double six_hump_camel_function(const std::vector<double>& x)
+	{
+		const double x1 = x[0] * x[0];
+		const double x2 = x[1] * x[1];
+		return (4.0 - 2.1 * x1 + x1 * x1 / 3.0) * x1 + x[0] * x[1] + (-4.0 + 4.0 * x2) * x2;
+	}
+
+
+	double three_hump_camel_function(const std::vector<double>& x)
+	{
+		const double x1 = x[0] * x[0];
+		return 2.0 * x1 - 1.05 * x1 * x1 + x1 * x1 * x1 / 6.0 + x[0] * x[1] + x[1] * x[1];
+	}
+
+
+	void benchmark_suite(std::vector<benchmark_function>& suite, const size_t dimensions)
+	{
+		const auto add = [&](const char* name, double (*function)(const std::vector<double>&),
+		                     const search_bounds& bounds, const double optimum)
+		{
+			benchmark_function entry;
+			entry.name = name;
+			entry.function = function;
+			entry.bounds = bounds;
+			entry.optimum = optimum;
+			suite.push_back(entry);
+		};
+		const auto add_batch = [&](const char* name, double (*function)(const std::vector<double>&),
+		                           void (*batch)(const candidate_batch&, std::vector<double>&),
+		                           const search_bounds& bounds, const double optimum)
+		{
+			add(name, function, bounds, optimum);
+			suite.back().batch = batch;
+		};
+		const auto cube = [&](const double min, const double max)
+		{
+			search_bounds bounds;
+			make_bounds(bounds, dimensions, min, max);
+			return bounds;
+		};
+		const auto square = [](const double min, const double max)
+		{
+			search_bounds bounds;
+			make_bounds(bounds, 2, min, max);
+			return bounds;
+		};
+
+		suite.clear();
+		add_batch("sphere", sphere_function, sphere_batch, cube(-5.12, 5.12), 0.0);
+		add_batch("ackley", ackley_function, ackley_batch, cube(-32.768, 32.768), 0.0);
+		add_batch("rastrigin", rastrigin_function, rastrigin_batch, cube(-5.12, 5.12), 0.0);
+		add_batch("rosenbrock", rosenbrock_function, rosenbrock_batch, cube(-5.0, 10.0), 0.0);
+		add_batch("griewank", griewank_function, griewank_batch, cube(-600.0, 600.0), 0.0);
+		add_batch("schwefel", schwefel_function, schwefel_batch, cube(-500.0, 500.0), 0.0);
+		add("sum_of_different_powers", sum_of_different_powers_function, cube(-1.0, 1.0), 0.0);
+		add_batch("sum_squares", sum_squares_function, sum_squares_batch, cube(-10.0, 10.0), 0.0);
+		add_batch("rotated_hyper_ellipsoid", rotated_hyper_ellipsoid_function, rotated_hyper_ellipsoid_batch,
+		          cube(-65.536, 65.536), 0.0);
+		add("dixon_price", dixon_price_function, cube(-10.0, 10.0), 0.0);
+		add("levy", levy_function, cube(-10.0, 10.0), 0.0);
+		add("beale", beale_function, square(-4.5, 4.5), 0.0);
+		add("booth", booth_function, square(-10.0, 10.0), 0.0);
+		add("branin", branin_function, {{-5.0, 10.0}, {0.0, 15.0}}, 0.397887);
+		add("bukin", bukin_function, {{-15.0, -5.0}, {-3.0, 3.0}}, 0.0);
+		add("holder_table", holder_table_function, square(-10.0, 10.0), -19.2085);
+		add("cross_in_tray", cross_in_tray_function, square(-10.0, 10.0), -2.06261);
+		add("matyas", matyas_function, square(-10.0, 10.0), 0.0);
+		add("easom", easom_function, square(-100.0, 100.0), -1.0);
+		add("drop_wave", drop_wave_function, square(-5.12, 5.12), -1.0);
+		add("eggholder", eggholder_function, square(-512.0, 512.0), -959.6407);
+		add("six_hump_camel", six_hump_camel_function, {{-3.0, 3.0}, {-2.0, 2.0}}, -1.0316);
+		add("three_hump_camel", three_hump_camel_function, square(-5.0, 5.0), 0.0);
+	}
+}
@@ -0,0 +1,168 @@
+#include "clever/thread_pool.h"
+
+#include <cstdlib>
+
+
+namespace clever
+{
+	namespace
+	{
+		thread_local bool inside_loop = false;
+	}
+
+
+	thread_pool::thread_pool(const size_t num_threads)
+		: next_(0)
+	{
+		auto n = num_threads;
+		if (n == 0)
+		{
+			n = std::thread::hardware_concurrency();
+		}
+		if (n == 0)
+		{
+			n = 1;
+		}
+		for (size_t i = 1; i < n; ++i)
+		{
+			workers_.emplace_back(&thread_pool::worker_loop, this);
+		}
+	}
+
+
+	thread_pool::~thread_pool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stop_ = true;
+		}
+		wake_.notify_all();
+		for (auto& worker : workers_)
+		{
+			worker.join();
+		}
+	}
+
+
+	size_t thread_pool::size() const
+	{
+		return workers_.size() + 1;
+	}
+
+
+	void thread_pool::parallel_for(const size_t count, const std::function<void(size_t)>& body, const size_t grain)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+		if (inside_loop || workers_.empty() || count <= grain)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				body(i);
+			}
+			return;
+		}
+
+		std::lock_guard<std::mutex> loop_lock(loop_mutex_);
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			body_ = &body;
+			count_ = count;
+			grain_ = grain == 0 ? 1 : grain;
+			next_.store(0);
+			error_ = nullptr;
+			++generation_;
+		}
+		wake_.notify_all();
+
+		run_chunks();
+
+		std::exception_ptr error;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			done_.wait(lock, [this]() { return active_ == 0; });
+			body_ = nullptr;
+			error = error_;
+		}
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+	}
+
+
+	void thread_pool::worker_loop()
+	{
+		size_t seen = 0;
+		for (;;)
+		{
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				wake_.wait(lock, [&]() { return stop_ || generation_ != seen; });
+				if (stop_)
+				{
+					return;
+				}
+				seen = generation_;
+				if (body_ == nullptr)
+				{
+					continue;
+				}
+				++active_;
+			}
+
+			run_chunks();
+
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				--active_;
+			}
+			done_.notify_all();
+		}
+	}
+
+
+	void thread_pool::run_chunks()
+	{
+		inside_loop = true;
+		for (;;)
+		{
+			const auto begin = next_.fetch_add(grain_);
+			if (begin >= count_)
+			{
+				break;
+			}
+			const auto end = begin + grain_ < count_ ? begin + grain_ : count_;
+			try
+			{
+				for (size_t i = begin; i < end; ++i)
+				{
+					(*body_)(i);
+				}
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				if (!error_)
+				{
+					error_ = std::current_exception();
+				}
+				next_.store(count_);
+			}
+		}
+		inside_loop = false;
+	}
+
+
+	thread_pool& default_pool()
+	{
+		static thread_pool pool([]()
+		{
+			const char* value = std::getenv("CLEVER_NUM_THREADS");
+			return value != nullptr ? static_cast<size_t>(std::strtoul(value, nullptr, 10)) : size_t(0);
+		}());
+		return pool;
+	}
+}
@@ -0,0 +1,264 @@
+#include "clever/tsp.h"
+#include "clever/distance.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+
+namespace clever
+{
+	const city_list& berlin52()
+	{
+		static const city_list cities = {
+			{565, 575}, {25, 185}, {345, 750}, {945, 685}, {845, 655},
+			{880, 660}, {25, 230}, {525, 1000}, {580, 1175}, {650, 1130},
+			{1605, 620}, {1220, 580}, {1465, 200}, {1530, 5}, {845, 680},
+			{725, 370}, {145, 665}, {415, 635}, {510, 875}, {560, 365},
+			{300, 465}, {520, 585}, {480, 415}, {835, 625}, {975, 580},
+			{1215, 245}, {1320, 315}, {1250, 400}, {660, 180}, {410, 250},
+			{420, 555}, {575, 665}, {1150, 1160}, {700, 580}, {685, 595},
+			{685, 610}, {770, 610}, {795, 645}, {720, 635}, {760, 650},
+			{475, 960}, {95, 260}, {875, 920}, {700, 500}, {555, 815},
+			{830, 485}, {1170, 65}, {830, 610}, {605, 625}, {595, 360},
+			{1340, 725}, {1740, 245}
+		};
+		return cities;
+	}
+
+
+	bool read_tsplib(std::istream& in, city_list& cities)
+	{
+		cities.clear();
+		size_t dimension = 0;
+		std::string line;
+		while (std::getline(in, line))
+		{
+			// keywords may be written "KEY: value" or "KEY : value"
+			const auto colon = line.find(':');
+			std::istringstream fields(colon == std::string::npos ? line : line.substr(0, colon));
+			std::string keyword;
+			fields >> keyword;
+			if (keyword == "DIMENSION" && colon != std::string::npos)
+			{
+				std::istringstream value(line.substr(colon + 1));
+				value >> dimension;
+			}
+			else if (keyword == "NODE_COORD_SECTION")
+			{
+				break;
+			}
+		}
+		if (dimension == 0 || !in)
+		{
+			return false;
+		}
+
+		cities.assign(dimension, std::vector<double>());
+		for (size_t n = 0; n < dimension && std::getline(in, line); ++n)
+		{
+			std::istringstream fields(line);
+			size_t id = 0;
+			double x = 0.0, y = 0.0;
+			if (!(fields >> id >> x >> y) || id == 0 || id > dimension)
+			{
+				cities.clear();
+				return false;
+			}
+			cities[id - 1] = {x, y};
+		}
+		for (const auto& city : cities)
+		{
+			if (city.empty())
+			{
+				cities.clear();
+				return false;
+			}
+		}
+		return true;
+	}
+
+
+	bool load_tsplib(const std::string& path, city_list& cities)
+	{
+		std::ifstream in(path);
+		return in && read_tsplib(in, cities);
+	}
+
+
+	double euc_2d(const std::vector<double>& c1, const std::vector<double>& c2)
+	{
+		double sum = 0.0;
+		for (size_t i = 0; i < c1.size(); ++i)
+		{
+			sum += (c1[i] - c2[i]) * (c1[i] - c2[i]);
+		}
+		return std::sqrt(sum);
+	}
+
+
+	double tour_cost(const std::vector<size_t>& permutation, const city_list& cities)
+	{
+		double distance = 0.0;
+		for (size_t i = 0; i < permutation.size(); ++i)
+		{
+			const auto c1 = permutation[i];
+			const auto c2 = i == permutation.size() - 1 ? permutation[0] : permutation[i + 1];
+			distance += euc_2d(cities[c1], cities[c2]);
+		}
+		return distance;
+	}
+
+
+	double tour_cost(const std::vector<size_t>& permutation, const distance_provider& distance)
+	{
+		double sum = 0.0;
+		for (size_t i = 0; i + 1 < permutation.size(); ++i)
+		{
+			sum += distance(permutation[i], permutation[i + 1]);
+		}
+		if (!permutation.empty())
+		{
+			sum += distance(permutation.back(), permutation.front());
+		}
+		return sum;
+	}
+
+
+	void random_permutation(std::vector<size_t>& permutation, const size_t size, random_engine& rng)
+	{
+		permutation.resize(size);
+		for (size_t i = 0; i < size; ++i)
+		{
+			permutation[i] = i;
+		}
+		for (size_t i = 0; i + 1 < size; ++i)
+		{
+			const auto r = i + rng.index(size - i);
+			std::swap(permutation[i], permutation[r]);
+		}
+	}
+
+
+	void stochastic_two_opt(std::vector<size_t>& permutation, size_t& c1, size_t& c2, random_engine& rng)
+	{
+		const auto move = random_two_opt_move(permutation.size(), rng);
+		c1 = move.c1;
+		c2 = move.c2;
+		std::reverse(permutation.begin() + c1, permutation.begin() + c2);
+	}
+
+
+	void stochastic_two_opt(std::vector<size_t>& permutation, random_engine& rng)
+	{
+		size_t c1, c2;
+		stochastic_two_opt(permutation, c1, c2, rng);
+	}
+
+
+	two_opt_move random_two_opt_move(const size_t size, random_engine& rng)
+	{
+		two_opt_move move;
+		move.c1 = rng.index(size);
+		move.c2 = rng.index(size);
+		if (size < 4)
+		{
+			move.c1 = 0;
+			move.c2 = 0;
+			return move;
+		}
+		const auto before = move.c1 == 0 ? size - 1 : move.c1 - 1;
+		const auto after = move.c1 == size - 1 ? 0 : move.c1 + 1;
+		while (move.c2 == move.c1 || move.c2 == before || move.c2 == after)
+		{
+			move.c2 = rng.index(size);
+		}
+		if (move.c2 < move.c1)
+		{
+			std::swap(move.c1, move.c2);
+		}
+		return move;
+	}
+
+
+	void two_opt_cities(const std::vector<size_t>& permutation, const two_opt_move& move,
+	                    size_t& a, size_t& b, size_t& c, size_t& d)
+	{
+		const auto n = permutation.size();
+		a = permutation[move.c1 == 0 ? n - 1 : move.c1 - 1];
+		b = permutation[move.c1];
+		c = permutation[move.c2 == 0 ? n - 1 : move.c2 - 1];
+		d = permutation[move.c2 == n ? 0 : move.c2];
+	}
+
+
+	double two_opt_delta(const std::vector<size_t>& permutation, const two_opt_move& move, const city_list& cities)
+	{
+		if (move.c1 == move.c2)
+		{
+			return 0.0;
+		}
+		size_t a, b, c, d;
+		two_opt_cities(permutation, move, a, b, c, d);
+		return euc_2d(cities[a], cities[c]) + euc_2d(cities[b], cities[d])
+			- euc_2d(cities[a], cities[b]) - euc_2d(cities[c], cities[d]);
+	}
+
+
+	double two_opt_delta(const std::vector<size_t>& permutation, const two_opt_move& move,
+	                     const distance_provider& distance)
+	{
+		if (move.c1 == move.c2)
+		{
+			return 0.0;
+		}
+		size_t a, b, c, d;
+		two_opt_cities(permutation, move, a, b, c, d);
+		return distance(a, c) + distance(b, d) - distance(a, b) - distance(c, d);
+	}
+
+
+	void apply_two_opt(std::vector<size_t>& permutation, const two_opt_move& move)
+	{
+		const auto n = permutation.size();
+		const auto inner = move.c2 - move.c1;
+		if (2 * inner <= n)
+		{
+			std::reverse(permutation.begin() + move.c1, permutation.begin() + move.c2);
+			return;
+		}
+		// reverse the cyclic complement [c2, c1 + n) instead
+		auto i = move.c2;
+		auto j = move.c1 + n - 1;
+		for (size_t k = 0; k < (n - inner) / 2; ++k, ++i, --j)
+		{
+			std::swap(permutation[i % n], permutation[j % n]);
+		}
+	}
+
+
+	size_t two_opt_local_search(permutation_solution& solution, const city_list& cities, const size_t max_no_improv,
+	                            random_engine& rng)
+	{
+		size_t count = 0;
+		size_t tries = 0;
+		while (count < max_no_improv)
+		{
+			++tries;
+			const auto move = random_two_opt_move(solution.vector.size(), rng);
+			const auto delta = two_opt_delta(solution.vector, move, cities);
+			if (delta < 0.0)
+			{
+				apply_two_opt(solution.vector, move);
+				solution.cost += delta;
+				count = 0;
+			}
+			else
+			{
+				count += 1;
+			}
+		}
+		return tries;
+	}
+}
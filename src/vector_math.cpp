@@ -0,0 +1,58 @@
+#include "clever/vector_math.h"
+
+#include "clever/batch_functions.h"
+#include "batch_kernels.h"
+
+
+namespace clever
+{
+	double dot(const double* a, const double* b, const size_t n)
+	{
+		switch (active_simd_level())
+		{
+#ifdef CLEVER_BATCH_X86
+		case simd_level::avx512:
+			return batch::dot_avx512(a, b, n);
+		case simd_level::avx2:
+			return batch::dot_avx2(a, b, n);
+#endif
+		default:
+			return batch::dot_scalar(a, b, n);
+		}
+	}
+
+
+	void axpy(const double alpha, const double* x, double* y, const size_t n)
+	{
+		switch (active_simd_level())
+		{
+#ifdef CLEVER_BATCH_X86
+		case simd_level::avx512:
+			batch::axpy_avx512(alpha, x, y, n);
+			break;
+		case simd_level::avx2:
+			batch::axpy_avx2(alpha, x, y, n);
+			break;
+#endif
+		default:
+			batch::axpy_scalar(alpha, x, y, n);
+			break;
+		}
+	}
+
+
+	double prefix_sums(const double* x, const size_t n, double* out)
+	{
+		switch (active_simd_level())
+		{
+#ifdef CLEVER_BATCH_X86
+		case simd_level::avx512:
+			return batch::prefix_sums_avx512(x, n, out);
+		case simd_level::avx2:
+			return batch::prefix_sums_avx2(x, n, out);
+#endif
+		default:
+			return batch::prefix_sums_scalar(x, n, out);
+		}
+	}
+}
@@ -1,8 +1,1406 @@
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "clever_algorithm.h"
+
+
+static int failures = 0;
+
+static void check(const bool condition, const char* what)
+{
+    if (!condition)
+    {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+
+static void test_random()
+{
+    clever::random_engine a(42), b(42);
+    bool same = true;
+    for (size_t i = 0; i < 100; ++i)
+    {
+        const double x = a.uniform();
+        same = same && x == b.uniform();
+        check(x >= 0.0 && x < 1.0, "uniform draw in [0, 1)");
+    }
+    check(same, "equal seeds give equal streams");
+    for (size_t i = 0; i < 100; ++i)
+    {
+        check(a.index(7) < 7, "index draw in [0, n)");
+    }
+
+    clever::random_engine s0(42, 0), s1(42, 1), s0_again(42, 0);
+    check(s0() != s1(), "streams of one seed differ");
+    s0_again();
+    check(s0() == s0_again(), "stream construction is reproducible");
+
+    auto streams = clever::make_streams(42, 2);
+    clever::random_engine jumped(42);
+    jumped.jump();
+    check(streams[1]() == jumped(), "make_streams spaces streams one jump apart");
+    check(streams[0]() != streams[1](), "jumped streams differ");
+
+    std::vector<double> draws(10001);
+    clever::random_engine g(7);
+    g.fill_gaussian(draws, 2.0, 3.0);
+    double mean = 0.0, var = 0.0;
+    for (const auto x : draws)
+    {
+        mean += x;
+    }
+    mean /= draws.size();
+    for (const auto x : draws)
+    {
+        var += (x - mean) * (x - mean);
+    }
+    var /= draws.size();
+    check(std::fabs(mean - 2.0) < 0.15 && std::fabs(var - 9.0) < 0.6, "bulk gaussian moments");
+}
+
+
+static void test_tsp()
+{
+    const auto& cities = clever::berlin52();
+    check(cities.size() == 52, "berlin52 has 52 cities");
+
+    std::vector<size_t> tour;
+    clever::random_permutation(tour, cities.size());
+    auto sorted = tour;
+    std::sort(sorted.begin(), sorted.end());
+    bool is_permutation = true;
+    for (size_t i = 0; i < sorted.size(); ++i)
+    {
+        is_permutation = is_permutation && sorted[i] == i;
+    }
+    check(is_permutation, "random_permutation is a permutation");
+
+    for (size_t i = 0; i < 100; ++i)
+    {
+        auto moved = tour;
+        size_t c1, c2;
+        clever::stochastic_two_opt(moved, c1, c2);
+        check(c1 < c2 && c2 < tour.size(), "two-opt segment is ordered");
+        std::reverse(moved.begin() + c1, moved.begin() + c2);
+        check(moved == tour, "two-opt reverses exactly [c1, c2)");
+    }
+
+    const std::vector<std::vector<double>> square = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+    check(std::fabs(clever::tour_cost({0, 1, 2, 3}, square) - 4.0) < 1e-12, "tour_cost of unit square");
+
+    bool delta_exact = true;
+    auto cost = clever::tour_cost(tour, cities);
+    for (size_t i = 0; i < 200; ++i)
+    {
+        const auto move = clever::random_two_opt_move(tour.size());
+        cost += clever::two_opt_delta(tour, move, cities);
+        clever::apply_two_opt(tour, move);
+        delta_exact = delta_exact && std::fabs(cost - clever::tour_cost(tour, cities)) < 1e-6;
+    }
+    check(delta_exact, "two-opt delta matches the recomputed tour length");
+
+    const auto before = tour;
+    const auto move = clever::random_two_opt_move(tour.size());
+    clever::apply_two_opt(tour, move);
+    clever::apply_two_opt(tour, move);
+    check(tour == before, "applying a two-opt move twice undoes it");
+
+    clever::permutation_solution solution;
+    solution.vector = tour;
+    solution.cost = clever::tour_cost(tour, cities);
+    const auto start = solution.cost;
+    clever::two_opt_local_search(solution, cities, 200);
+    check(solution.cost < start && std::fabs(solution.cost - clever::tour_cost(solution.vector, cities)) < 1e-6,
+          "two-opt local search improves and tracks the cost");
+}
+
+
+static void test_evaluator()
+{
+    clever::evaluator objective(clever::sphere_function);
+    check(objective({1.0, 2.0}) == 5.0, "sphere function value");
+    check(objective.evaluations() == 1, "evaluator counts calls");
+    check(std::fabs(clever::ackley_function({0.0, 0.0})) < 1e-12, "ackley minimum at origin");
+}
+
+
+static void test_batch_evaluation()
+{
+    clever::thread_pool pool(4);
+    clever::evaluator objective(clever::sphere_function);
+    std::vector<std::vector<double>> vectors;
+    for (size_t i = 0; i < 100; ++i)
+    {
+        vectors.push_back({static_cast<double>(i), 1.0});
+    }
+    std::vector<double> costs;
+    objective.evaluate_batch(vectors, costs, pool);
+    bool exact = costs.size() == vectors.size();
+    for (size_t i = 0; exact && i < costs.size(); ++i)
+    {
+        exact = costs[i] == static_cast<double>(i * i) + 1.0;
+    }
+    check(exact, "batch evaluation matches serial evaluation");
+    check(objective.evaluations() == 100, "batch evaluation counts every call");
+
+    // stochastic evaluation draws from a per-candidate stream, so the result
+    // must not depend on the number of threads
+    std::vector<clever::real_solution> a(50), b(50);
+    const auto noisy = [](clever::real_solution& c, clever::random_engine& rng) { c.cost = rng.gaussian(); };
+    clever::evaluate_population(a, 7, noisy, pool);
+    clever::thread_pool single(1);
+    clever::evaluate_population(b, 7, noisy, single);
+    bool same = true;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        same = same && a[i].cost == b[i].cost;
+    }
+    check(same, "seeded batch evaluation is independent of thread count");
+
+    bool thrown = false;
+    try
+    {
+        pool.parallel_for(10, [](const size_t i) { if (i == 3) throw std::runtime_error("boom"); });
+    }
+    catch (const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    check(thrown, "parallel_for rethrows exceptions");
+}
+
+
+static void test_bit_string()
+{
+    clever::bit_string bits(130);
+    check(bits.num_words() == 3 && bits.count() == 0, "bit string packs into 64-bit words");
+    bits.set(0, true);
+    bits.set(64, true);
+    bits.flip(129);
+    check(bits[0] && bits[64] && bits[129] && !bits[1], "set and flip single bits");
+    check(clever::onemax(bits) == 3.0, "onemax counts set bits");
+
+    clever::bit_string ones(130), zeros(130);
+    clever::point_mutation(ones, 1.0);
+    check(ones.count() == 130, "mutation at rate 1 flips every bit and keeps the tail clear");
+    clever::bit_string child;
+    clever::one_point_crossover(child, ones, zeros, 70);
+    check(child.count() == 70 && child[69] && !child[70], "one point crossover splits at the point");
+    clever::uniform_crossover(child, ones, ones);
+    check(child == ones, "uniform crossover of equal parents");
+
+    clever::random_engine rng(3);
+    clever::bit_string long_bits(100000);
+    clever::point_mutation(long_bits, 0.01, rng);
+    check(long_bits.count() > 850 && long_bits.count() < 1150, "geometric skip mutation flips about rate * size bits");
+    clever::sample_bit_string(long_bits, std::vector<double>(1000, 1.0), rng);
+    check(long_bits.size() == 1000 && long_bits.count() == 1000, "sampling with probability one");
+    auto cleared = bits;
+    cleared.reset();
+    check(cleared.size() == bits.size() && cleared.count() == 0, "reset clears every bit");
+    check(bits.to_string().size() == 130 && bits.to_string()[64] == '1', "bit string text form");
+}
+
+
+static void test_distance()
+{
+    const auto& cities = clever::berlin52();
+    const clever::distance_provider dense(cities, clever::distance_storage::dense);
+    const clever::distance_provider dense_float(cities, clever::distance_storage::dense_float);
+    const clever::distance_provider on_the_fly(cities, clever::distance_storage::on_the_fly);
+    check(clever::distance_provider(cities).storage() == clever::distance_storage::dense, "small instances are dense");
+
+    bool agree = true;
+    std::vector<double> row(cities.size());
+    for (size_t i = 0; i < cities.size(); ++i)
+    {
+        on_the_fly.distances_from(i, row.data());
+        for (size_t j = 0; j < cities.size(); ++j)
+        {
+            const auto d = clever::euc_2d(cities[i], cities[j]);
+            agree = agree && std::fabs(dense(i, j) - d) < 1e-9 && std::fabs(on_the_fly(i, j) - d) < 1e-9
+                && std::fabs(row[j] - d) < 1e-9 && std::fabs(dense_float(i, j) - d) < 1e-3 * (1.0 + d);
+        }
+    }
+    check(agree, "dense, float and on-the-fly distances match euc_2d");
+
+    std::vector<size_t> tour;
+    clever::random_permutation(tour, cities.size());
+    check(std::fabs(clever::tour_cost(tour, dense) - clever::tour_cost(tour, cities)) < 1e-6,
+          "tour_cost through the provider");
+
+    clever::distance_provider lists(cities);
+    lists.build_neighbor_lists(8);
+    bool nearest = lists.num_neighbors() == 8;
+    for (size_t i = 0; i < cities.size() && nearest; ++i)
+    {
+        std::vector<size_t> brute;
+        for (size_t j = 0; j < cities.size(); ++j)
+        {
+            if (j != i)
+            {
+                brute.push_back(j);
+            }
+        }
+        std::stable_sort(brute.begin(), brute.end(), [&](size_t a, size_t b) { return lists(i, a) < lists(i, b); });
+        for (size_t k = 0; k < lists.num_neighbors(); ++k)
+        {
+            nearest = nearest && std::fabs(lists(i, lists.neighbors(i)[k]) - lists(i, brute[k])) < 1e-9;
+        }
+    }
+    check(nearest, "candidate lists hold the k nearest cities in order");
+    lists.build_neighbor_lists(1000);
+    check(lists.num_neighbors() == cities.size() - 1, "candidate lists are capped at n - 1");
+}
+
+
+static void test_pheromone()
+{
+    for (const auto layout : {clever::pheromone_layout::full, clever::pheromone_layout::triangular})
+    {
+        clever::pheromone_matrix trails(13, 2.0, layout);
+        clever::pheromone_matrix_float trails_float(13, 2.0f, layout);
+        check(reinterpret_cast<uintptr_t>(&trails.row(0)[0]) % clever::cache_line_size == 0, "trails are cache aligned");
+
+        trails.evaporate(0.25);
+        trails_float.evaporate(0.25);
+        bool evaporated = true;
+        for (size_t i = 0; i < 13; ++i)
+        {
+            for (size_t j = 0; j < 13; ++j)
+            {
+                evaporated = evaporated && trails(i, j) == 1.5 && trails_float(i, j) == 1.5f;
+            }
+        }
+        check(evaporated, "evaporation scales every trail");
+
+        const std::vector<size_t> tour = {3, 0, 7};
+        trails.deposit(tour, 0.5);
+        check(trails(3, 0) == 2.0 && trails(0, 3) == 2.0 && trails(7, 3) == 2.0 && trails(3, 7) == 2.0
+              && trails(0, 7) == 2.0 && trails(1, 3) == 1.5, "deposit covers both directions of the tour edges");
+        trails.update(5, 9, 0.5, 1.0);
+        check(trails(9, 5) == 1.75 && trails(5, 9) == 1.75, "edge update blends toward the target");
+
+        clever::thread_pool pool(4);
+        pool.parallel_for(1000, [&](size_t) { trails.update_atomic(2, 11, 1.0, 0.25); });
+        check(trails.load(11, 2) == 251.5 && trails(2, 11) == 251.5, "concurrent atomic updates are not lost");
+        trails.sync_mirror();
+        check(trails(11, 2) == 251.5 && trails(7, 3) == 2.0, "mirror cells follow the canonical ones");
+    }
+}
+
+
+static void test_migration()
+{
+    clever::spsc_queue<int> queue(3);
+    check(queue.capacity() == 4, "queue capacity rounds up to a power of two");
+    int value = 0;
+    check(!queue.try_pop(value), "new queue is empty");
+    for (int i = 0; i < 4; ++i)
+    {
+        queue.try_push(i);
+    }
+    check(!queue.try_push(4), "full queue rejects a push");
+    bool in_order = true;
+    for (int i = 0; i < 4; ++i)
+    {
+        in_order = in_order && queue.try_pop(value) && value == i;
+    }
+    check(in_order && !queue.try_pop(value), "queue pops in push order");
+
+    clever::spsc_queue<int> channel(64);
+    const int count = 100000;
+    long long sum = 0;
+    bool ordered = true;
+    std::thread producer([&]()
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            while (!channel.try_push(i))
+            {
+            }
+        }
+    });
+    for (int expected = 0; expected < count;)
+    {
+        if (channel.try_pop(value))
+        {
+            ordered = ordered && value == expected;
+            sum += value;
+            ++expected;
+        }
+    }
+    producer.join();
+    check(ordered && sum == static_cast<long long>(count) * (count - 1) / 2, "queue hands over across threads");
+
+    std::vector<size_t> targets;
+    clever::migration_targets(targets, clever::migration_topology::ring, 4, 5);
+    check(targets == std::vector<size_t>{0}, "ring sends to the next island");
+    clever::migration_targets(targets, clever::migration_topology::fully_connected, 1, 4);
+    check(targets == std::vector<size_t>({0, 2, 3}), "fully connected sends to all others");
+    bool never_self = true;
+    for (size_t i = 0; i < 100; ++i)
+    {
+        clever::migration_targets(targets, clever::migration_topology::random, 2, 3);
+        never_self = never_self && targets.size() == 1 && targets[0] != 2 && targets[0] < 3;
+    }
+    check(never_self, "random topology picks another island");
+
+    clever::migration_network<int> ring(3, clever::migration_topology::ring, 2);
+    check(ring.send(0, 1, 7) && ring.send(0, 1, 8) && !ring.send(0, 1, 9), "send drops migrants on a full queue");
+    check(!ring.send(0, 2, 7), "ring has no channel against its direction");
+    std::vector<int> migrants;
+    ring.receive(1, migrants);
+    check(migrants == std::vector<int>({7, 8}), "receive drains the incoming channels");
+}
+
+
+static void test_test_functions()
+{
+    const double pi = std::acos(-1.0);
+    const struct
+    {
+        const char* name;
+        std::vector<double> minimum;
+    } minima[] = {
+        {"sphere", {0, 0, 0}}, {"ackley", {0, 0, 0}}, {"rastrigin", {0, 0, 0}}, {"rosenbrock", {1, 1, 1}},
+        {"griewank", {0, 0, 0}}, {"schwefel", {420.9687, 420.9687, 420.9687}},
+        {"sum_of_different_powers", {0, 0, 0}}, {"sum_squares", {0, 0, 0}}, {"rotated_hyper_ellipsoid", {0, 0, 0}},
+        {"dixon_price", {1, std::pow(2.0, -0.5), std::pow(2.0, -0.75)}}, {"levy", {1, 1, 1}},
+        {"beale", {3, 0.5}}, {"booth", {1, 3}}, {"branin", {pi, 2.275}}, {"bukin", {-10, 1}},
+        {"holder_table", {8.05502, 9.66459}}, {"cross_in_tray", {1.3491, 1.3491}}, {"matyas", {0, 0}},
+        {"easom", {pi, pi}}, {"drop_wave", {0, 0}}, {"eggholder", {512, 404.2319}},
+        {"six_hump_camel", {0.0898, -0.7126}}, {"three_hump_camel", {0, 0}}};
+
+    std::vector<clever::benchmark_function> suite;
+    clever::benchmark_suite(suite, 3);
+    check(suite.size() == sizeof(minima) / sizeof(minima[0]), "suite lists every test function");
+    for (const auto& entry : minima)
+    {
+        const auto it = std::find_if(suite.begin(), suite.end(),
+                                     [&](const clever::benchmark_function& f) { return f.name == entry.name; });
+        const bool found = it != suite.end();
+        const bool at_optimum = found && std::fabs(it->function(entry.minimum) - it->optimum) < 1e-3;
+        bool in_bounds = found && it->bounds.size() == entry.minimum.size();
+        for (size_t i = 0; in_bounds && i < entry.minimum.size(); ++i)
+        {
+            in_bounds = it->bounds[i][0] <= entry.minimum[i] && entry.minimum[i] <= it->bounds[i][1];
+        }
+        if (!at_optimum || !in_bounds)
+        {
+            std::cout << "  " << entry.name << ": ";
+        }
+        check(at_optimum && in_bounds, "test function reaches its optimum inside its domain");
+    }
+}
+
+
+static void test_tsplib()
+{
+    std::istringstream instance(
+        "NAME : square4\n"
+        "TYPE : TSP\n"
+        "DIMENSION : 4\n"
+        "EDGE_WEIGHT_TYPE : EUC_2D\n"
+        "NODE_COORD_SECTION\n"
+        "1 0 0\n"
+        "2 1 0\n"
+        "3 1.5e0 1\n"
+        "4 0 1\n"
+        "EOF\n");
+    clever::city_list cities;
+    check(clever::read_tsplib(instance, cities) && cities.size() == 4 && cities[2][0] == 1.5 && cities[3][1] == 1.0,
+          "TSPLIB coordinates are read");
+    std::istringstream explicit_weights("NAME: x\nDIMENSION: 3\nEDGE_WEIGHT_TYPE: EXPLICIT\nEDGE_WEIGHT_SECTION\n1 2 3\n");
+    check(!clever::read_tsplib(explicit_weights, cities) && cities.empty(), "instances without coordinates are rejected");
+    check(!clever::load_tsplib("/nonexistent/instance.tsp", cities), "missing TSPLIB file is reported");
+}
+
+
+static void test_benchmark()
+{
+    std::istringstream trace("0.5 10 9\n1.0 20 4\n1.5 30 2\n");
+    std::vector<clever::trace_point> curve;
+    clever::read_trace(trace, curve);
+    check(curve.size() == 3 && curve[1].evaluations == 20 && curve[2].best == 2.0, "trace lines are parsed");
+    check(clever::time_to_target(curve, 4.0, true) == 1.0, "time to target when minimising");
+    check(clever::time_to_target(curve, 1.0, true) < 0.0, "unreached target");
+    check(clever::time_to_target(curve, 9.0, false) == 0.5, "time to target when maximising");
+
+    clever::benchmark_run run;
+    run.algorithm = "demo";
+    run.seed = 7;
+    run.completed = true;
+    run.seconds = 2.0;
+    run.evaluations = 30;
+    run.best = 2.0;
+    run.curve = curve;
+    check(clever::evaluations_per_second(run) == 15.0, "evaluations per second");
+
+    std::ostringstream csv;
+    clever::write_csv(csv, {run});
+    check(csv.str().find("\ndemo,7,1,2,30,15,2,-1,0\n") != std::string::npos, "CSV summary row");
+    std::ostringstream curves;
+    clever::write_curves_csv(curves, {run});
+    const auto curve_rows = curves.str();
+    check(std::count(curve_rows.begin(), curve_rows.end(), '\n') == 4, "one CSV row per trace point");
+    std::ostringstream json;
+    clever::write_json(json, {run});
+    check(json.str().find("\"time_to_target\": null") != std::string::npos
+          && json.str().find("\"curve\": [[0.5, 10, 9], [1, 20, 4], [1.5, 30, 2]]") != std::string::npos,
+          "JSON run with its curve");
+    check(clever::peak_memory_kb() > 0, "peak memory is known on this platform");
+}
+
+
+static void test_batch_functions()
+{
+    clever::candidate_batch batch(13, 5);
+    check(batch.stride() % clever::candidate_batch::lanes == 0 && batch.stride() >= 13, "batch stride is padded");
+    check(reinterpret_cast<uintptr_t>(batch.dimension(1)) % clever::cache_line_size == 0, "batch rows are cache aligned");
+    std::vector<double> vector = {1, 2, 3, 4, 5};
+    batch.set(12, vector);
+    std::vector<double> copy;
+    batch.get(12, copy);
+    check(copy == vector && batch(12, 3) == 4.0 && batch.dimension(0)[batch.stride() - 1] == 0.0,
+          "candidates round-trip through the batch");
+
+    std::vector<clever::benchmark_function> suite;
+    clever::benchmark_suite(suite, 5);
+    clever::random_engine rng(11);
+    const auto supported = clever::supported_simd_level();
+    for (const auto level : {clever::simd_level::scalar, clever::simd_level::avx2, clever::simd_level::avx512})
+    {
+        if (clever::set_simd_level(level) != level)
+        {
+            continue;
+        }
+        bool agree = true;
+        for (const auto& f : suite)
+        {
+            if (!f.batch)
+            {
+                continue;
+            }
+            std::vector<std::vector<double>> vectors(13);
+            for (size_t i = 0; i < vectors.size(); ++i)
+            {
+                clever::random_vector(vectors[i], f.bounds, rng);
+                batch.set(i, vectors[i]);
+            }
+            std::vector<double> costs;
+            f.batch(batch, costs);
+            agree = agree && costs.size() == vectors.size();
+            for (size_t i = 0; agree && i < vectors.size(); ++i)
+            {
+                const auto expected = f.function(vectors[i]);
+                agree = std::fabs(costs[i] - expected) <= 1e-12 * std::max(1.0, std::fabs(expected));
+            }
+            if (!agree)
+            {
+                std::cout << "  " << f.name << " at level " << static_cast<int>(level) << ": ";
+                break;
+            }
+        }
+        check(agree, "batch functions agree with the single-vector functions");
+    }
+    check(clever::set_simd_level(clever::simd_level::avx512) == supported, "SIMD level is capped at the CPU's");
+
+    batch.set(12, vector);
+    clever::evaluator batched(clever::sphere_function, clever::sphere_batch);
+    clever::evaluator plain(clever::sphere_function);
+    std::vector<double> batched_costs, plain_costs;
+    batched.evaluate_batch(batch, batched_costs);
+    plain.evaluate_batch(batch, plain_costs);
+    check(batched.evaluations() == 13 && plain.evaluations() == 13 && batched_costs.size() == 13
+          && std::fabs(batched_costs[12] - plain_costs[12]) < 1e-12 && plain_costs[12] == 55.0,
+          "evaluator counts batch evaluations with or without a batch function");
+}
+
+
+static void test_population_sweeps()
+{
+    clever::search_bounds bounds = {{-1.0, 1.0}, {10.0, 20.0}};
+    clever::candidate_batch a(11, 2), b(3, 2), both, picked;
+    clever::random_engine rng(5);
+    clever::random_batch(a, bounds, rng);
+    bool inside = true;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        inside = inside && a(i, 0) >= -1.0 && a(i, 0) < 1.0 && a(i, 1) >= 10.0 && a(i, 1) < 20.0;
+    }
+    check(inside && a.dimension(0)[a.size()] == 0.0, "random batch fills the bounds and leaves the padding");
+
+    b(0, 0) = -5.0;
+    b(1, 1) = 50.0;
+    b(2, 0) = 0.5;
+    clever::clamp_to_bounds(b, bounds);
+    check(b(0, 0) == -1.0 && b(1, 1) == 20.0 && b(2, 0) == 0.5 && b(2, 1) == 10.0, "batch clamping");
+
+    both.concatenate(a, b);
+    check(both.size() == 14 && both(3, 1) == a(3, 1) && both(13, 0) == 0.5, "concatenation keeps the order");
+    picked.gather(both, {13, 0, 13});
+    check(picked.size() == 3 && picked(0, 0) == 0.5 && picked(1, 1) == a(0, 1) && picked(2, 1) == 10.0,
+          "gather picks candidates by index");
+    picked.copy(1, b, 0);
+    check(picked(1, 0) == -1.0 && picked(1, 1) == 10.0, "copy moves one candidate between batches");
+
+    clever::candidate_batch grown;
+    std::vector<double> row;
+    bool appended = true;
+    for (size_t i = 0; i < both.size(); ++i)
+    {
+        both.get(i, row);
+        grown.push_back(row);
+        appended = appended && grown.size() == i + 1 && grown.stride() >= grown.size();
+    }
+    for (size_t i = 0; i < both.size(); ++i)
+    {
+        appended = appended && grown(i, 0) == both(i, 0) && grown(i, 1) == both(i, 1);
+    }
+    grown.reserve(100);
+    check(appended && grown.dimensions() == 2 && grown.stride() >= 100 && grown(13, 0) == 0.5
+          && grown.dimension(1)[grown.size()] == 0.0, "appends keep the candidates and zero padding");
+
+    // spare capacity past the candidates is not evaluated, at any level
+    const auto initial = clever::active_simd_level();
+    const double origin[2] = {0.0, 0.0};
+    bool evaluated = true;
+    for (const auto level : {clever::simd_level::scalar, clever::simd_level::avx2, clever::simd_level::avx512})
+    {
+        if (clever::set_simd_level(level) != level)
+        {
+            continue;
+        }
+        std::vector<double> costs, distances;
+        clever::sphere_batch(grown, costs);
+        clever::squared_distances(grown, origin, distances);
+        evaluated = evaluated && costs.size() == grown.size() && distances.size() == grown.size();
+        for (size_t i = 0; evaluated && i < grown.size(); ++i)
+        {
+            const auto expected = grown(i, 0) * grown(i, 0) + grown(i, 1) * grown(i, 1);
+            evaluated = std::fabs(costs[i] - expected) <= 1e-12 * std::max(1.0, expected)
+                && std::fabs(distances[i] - expected) <= 1e-12 * std::max(1.0, expected);
+        }
+    }
+    clever::set_simd_level(initial);
+    check(evaluated, "grown batches evaluate their candidates only");
+
+    std::vector<size_t> order;
+    clever::order_by_cost(order, {3.0, 1.0, 2.0, 1.0});
+    check(order == std::vector<size_t>({1, 3, 2, 0}), "order by cost is stable");
+}
+
+
+static void test_swarm()
+{
+    clever::search_bounds space = {{-5.0, 5.0}, {0.0, 1.0}, {-1.0, 3.0}};
+    clever::search_bounds velocity_space = {{-1.0, 1.0}, {-1.0, 1.0}, {-1.0, 1.0}};
+    clever::random_engine rng(17);
+    clever::swarm_state start;
+    clever::create_swarm(start, 13, space, velocity_space, rng);
+    std::vector<double> g_best = {5.0, 0.5, 0.5};
+    // particle 0 is pushed out of the top of dimension 0
+    start.position(0, 0) = 4.9;
+    start.velocity(0, 0) = 3.0;
+    start.position(1, 2) = 2.5;
+    start.position(2, 2) = 2.5;
+    for (size_t i = 0; i < start.cost.size(); ++i)
+    {
+        start.cost[i] = static_cast<double>((i * 7) % 13);
+        start.b_cost[i] = 6.5;
+    }
+    check(clever::update_personal_best(start) == 0 && start.improved[1] == 0.0 && start.improved[2] == 1.0
+          && start.b_cost[1] == 6.5 && start.b_cost[2] == 1.0, "personal best update and minimum");
+
+    const clever::simd_level levels[] = {clever::simd_level::scalar, clever::simd_level::avx2, clever::simd_level::avx512};
+    const auto initial = clever::active_simd_level();
+    for (const auto level : levels)
+    {
+        if (clever::set_simd_level(level) != level)
+        {
+            continue;
+        }
+        auto swarm = start;
+        clever::random_engine draws(3);
+        clever::move_swarm(swarm, g_best, 2.0, 2.0, 2.0, draws);
+        bool same = true;
+        bool inside = true;
+        for (size_t d = 0; d < space.size(); ++d)
+        {
+            for (size_t i = 0; i < swarm.position.size(); ++i)
+            {
+                const auto k = d * swarm.position.stride() + i;
+                const auto p = start.position(i, d);
+                const auto b = start.improved[i] != 0.0 ? p : start.b_position(i, d);
+                auto v = start.velocity(i, d) + 2.0 * swarm.r1[k] * (b - p) + 2.0 * swarm.r2[k] * (g_best[d] - p);
+                v = std::max(-2.0, std::min(2.0, v));
+                auto x = p + v;
+                if (x > space[d][1])
+                {
+                    x = 2.0 * space[d][1] - x;
+                    v = -v;
+                }
+                if (x < space[d][0])
+                {
+                    x = 2.0 * space[d][0] - x;
+                    v = -v;
+                }
+                same = same && std::fabs(swarm.position(i, d) - x) < 1e-12 && std::fabs(swarm.velocity(i, d) - v) < 1e-12
+                       && swarm.b_position(i, d) == b;
+                inside = inside && swarm.position(i, d) >= space[d][0] && swarm.position(i, d) <= space[d][1];
+            }
+        }
+        check(same, "fused swarm move matches the step by step update");
+        check(inside && swarm.velocity(0, 0) < 0.0, "particles are reflected into the search space");
+    }
+    clever::set_simd_level(initial);
+
+    auto committed = start;
+    clever::commit_personal_best(committed);
+    check(committed.b_position(2, 2) == 2.5 && committed.b_position(1, 2) != 2.5
+          && committed.improved[2] == 0.0, "personal bests can be committed between moves");
+}
+
+
+static void test_evaluation_queue()
+{
+    std::atomic<size_t> running(0), most(0);
+    clever::evaluation_queue<std::pair<size_t, double>> queue([&](std::pair<size_t, double>& item)
+    {
+        const auto now = ++running;
+        size_t seen = most;
+        while (now > seen && !most.compare_exchange_weak(seen, now))
+        {
+        }
+        // uneven evaluation times: every fourth candidate is slow
+        std::this_thread::sleep_for(std::chrono::milliseconds(item.first % 4 == 0 ? 20 : 1));
+        item.second = static_cast<double>(item.first * item.first);
+        --running;
+    }, 3, 4);
+    check(queue.threads() == 3 && queue.capacity() == 4, "evaluation queue size");
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+        queue.submit({i, 0.0});
+    }
+    check(queue.in_flight() == 4, "submitted candidates are in flight");
+    std::pair<size_t, double> first;
+    queue.next(first);
+    check(first.first != 0 && first.second == static_cast<double>(first.first * first.first),
+          "results come back as they finish");
+
+    std::vector<size_t> replaced;
+    size_t next = 4;
+    const auto seen = clever::steady_state(queue, 20, [&]()
+    {
+        return std::make_pair(next++, 0.0);
+    }, [&](const std::pair<size_t, double>& item)
+    {
+        check(item.second == static_cast<double>(item.first * item.first), "steady state hands back evaluated children");
+        replaced.push_back(item.first);
+        return true;
+    });
+    std::sort(replaced.begin(), replaced.end());
+    check(seen == 23 && next == 24 && replaced.size() == 23 && replaced[0] == 0 && replaced[22] == 23
+          && std::count(replaced.begin(), replaced.end(), first.first) == 0,
+          "steady state sees every child once");
+    check(most <= 3 && queue.in_flight() == 0, "workers and in-flight candidates stay bounded");
+
+    size_t stopped = 0;
+    clever::steady_state(queue, 1000, [&]()
+    {
+        return std::make_pair(size_t(1), 0.0);
+    }, [&](const std::pair<size_t, double>&)
+    {
+        return ++stopped < 5;
+    });
+    check(stopped == 5 && queue.in_flight() == 0, "steady state stops when replace says so");
+
+    clever::evaluation_queue<int> failing([](int& value)
+    {
+        if (value == 2)
+        {
+            throw std::runtime_error("bad candidate");
+        }
+    }, 2);
+    bool thrown = false;
+    try
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            failing.submit(i);
+        }
+        int value = 0;
+        while (failing.next(value))
+        {
+        }
+    }
+    catch (const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    check(thrown, "evaluation errors reach the caller");
+}
+
+
+static void test_fitness_cache()
+{
+    clever::bit_string a(70), b(70);
+    b.set(69, true);
+    check(clever::hash_genome(a) != clever::hash_genome(b) && clever::hash_genome(a) == clever::hash_genome(clever::bit_string(70))
+          && clever::hash_genome(std::string("0101")) != clever::hash_genome(std::string("0110")),
+          "genome hashes");
+
+    // one shard of four entries, so the eviction order is predictable
+    clever::fitness_cache cache(4, 1);
+    double fitness = 0.0;
+    check(!cache.find(a, fitness) && cache.misses() == 1, "empty cache misses");
+    std::vector<clever::bit_string> genomes(6, clever::bit_string(70));
+    for (size_t i = 0; i < genomes.size(); ++i)
+    {
+        genomes[i].set(i, true);
+    }
+    for (size_t i = 0; i < 4; ++i)
+    {
+        cache.insert(genomes[i], static_cast<double>(i));
+    }
+    check(cache.find(genomes[2], fitness) && fitness == 2.0 && cache.hits() == 1, "cache hit");
+    cache.find(genomes[0], fitness);
+    // the clock passes over the referenced entries 0 and 2 and evicts 1, then 3
+    cache.insert(genomes[4], 4.0);
+    cache.insert(genomes[5], 5.0);
+    check(cache.size() == 4 && !cache.find(genomes[1], fitness) && !cache.find(genomes[3], fitness)
+          && cache.find(genomes[0], fitness) && cache.find(genomes[2], fitness)
+          && cache.find(genomes[5], fitness) && fitness == 5.0,
+          "CLOCK eviction keeps referenced entries");
+
+    size_t calls = 0;
+    const auto value = cache.get(genomes[4], [&]() { ++calls; return -1.0; });
+    check(value == 4.0 && calls == 0, "get uses the cached fitness");
+    clever::fitness_cache off(0);
+    off.get(a, [&]() { ++calls; return 0.0; });
+    off.get(a, [&]() { ++calls; return 0.0; });
+    check(calls == 2 && off.size() == 0, "a cache of capacity zero always evaluates");
+
+    clever::string_fitness_cache shared(64);
+    std::atomic<size_t> evaluations(0);
+    std::vector<double> results(400);
+    clever::thread_pool pool(4);
+    pool.parallel_for(results.size(), [&](const size_t i)
+    {
+        const std::string genome = std::to_string(i % 40);
+        results[i] = shared.get(genome, [&]()
+        {
+            ++evaluations;
+            return static_cast<double>(i % 40);
+        });
+    });
+    bool right = true;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        right = right && results[i] == static_cast<double>(i % 40);
+    }
+    check(right && shared.hits() + shared.misses() == 400 && evaluations == shared.misses() && evaluations < 400,
+          "concurrent lookups");
+    shared.clear();
+    check(shared.size() == 0 && shared.hits() == 0, "clearing the cache");
+}
+
+
+static void test_bayesian_network()
+{
+    // 2! 1! / 4! * 0! 3! / 4!
+    check(std::fabs(clever::k2_log_score({2, 1, 0, 3}) - std::log(2.0 / 24.0 * 6.0 / 24.0)) < 1e-12,
+          "K2 metric in log space");
+
+    // bit 1 copies bit 0, bit 2 is the opposite of bit 1 and bit 3 is noise,
+    // over more samples than a factorial in doubles could take
+    clever::random_engine rng(23);
+    std::vector<clever::bit_string> samples(2000, clever::bit_string(4));
+    for (auto& sample : samples)
+    {
+        const bool a = rng.uniform() < 0.5;
+        sample.set(0, a);
+        sample.set(1, a);
+        sample.set(2, !a);
+        sample.set(3, rng.uniform() < 0.5);
+    }
+    clever::bayesian_network network;
+    network.learn(samples, 10, 1);
+    check(network.size() == 4 && network.edges() == 2 && network.parents(3).empty(),
+          "structure search finds the dependencies");
+    bool bounded = true;
+    for (size_t i = 0; i < network.size(); ++i)
+    {
+        bounded = bounded && network.parents(i).size() <= 1 && std::isfinite(network.score(i));
+    }
+    check(bounded, "parent limit and finite scores");
+
+    // the cached score of a node with a parent agrees with a direct count
+    size_t child = 0;
+    while (network.parents(child).empty())
+    {
+        ++child;
+    }
+    const auto parent = network.parents(child)[0];
+    std::vector<size_t> counts(4, 0);
+    for (const auto& sample : samples)
+    {
+        counts[2 * (sample[parent] ? 1 : 0) + (sample[child] ? 1 : 0)] += 1;
+    }
+    check(std::fabs(network.score(child) - clever::k2_log_score(counts)) < 1e-6, "incremental score");
+
+    std::vector<size_t> order, position(4);
+    network.topological_order(order);
+    for (size_t k = 0; k < order.size(); ++k)
+    {
+        position[order[k]] = k;
+    }
+    bool sorted = order.size() == 4;
+    for (size_t i = 0; i < network.size(); ++i)
+    {
+        for (const auto p : network.parents(i))
+        {
+            sorted = sorted && position[p] < position[i];
+        }
+    }
+    check(sorted, "topological order");
+
+    // the child copies or negates its parent, so each configuration of
+    // its table is one-sided and gets half a sample of either value
+    check(counts[2] * counts[3] == 0 &&
+          std::fabs(network.probability(child, 1) - (counts[3] + 0.5) / (counts[2] + counts[3] + 1.0)) < 1e-12,
+          "conditional probability table");
+    // the noise bit keeps its plain frequency
+    size_t noise_ones = 0;
+    for (const auto& sample : samples)
+    {
+        noise_ones += sample[3] ? 1 : 0;
+    }
+    check(std::fabs(network.probability(3, 0) - noise_ones / static_cast<double>(samples.size())) < 1e-12,
+          "frequency of a mixed configuration");
+
+    clever::thread_pool one(1), four(4);
+    clever::bayesian_network parallel;
+    parallel.learn(samples, 10, 1, four);
+    bool same = parallel.edges() == network.edges();
+    for (size_t i = 0; i < network.size(); ++i)
+    {
+        same = same && parallel.parents(i) == network.parents(i);
+    }
+    check(same, "parallel structure search");
+
+    std::vector<clever::bit_string> drawn, again;
+    network.sample(drawn, 4000, 99, four);
+    network.sample(again, 4000, 99, one);
+    size_t agree = 0, ones = 0;
+    for (const auto& bits : drawn)
+    {
+        agree += bits[0] == bits[1] && bits[1] != bits[2] ? 1 : 0;
+        ones += bits[3] ? 1 : 0;
+    }
+    check(drawn == again, "samples do not depend on the number of threads");
+    check(agree > 3900 && ones > 1800 && ones < 2200, "samples follow the network");
+
+    network.learn(samples, 1, 2);
+    check(network.edges() == 1, "edge budget");
+}
+
+
+static void test_ternary()
+{
+    clever::ternary_condition a;
+    clever::make_condition(a, "1#0##1#01");
+    check(a.size() == 9 && clever::to_string(a) == "1#0##1#01", "condition round trip");
+    check(clever::symbol(a, 1) == '#' && clever::symbol(a, 2) == '0', "condition symbols");
+
+    clever::bit_string input(9);
+    const std::string bits = "110101101";
+    for (size_t i = 0; i < bits.size(); ++i)
+    {
+        input.set(i, bits[i] == '1');
+    }
+    check(clever::matches(a, input), "condition matches");
+    input.set(0, false);
+    check(!clever::matches(a, input), "condition rejects");
+
+    clever::ternary_condition general, specific;
+    clever::make_condition(general, "1########");
+    check(clever::subsumes(general, a) && !clever::subsumes(a, general), "subsumption");
+    clever::make_condition(specific, "0#0##1#01");
+    check(!clever::subsumes(general, specific), "subsumption needs agreement");
+    clever::set_symbol(specific, 0, '1');
+    check(specific == a, "set symbol keeps value bits zero under #");
+
+    // the index agrees with a scan over every condition, through erases
+    // and reused slots
+    const size_t length = 12;
+    const size_t count = 150;
+    clever::random_engine rng(7);
+    std::vector<clever::ternary_condition> conditions(count);
+    std::vector<char> live(count, 1);
+    clever::match_index index(length);
+    for (size_t k = 0; k < count; ++k)
+    {
+        std::string text(length, '#');
+        for (auto& ch : text)
+        {
+            const auto r = rng.uniform();
+            ch = r < 0.5 ? '#' : (r < 0.75 ? '0' : '1');
+        }
+        clever::make_condition(conditions[k], text);
+        index.insert(k, conditions[k]);
+    }
+    for (size_t k = 0; k < count; k += 3)
+    {
+        index.erase(k);
+        live[k] = 0;
+    }
+    clever::make_condition(conditions[3], std::string(length, '#'));
+    index.insert(3, conditions[3]);
+    live[3] = 1;
+
+    bool agree = index.size() == count;
+    std::vector<size_t> slots, expected;
+    clever::bit_string probe(length);
+    for (size_t t = 0; t < 200; ++t)
+    {
+        for (size_t i = 0; i < length; ++i)
+        {
+            probe.set(i, rng.uniform() < 0.5);
+        }
+        index.match(probe, slots);
+        expected.clear();
+        for (size_t k = 0; k < count; ++k)
+        {
+            if (live[k] && clever::matches(conditions[k], probe))
+            {
+                expected.push_back(k);
+            }
+        }
+        agree = agree && slots == expected;
+    }
+    check(agree, "match index agrees with a linear scan");
+}
+
+
+static void test_neural_network()
+{
+    clever::random_engine rng(11);
+    const clever::neural_network network({ 3, 5, 4, 2 }, rng);
+    check(network.inputs() == 3 && network.outputs() == 2 && network.layers() == 3, "network shape");
+
+    Eigen::MatrixXd input(3, 7), target(2, 7);
+    for (Eigen::Index j = 0; j < input.cols(); ++j)
+    {
+        for (Eigen::Index i = 0; i < input.rows(); ++i)
+        {
+            input(i, j) = rng.uniform(-1.0, 1.0);
+        }
+        for (Eigen::Index i = 0; i < target.rows(); ++i)
+        {
+            target(i, j) = rng.uniform();
+        }
+    }
+
+    // the gradient is minus half the derivative of the squared error
+    clever::network_gradient grad;
+    const auto error = network.gradient(input, target, grad);
+    Eigen::MatrixXd output;
+    network.forward(input, output);
+    check(std::fabs(error - (target - output).squaredNorm()) < 1e-12, "gradient returns the squared error");
+
+    const double h = 1e-6;
+    double worst = 0.0;
+    for (size_t l = 0; l < network.layers(); ++l)
+    {
+        for (Eigen::Index k = 0; k < network.weights(l).size(); ++k)
+        {
+            auto shifted = network;
+            shifted.weights(l).data()[k] += h;
+            shifted.forward(input, output);
+            const auto up = (target - output).squaredNorm();
+            shifted.weights(l).data()[k] -= 2 * h;
+            shifted.forward(input, output);
+            const auto down = (target - output).squaredNorm();
+            const auto numeric = -(up - down) / (4 * h);
+            worst = std::max(worst, std::fabs(numeric - grad.weights[l].data()[k]));
+        }
+        for (Eigen::Index k = 0; k < network.bias(l).size(); ++k)
+        {
+            auto shifted = network;
+            shifted.bias(l)(k) += h;
+            shifted.forward(input, output);
+            const auto up = (target - output).squaredNorm();
+            shifted.bias(l)(k) -= 2 * h;
+            shifted.forward(input, output);
+            const auto down = (target - output).squaredNorm();
+            const auto numeric = -(up - down) / (4 * h);
+            worst = std::max(worst, std::fabs(numeric - grad.biases[l](k)));
+        }
+    }
+    check(worst < 1e-6, "back-propagation matches finite differences");
+
+    // batches wider than one task train the same on any number of threads
+    Eigen::MatrixXd inputs(3, 600), targets(2, 600);
+    for (Eigen::Index j = 0; j < inputs.cols(); ++j)
+    {
+        for (Eigen::Index i = 0; i < inputs.rows(); ++i)
+        {
+            inputs(i, j) = rng.uniform(-1.0, 1.0);
+        }
+        targets(0, j) = inputs(0, j) * inputs(1, j) > 0.0 ? 1.0 : 0.0;
+        targets(1, j) = inputs(2, j) > 0.0 ? 1.0 : 0.0;
+    }
+    auto serial = network;
+    auto parallel = network;
+    clever::thread_pool single(1);
+    clever::thread_pool pool(3);
+    double first = 0.0, last = 0.0;
+    for (size_t epoch = 0; epoch < 200; ++epoch)
+    {
+        const auto e = serial.train_epoch(inputs, targets, 300, 2.0, 0.8, single);
+        parallel.train_epoch(inputs, targets, 300, 2.0, 0.8, pool);
+        first = epoch == 0 ? e : first;
+        last = e;
+    }
+    bool same = true;
+    for (size_t l = 0; l < serial.layers(); ++l)
+    {
+        same = same && serial.weights(l) == parallel.weights(l) && serial.bias(l) == parallel.bias(l);
+    }
+    check(same, "training does not depend on the number of threads");
+    check(last < 0.6 * first, "training lowers the error");
+}
+
+
+static void test_vector_math()
+{
+    clever::random_engine rng(5);
+    std::vector<double> a(67), b(67);
+    rng.fill_uniform(a.data(), a.size(), -1.0, 1.0);
+    rng.fill_uniform(b.data(), b.size(), -1.0, 1.0);
+    const auto initial = clever::active_simd_level();
+    for (const auto level : {clever::simd_level::scalar, clever::simd_level::avx2, clever::simd_level::avx512})
+    {
+        if (clever::set_simd_level(level) != level)
+        {
+            continue;
+        }
+        bool agree = true;
+        // every length up to a few registers, starting off any alignment
+        for (size_t offset = 0; offset < 3; ++offset)
+        {
+            for (size_t n = 0; n + offset <= 40; ++n)
+            {
+                double expected = 0.0;
+                for (size_t i = 0; i < n; ++i)
+                {
+                    expected += a[offset + i] * b[offset + i];
+                }
+                agree = agree && std::fabs(clever::dot(&a[offset], &b[offset], n) - expected) < 1e-12;
+
+                auto y = b;
+                clever::axpy(0.5, &a[offset], &y[offset], n);
+                for (size_t i = 0; i < y.size(); ++i)
+                {
+                    const bool inside = i >= offset && i < offset + n;
+                    agree = agree && y[i] == (inside ? b[i] + 0.5 * a[i] : b[i]);
+                }
+            }
+        }
+        check(agree, "dot and axpy agree with plain loops");
+
+        // prefix sums of every length, into another array and in place
+        bool scanned = true;
+        for (size_t n = 0; n <= 40; ++n)
+        {
+            std::vector<double> out(n + 1, 7.0);
+            auto in_place = a;
+            const auto total = clever::prefix_sums(a.data(), n, out.data());
+            clever::prefix_sums(in_place.data(), n, in_place.data());
+            double expected = 0.0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                expected += a[i];
+                scanned = scanned && std::fabs(out[i] - expected) < 1e-12 && in_place[i] == out[i];
+            }
+            scanned = scanned && out[n] == 7.0 && std::fabs(total - expected) < 1e-12 && in_place[n] == a[n];
+        }
+        check(scanned, "prefix sums agree with a plain loop");
+
+        clever::candidate_batch cells(13, 3);
+        std::vector<double> cell(3), distances;
+        for (size_t i = 0; i < cells.size(); ++i)
+        {
+            rng.fill_uniform(cell.data(), cell.size(), -1.0, 1.0);
+            cells.set(i, cell);
+        }
+        const double query[] = { 0.25, -0.5, 0.75 };
+        clever::squared_distances(cells, query, distances);
+        bool near = distances.size() == cells.size();
+        for (size_t i = 0; near && i < cells.size(); ++i)
+        {
+            double expected = 0.0;
+            for (size_t d = 0; d < 3; ++d)
+            {
+                expected += (cells(i, d) - query[d]) * (cells(i, d) - query[d]);
+            }
+            near = std::fabs(distances[i] - expected) < 1e-12;
+        }
+        check(near, "squared distances agree with a plain loop");
+    }
+    clever::set_simd_level(initial);
+}
+
+
+static void test_perceptron()
+{
+    // rows of two inputs and the side of a line they lie on
+    clever::random_engine rng(9);
+    const size_t rows = 1000;
+    std::vector<double> values(rows * 3);
+    for (size_t i = 0; i < rows; ++i)
+    {
+        values[i * 3] = rng.uniform(-1.0, 1.0);
+        values[i * 3 + 1] = rng.uniform(-1.0, 1.0);
+        values[i * 3 + 2] = values[i * 3] + 2.0 * values[i * 3 + 1] > 0.3 ? 1.0 : 0.0;
+    }
+    const clever::dataset_view data(values.data(), rows, 3);
+    check(data.row(7) == &values[21] && data(7, 2) == values[23] && data.slice(10, 5).row(0) == &values[30],
+          "dataset views read rows in place");
+
+    const std::string path = "clever_test_dataset.bin";
+    clever::mapped_dataset file;
+    check(clever::save_dataset(path, data), "dataset saved");
+    check(!file.open(path, 7), "a partial last row is rejected");
+    check(file.open(path, 3) && file.view().rows() == rows
+          && std::equal(values.begin(), values.end(), file.view().row(0)), "mapped dataset matches the saved rows");
+    file.close();
+    std::remove(path.c_str());
+    check(!file.is_open() && !file.open("/nonexistent/data.bin", 3), "missing dataset file is reported");
+
+    clever::perceptron online(2, rng);
+    for (size_t epoch = 0; epoch < 20; ++epoch)
+    {
+        online.train_epoch(data, 0.1);
+    }
+    check(online.test(data) > 0.97 * rows, "online perceptron learns a separable problem");
+
+    // mini-batches train the same on any number of threads
+    const clever::perceptron start(2, rng);
+    auto serial = start;
+    auto parallel = start;
+    clever::thread_pool single(1);
+    clever::thread_pool pool(3);
+    for (size_t epoch = 0; epoch < 30; ++epoch)
+    {
+        serial.train_epoch(data, 0.01, 600, single);
+        parallel.train_epoch(data, 0.01, 600, pool);
+    }
+    check(serial.weights() == parallel.weights(), "mini-batch training does not depend on the number of threads");
+    check(serial.test(data, pool) > 0.95 * rows, "mini-batch perceptron learns a separable problem");
+
+    std::vector<double> outputs;
+    serial.classify(data, outputs, pool);
+    size_t correct = 0;
+    for (size_t i = 0; i < rows; ++i)
+    {
+        correct += outputs[i] == data(i, 2) ? 1 : 0;
+    }
+    check(correct == serial.test(data, single), "classify agrees with test");
+
+    // one misclassified row: the average runs over the weights before
+    // and after the update
+    clever::perceptron single_step(1, rng);
+    const auto w0 = single_step.weights();
+    double row[] = { 1.0, 0.0 };
+    row[1] = single_step.output(row) == 1.0 ? 0.0 : 1.0;
+    check(single_step.train_epoch(clever::dataset_view(row, 1, 2), 1.0) == 1, "the row is misclassified once");
+    const auto w1 = single_step.weights();
+    std::vector<double> average;
+    single_step.averaged(average);
+    check(std::fabs(average[0] - (w0[0] + w1[0]) / 2.0) < 1e-12
+          && std::fabs(average[1] - (w0[1] + w1[1]) / 2.0) < 1e-12, "averaged weights");
+}
+
+
+static void test_kd_tree_radius()
+{
+    clever::random_engine rng(13);
+    const size_t count = 500, dims = 3;
+    std::vector<double> points(count * dims);
+    rng.fill_uniform(points.data(), points.size(), 0.0, 1.0);
+    const clever::kd_tree tree(points.data(), count, dims);
+    check(tree.size() == count && tree.dimensions() == dims, "k-d tree from packed rows");
+
+    bool agree = true;
+    std::vector<size_t> found;
+    double query[dims];
+    for (size_t t = 0; t < 200; ++t)
+    {
+        rng.fill_uniform(query, dims, 0.0, 1.0);
+        const double radius = rng.uniform(0.0, 0.2);
+        std::vector<size_t> expected;
+        for (size_t i = 0; i < count; ++i)
+        {
+            double sum = 0.0;
+            for (size_t d = 0; d < dims; ++d)
+            {
+                sum += (points[i * dims + d] - query[d]) * (points[i * dims + d] - query[d]);
+            }
+            if (sum < radius * radius)
+            {
+                expected.push_back(i);
+            }
+        }
+        tree.within(query, radius, found);
+        std::sort(found.begin(), found.end());
+        agree = agree && found == expected && tree.any_within(query, radius) == !expected.empty();
+        if (expected.size() == 1)
+        {
+            agree = agree && !tree.any_within(query, radius, expected[0]);
+        }
+    }
+    check(agree, "radius queries agree with a linear scan");
+    check(!tree.any_within(points.data(), 0.0), "the radius is exclusive");
+
+    // axis 256 varies most, axis 0, which a truncated axis would read,
+    // a little
+    const size_t wide = 300, rows_count = 200;
+    std::vector<double> rows(rows_count * wide, 0.5);
+    for (size_t i = 0; i < rows_count; ++i)
+    {
+        rows[i * wide] = rng.uniform(0.0, 0.1);
+        rows[i * wide + 256] = rng.uniform(0.0, 1.0);
+    }
+    const clever::kd_tree high(rows.data(), rows_count, wide);
+    std::vector<double> probe(wide, 0.5);
+    bool exact = true;
+    for (size_t t = 0; t < 100; ++t)
+    {
+        probe[0] = rng.uniform(0.0, 0.1);
+        probe[256] = rng.uniform(0.0, 1.0);
+        size_t expected = 0;
+        double closest = DBL_MAX;
+        for (size_t i = 0; i < rows_count; ++i)
+        {
+            const auto d0 = rows[i * wide] - probe[0];
+            const auto d1 = rows[i * wide + 256] - probe[256];
+            if (d0 * d0 + d1 * d1 < closest)
+            {
+                closest = d0 * d0 + d1 * d1;
+                expected = i;
+            }
+        }
+        high.nearest(probe.data(), 1, found);
+        exact = exact && found.size() == 1 && found[0] == expected;
+    }
+    check(exact, "k-d tree splits on axes past 255");
+}
+
+
+static void test_discrete_sampling()
+{
+    const std::vector<double> weights = {1.0, 0.0, 3.0, 6.0, 0.5, 2.5};
+    const double total = 13.0;
+    const size_t draws = 200000;
+    clever::random_engine rng(17);
+
+    const clever::alias_table table(weights);
+    std::vector<size_t> counts(weights.size(), 0);
+    for (size_t i = 0; i < draws; ++i)
+    {
+        counts[table.sample(rng)] += 1;
+    }
+    bool close = counts[1] == 0;
+    for (size_t i = 0; i < weights.size(); ++i)
+    {
+        close = close && std::fabs(counts[i] / static_cast<double>(draws) - weights[i] / total) < 0.01;
+    }
+    check(table.size() == weights.size() && close, "alias table draws in proportion to the weights");
+
+    clever::fenwick_tree tree(weights);
+    check(tree.prefix(3) == 4.0 && tree.total() == total, "fenwick prefix sums");
+    check(tree.find(0.0) == 0 && tree.find(1.0) == 2 && tree.find(3.99) == 2 && tree.find(4.0) == 3
+          && tree.find(12.99) == 5 && tree.find(total) == 5, "fenwick find locates the interval of a target");
+    tree.set(3, 0.0);
+    tree.add(1, 2.0);
+    check(tree.weight(1) == 2.0 && tree.total() == 9.0 && tree.find(1.5) == 1 && tree.find(3.0) == 2,
+          "fenwick point updates");
+    std::fill(counts.begin(), counts.end(), 0);
+    for (size_t i = 0; i < draws; ++i)
+    {
+        counts[tree.sample(rng)] += 1;
+    }
+    check(counts[3] == 0 && std::fabs(counts[2] / static_cast<double>(draws) - 3.0 / 9.0) < 0.01,
+          "fenwick draws follow the updated weights");
+
+    // one-shot draws from prefix sums
+    std::fill(counts.begin(), counts.end(), 0);
+    std::vector<double> once;
+    for (size_t i = 0; i < draws; ++i)
+    {
+        once = weights;
+        counts[clever::sample_once(once.data(), once.size(), rng)] += 1;
+    }
+    close = counts[1] == 0;
+    for (size_t i = 0; i < weights.size(); ++i)
+    {
+        close = close && std::fabs(counts[i] / static_cast<double>(draws) - weights[i] / total) < 0.01;
+    }
+    check(close, "one-shot draws in proportion to the weights");
+    const double ends[] = { 0.0, 2.0, 2.0, 5.0, 5.0 };
+    const double zeros[] = { 0.0, 0.0 };
+    check(clever::sample_cumulative(zeros, 2, rng) == 2 && clever::sample_once(once.data(), 0, rng) == 0
+          && clever::sample_cumulative(ends, 5, rng) % 2 == 1, "zero weights are never drawn");
+
+    std::vector<double> power;
+    clever::power_law_weights(power, 4, 2.0);
+    check(power.size() == 4 && power[0] == 1.0 && power[1] == 0.25 && power[3] == 1.0 / 16.0,
+          "power-law rank weights");
+}
 
 
 int main(int argc, char const *argv[])
 {
     std::cout << "Test Algorithm." << std::endl;
-    return 0;
+    test_random();
+    test_tsp();
+    test_evaluator();
+    test_batch_evaluation();
+    test_bit_string();
+    test_distance();
+    test_pheromone();
+    test_migration();
+    test_test_functions();
+    test_tsplib();
+    test_benchmark();
+    test_batch_functions();
+    test_population_sweeps();
+    test_swarm();
+    test_evaluation_queue();
+    test_fitness_cache();
+    test_bayesian_network();
+    test_ternary();
+    test_neural_network();
+    test_vector_math();
+    test_perceptron();
+    test_kd_tree_radius();
+    test_discrete_sampling();
+    return failures == 0 ? 0 : 1;
 }